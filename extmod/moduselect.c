@@ -36,17 +36,11 @@
 #include "py/stream.h"
 #include "py/mperrno.h"
 #include "py/mphal.h"
+#include "extmod/moduselect.h"
 
 // Flags for poll()
 #define FLAG_ONESHOT (1)
 
-typedef struct _poll_obj_t {
-    mp_obj_t obj;
-    mp_uint_t (*ioctl)(mp_obj_t obj, mp_uint_t request, uintptr_t arg, int *errcode);
-    mp_uint_t flags;
-    mp_uint_t flags_ret;
-} poll_obj_t;
-
 STATIC void poll_map_add(mp_map_t *poll_map, const mp_obj_t *obj, mp_uint_t obj_len, mp_uint_t flags, bool or_flags) {
     for (mp_uint_t i = 0; i < obj_len; i++) {
         mp_map_elem_t *elem = mp_map_lookup(poll_map, mp_obj_id(obj[i]), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
@@ -107,6 +101,17 @@ STATIC mp_uint_t poll_map_poll(mp_map_t *poll_map, size_t *rwx_num) {
     return n_ready;
 }
 
+#if MICROPY_PY_USELECT_PORT_WAIT
+// let the port block until the objects may be ready, within the time left
+STATIC void poll_map_wait(mp_map_t *poll_map, mp_uint_t start_tick, mp_uint_t timeout) {
+    if (timeout != (mp_uint_t)-1) {
+        mp_uint_t elapsed = mp_hal_ticks_ms() - start_tick;
+        timeout = elapsed < timeout ? timeout - elapsed : 0;
+    }
+    mp_uselect_port_wait(poll_map, timeout);
+}
+#endif
+
 #if MICROPY_PY_USELECT_SELECT
 // select(rlist, wlist, xlist[, timeout])
 STATIC mp_obj_t select_select(size_t n_args, const mp_obj_t *args) {
@@ -170,6 +175,9 @@ STATIC mp_obj_t select_select(size_t n_args, const mp_obj_t *args) {
             mp_map_deinit(&poll_map);
             return mp_obj_new_tuple(3, list_array);
         }
+        #if MICROPY_PY_USELECT_PORT_WAIT
+        poll_map_wait(&poll_map, start_tick, timeout);
+        #endif
         MICROPY_EVENT_POLL_HOOK
     }
 }
@@ -249,6 +257,9 @@ STATIC mp_uint_t poll_poll_internal(uint n_args, const mp_obj_t *args) {
         if (n_ready > 0 || (timeout != (mp_uint_t)-1 && mp_hal_ticks_ms() - start_tick >= timeout)) {
             break;
         }
+        #if MICROPY_PY_USELECT_PORT_WAIT
+        poll_map_wait(&self->poll_map, start_tick, timeout);
+        #endif
         MICROPY_EVENT_POLL_HOOK
     }
 
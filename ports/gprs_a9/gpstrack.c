@@ -0,0 +1,172 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "gpstrack.h"
+
+#define GPSTRACK_MARK 23  // the padding byte of a record
+#define GPSTRACK_KEEP 0x01
+
+#define EARTH_RADIUS 6371000.0
+
+// Record fields: see modgps.c
+static const uint8_t field_offset[GPSTRACK_FIELDS] = {0, 4, 8, 12, 16, 18, 20, 21, 22};
+static const uint8_t field_size[GPSTRACK_FIELDS] = {4, 4, 4, 4, 2, 2, 1, 1, 1};
+
+static int64_t gpstrack_field(const uint8_t *record, int i) {
+    const uint8_t *src = record + field_offset[i];
+    uint32_t value = 0;
+    for (int j = field_size[i] - 1; j >= 0; j--) {
+        value = (value << 8) | src[j];
+    }
+    // Coordinates and altitude are signed
+    if (i >= 1 && i <= 3)
+        return (int32_t) value;
+    return value;
+}
+
+static size_t gpstrack_varint(int64_t value, uint8_t *out) {
+    // Zigzag varint: small deltas of either sign take a single byte
+    uint64_t v = ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+    size_t n = 0;
+    do {
+        out[n] = v & 0x7F;
+        v >>= 7;
+        if (v)
+            out[n] |= 0x80;
+        n ++;
+    } while (v);
+    return n;
+}
+
+static void gpstrack_xy(const uint8_t *origin, const uint8_t *point, double *x, double *y) {
+    // Local equirectangular projection (meters)
+    double k = EARTH_RADIUS * M_PI / 180e6;
+    double lat = (double) gpstrack_field(origin, 1);
+    double dlon = (double) gpstrack_field(point, 2) - gpstrack_field(origin, 2);
+    if (dlon > 180e6)
+        dlon -= 360e6;
+    else if (dlon < -180e6)
+        dlon += 360e6;
+    *x = dlon * k * cos(lat * M_PI / 180e6);
+    *y = ((double) gpstrack_field(point, 1) - lat) * k;
+}
+
+static double gpstrack_deviation(const uint8_t *a, const uint8_t *b, const uint8_t *p) {
+    // Distance from p to the segment a-b
+    double bx, by, px, py;
+    gpstrack_xy(a, b, &bx, &by);
+    gpstrack_xy(a, p, &px, &py);
+    double length = bx * bx + by * by;
+    if (length > 0) {
+        double t = (px * bx + py * by) / length;
+        if (t > 1)
+            t = 1;
+        if (t > 0) {
+            px -= t * bx;
+            py -= t * by;
+        }
+    }
+    return sqrt(px * px + py * py);
+}
+
+static void gpstrack_simplify(uint8_t *records, size_t n, double tolerance) {
+    // Douglas-Peucker: the farthest point of each segment is kept until all
+    // points are within tolerance. Kept points split segments in place of
+    // recursion, so no stack or heap is needed
+    for (size_t i = 0; i < n; i++) {
+        records[i * GPS_RECORD_SIZE + GPSTRACK_MARK] = 0;
+    }
+    records[GPSTRACK_MARK] = GPSTRACK_KEEP;
+    records[(n - 1) * GPS_RECORD_SIZE + GPSTRACK_MARK] = GPSTRACK_KEEP;
+
+    size_t i = 0;
+    while (i + 1 < n) {
+        const uint8_t *a = records + i * GPS_RECORD_SIZE;
+        size_t j = i + 1;
+        while (!(records[j * GPS_RECORD_SIZE + GPSTRACK_MARK] & GPSTRACK_KEEP))
+            j ++;
+
+        size_t farthest = 0;
+        double deviation = tolerance;
+        for (size_t k = i + 1; k < j; k++) {
+            double d = gpstrack_deviation(a, records + j * GPS_RECORD_SIZE, records + k * GPS_RECORD_SIZE);
+            if (d > deviation) {
+                deviation = d;
+                farthest = k;
+            }
+        }
+
+        if (farthest)
+            records[farthest * GPS_RECORD_SIZE + GPSTRACK_MARK] = GPSTRACK_KEEP;
+        else
+            i = j;
+    }
+}
+
+size_t gpstrack_encode(uint8_t *records, size_t n, double tolerance, uint8_t *out, size_t out_len) {
+    bool simplify = tolerance > 0 && n > 2;
+    if (simplify)
+        gpstrack_simplify(records, n, tolerance);
+
+    if (out_len < 1)
+        return 0;
+    size_t pos = 0;
+    out[pos++] = GPSTRACK_VERSION;
+
+    int64_t previous[GPSTRACK_FIELDS] = {0};
+    for (size_t r = 0; r < n; r++) {
+        uint8_t *record = records + r * GPS_RECORD_SIZE;
+        if (simplify) {
+            uint8_t keep = record[GPSTRACK_MARK] & GPSTRACK_KEEP;
+            record[GPSTRACK_MARK] = 0;
+            if (!keep)
+                continue;
+        }
+
+        uint8_t encoded[GPSTRACK_MAX_ENCODED];
+        int64_t value = gpstrack_field(record, 0);
+        size_t len = gpstrack_varint(value - previous[0], encoded);
+        previous[0] = value;
+
+        uint8_t *mask = &encoded[len++];
+        *mask = 0;
+        for (int i = 1; i < GPSTRACK_FIELDS; i++) {
+            value = gpstrack_field(record, i);
+            if (value != previous[i]) {
+                *mask |= 1 << (i - 1);
+                len += gpstrack_varint(value - previous[i], encoded + len);
+                previous[i] = value;
+            }
+        }
+
+        if (pos + len > out_len)
+            return 0;
+        memcpy(out + pos, encoded, len);
+        pos += len;
+    }
+    return pos;
+}
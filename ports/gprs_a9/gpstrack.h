@@ -0,0 +1,50 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MICROPY_INCLUDED_GPRS_A9_GPSTRACK_H
+#define MICROPY_INCLUDED_GPRS_A9_GPSTRACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Track chunks: a version byte followed by records. Each record is the
+// zigzag varint time delta, a mask byte with a bit per remaining field
+// (latitude, longitude, altitude, speed, course, hdop, satellites, flags)
+// and zigzag varint deltas of the fields marked in the mask. The first
+// record of a chunk is a delta from zeros.
+
+#define GPS_RECORD_SIZE 24  // see modgps.c
+
+#define GPSTRACK_VERSION 1
+#define GPSTRACK_FIELDS 9
+#define GPSTRACK_MAX_ENCODED (1 + GPSTRACK_FIELDS * 5)
+
+// Packs n records of GPS_RECORD_SIZE bytes; returns the number of bytes
+// written or 0 if out is too small. A positive tolerance (meters) drops
+// points closer than that to the simplified path; the padding bytes of
+// records are used for marking points in this case.
+size_t gpstrack_encode(uint8_t *records, size_t n, double tolerance, uint8_t *out, size_t out_len);
+
+#endif // MICROPY_INCLUDED_GPRS_A9_GPSTRACK_H
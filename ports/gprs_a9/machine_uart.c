@@ -45,6 +45,8 @@ STATIC const char *_parity_name[] = {"None", "1", "0"};
 // ----
 STATIC mp_obj_t pyb_uart_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args);
 
+STATIC volatile uint8_t frame_drain_scheduled[UART_NPORTS];
+
 void modmachine_uart_init0(void) {
     UART_Close(UART2);
     UART_Close(UART1);
@@ -52,6 +54,13 @@ void modmachine_uart_init0(void) {
     uart_attached_to_dupterm[0] = 0;
     uart_attached_to_dupterm[1] = 0;
 
+    for (int i = 0; i < UART_NPORTS; i++) {
+        uart_frame_setup(i, UART_FRAME_NONE, 0, 0, 0);
+        MP_STATE_PORT(uart_frame_callback)[i] = mp_const_none;
+        MP_STATE_PORT(uart_frame_owner)[i] = mp_const_none;
+        frame_drain_scheduled[i] = 0;
+    }
+
     // Attach UART to dupterm(1)
     mp_obj_t args[2];
     args[0] = MP_OBJ_NEW_SMALL_INT(0);
@@ -76,9 +85,6 @@ STATIC void pyb_uart_print(const mp_print_t *print, mp_obj_t self_in, mp_print_k
         self->stop, uart_get_rxbuf_len(self->uart_id) - 1, self->timeout, self->timeout_char);
 }
 
-static uint8_t* uart_rxbuf[2];
-
-
 STATIC void pyb_uart_init_helper(pyb_uart_obj_t *self, size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     // ========================================
     // Prepares UART.
@@ -204,10 +210,10 @@ STATIC void pyb_uart_init_helper(pyb_uart_obj_t *self, size_t n_args, const mp_o
         uint8_t *buf;
         if (len <= UART_STATIC_RXBUF_LEN) {
             buf = uart_ringbuf_array[self->uart_id];
-            uart_rxbuf[self->uart_id] = NULL; // clear any old pointer
+            MP_STATE_PORT(uart_rxbuf)[self->uart_id] = NULL; // clear any old pointer
         } else {
             buf = m_new(uint8_t, len);
-            uart_rxbuf[self->uart_id] = buf; // retain root pointer
+            MP_STATE_PORT(uart_rxbuf)[self->uart_id] = buf; // retain root pointer
         }
         uart_set_rxbuf(self->uart_id, buf, len);
     }
@@ -296,20 +302,182 @@ STATIC mp_obj_t pyb_uart_any(mp_obj_t self_in) {
     //     True if any data available.
     // ========================================
     pyb_uart_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uart_frame_t *frame = uart_frame + self->uart_id;
+    if (frame->mode != UART_FRAME_NONE) {
+        return MP_OBJ_NEW_SMALL_INT((uint16_t)(frame->put - frame->get));
+    }
     return MP_OBJ_NEW_SMALL_INT(uart_rx_any(self->uart_id));
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(pyb_uart_any_obj, pyb_uart_any);
 
+// -------
+// Framing
+// -------
+
+STATIC mp_obj_t pyb_uart_frame_drain(mp_obj_t uart_in) {
+    // Calls the frame callback once per new frame; runs in the MicroPython task
+    uint8_t uart = mp_obj_get_int(uart_in);
+    uart_frame_t *frame = uart_frame + uart;
+    frame_drain_scheduled[uart] = 0;
+    while (frame->signalled != frame->put) {
+        frame->signalled++;
+        mp_obj_t callback = MP_STATE_PORT(uart_frame_callback)[uart];
+        if (callback != MP_OBJ_NULL && callback != mp_const_none)
+            mp_call_function_1_protected(callback, MP_STATE_PORT(uart_frame_owner)[uart]);
+    }
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(pyb_uart_frame_drain_obj, pyb_uart_frame_drain);
+
+void uart_frame_event(uint8_t uart) {
+    // Schedules the frame callback; called from the rx path
+    mp_obj_t callback = MP_STATE_PORT(uart_frame_callback)[uart];
+    if (callback == MP_OBJ_NULL || callback == mp_const_none)
+        return;
+    if (!frame_drain_scheduled[uart]) {
+        frame_drain_scheduled[uart] = 1;
+        if (!mp_sched_schedule(MP_OBJ_FROM_PTR(&pyb_uart_frame_drain_obj), MP_OBJ_NEW_SMALL_INT(uart)))
+            frame_drain_scheduled[uart] = 0;
+    }
+}
+
+STATIC mp_obj_t pyb_uart_framing(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    // ========================================
+    // Assembles received data into frames in
+    // the rx handler. Reads then return one
+    // frame each.
+    // Args:
+    //     mode (int): one of FRAME_*;
+    //     delimiter (int): the byte ending a
+    //     frame (FRAME_DELIMITER);
+    //     gap (int): silence in ms ending a frame
+    //     (FRAME_IDLE) or dropping an incomplete
+    //     one (other modes);
+    //     prefix (int): size of the big-endian
+    //     length prefix, 1 or 2 (FRAME_LENGTH);
+    //     callback (Callable): called with the
+    //     UART for each complete frame;
+    // ========================================
+    enum { ARG_mode, ARG_delimiter, ARG_gap, ARG_prefix, ARG_callback };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_mode, MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = UART_FRAME_NONE} },
+        { MP_QSTR_delimiter, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = '\n'} },
+        { MP_QSTR_gap, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_prefix, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 1} },
+        { MP_QSTR_callback, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+    pyb_uart_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+
+    mp_int_t mode = args[ARG_mode].u_int;
+    if (mode < UART_FRAME_NONE || mode > UART_FRAME_LENGTH)
+        mp_raise_ValueError("invalid framing mode");
+    if (args[ARG_delimiter].u_int < 0 || args[ARG_delimiter].u_int > 0xFF)
+        mp_raise_ValueError("delimiter should be a byte");
+    if (args[ARG_gap].u_int < 0 || (mode == UART_FRAME_IDLE && args[ARG_gap].u_int == 0))
+        mp_raise_ValueError("a positive gap is required");
+    if (args[ARG_prefix].u_int < 1 || args[ARG_prefix].u_int > 2)
+        mp_raise_ValueError("prefix should be 1 or 2 bytes");
+    if (mode != UART_FRAME_NONE && uart_attached_to_dupterm[self->uart_id])
+        mp_raise_ValueError("UART is attached to REPL");
+    mp_obj_t callback = args[ARG_callback].u_obj;
+    if (callback != mp_const_none && !mp_obj_is_callable(callback))
+        mp_raise_ValueError("callback should be callable");
+
+    MP_STATE_PORT(uart_frame_callback)[self->uart_id] = mp_const_none;
+    uart_frame_setup(self->uart_id, mode, args[ARG_delimiter].u_int, args[ARG_prefix].u_int, args[ARG_gap].u_int);
+    MP_STATE_PORT(uart_frame_owner)[self->uart_id] = MP_OBJ_FROM_PTR(self);
+    MP_STATE_PORT(uart_frame_callback)[self->uart_id] = callback;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(pyb_uart_framing_obj, 1, pyb_uart_framing);
+
+STATIC mp_obj_t pyb_uart_frame_take(pyb_uart_obj_t *self, uint8_t *buf, mp_int_t len) {
+    // Reads one frame into buf, or into new bytes if buf is NULL; len < 0
+    // takes a frame of any length. A frame longer than len stays queued.
+    // Returns the frame length (bytes) or None on timeout.
+    if (!uart_rx_wait(self->uart_id, self->timeout * 1000))
+        return mp_const_none;
+    int size = uart_frame_size(self->uart_id);
+    if (size < 0)
+        return mp_const_none;
+    if (len >= 0 && size > len)
+        mp_raise_OSError(MP_ENOBUFS);
+    if (buf != NULL)
+        return MP_OBJ_NEW_SMALL_INT(uart_frame_read(self->uart_id, buf, size));
+    vstr_t vstr;
+    vstr_init_len(&vstr, size);
+    uart_frame_read(self->uart_id, (uint8_t*)vstr.buf, size);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+
+STATIC mp_obj_t pyb_uart_readframe(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Reads a single frame.
+    // Args:
+    //     buf (bytearray): optional buffer to
+    //     read into; a longer frame is left
+    //     queued and OSError(ENOBUFS) raised;
+    // Returns:
+    //     The frame length (the frame as bytes
+    //     if no buf is given) or None if no
+    //     frame arrived within the timeout.
+    // ========================================
+    pyb_uart_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (uart_frame[self->uart_id].mode == UART_FRAME_NONE)
+        mp_raise_ValueError("framing is off");
+    if (n_args == 1)
+        return pyb_uart_frame_take(self, NULL, -1);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+    return pyb_uart_frame_take(self, bufinfo.buf, bufinfo.len);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(pyb_uart_readframe_obj, 1, 2, pyb_uart_readframe);
+
+// In a framed mode read() and readinto() take a single frame instead of
+// filling the size asked for from several frames
+
+STATIC mp_obj_t pyb_uart_read_method(size_t n_args, const mp_obj_t *args) {
+    pyb_uart_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (uart_frame[self->uart_id].mode == UART_FRAME_NONE)
+        return mp_stream_read_obj.fun.var(n_args, args);
+    mp_int_t size = n_args > 1 ? mp_obj_get_int(args[1]) : -1;
+    return pyb_uart_frame_take(self, NULL, size);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(pyb_uart_read_method_obj, 1, 2, pyb_uart_read_method);
+
+STATIC mp_obj_t pyb_uart_readinto_method(size_t n_args, const mp_obj_t *args) {
+    pyb_uart_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (uart_frame[self->uart_id].mode == UART_FRAME_NONE)
+        return mp_stream_readinto_obj.fun.var(n_args, args);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+    mp_int_t len = bufinfo.len;
+    if (n_args > 2 && mp_obj_get_int_truncated(args[2]) < len)
+        len = mp_obj_get_int_truncated(args[2]);
+    return pyb_uart_frame_take(self, bufinfo.buf, len);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(pyb_uart_readinto_method_obj, 2, 3, pyb_uart_readinto_method);
+
 STATIC const mp_rom_map_elem_t pyb_uart_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_init), MP_ROM_PTR(&pyb_uart_init_obj) },
 
     { MP_ROM_QSTR(MP_QSTR_any), MP_ROM_PTR(&pyb_uart_any_obj) },
-    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&mp_stream_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_framing), MP_ROM_PTR(&pyb_uart_framing_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readframe), MP_ROM_PTR(&pyb_uart_readframe_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&pyb_uart_read_method_obj) },
     { MP_ROM_QSTR(MP_QSTR_readline), MP_ROM_PTR(&mp_stream_unbuffered_readline_obj) },
-    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&mp_stream_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&pyb_uart_readinto_method_obj) },
     { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
     { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&mp_stream_close_obj) },
     { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&mp_stream_close_obj) },
+
+    { MP_ROM_QSTR(MP_QSTR_FRAME_NONE), MP_ROM_INT(UART_FRAME_NONE) },
+    { MP_ROM_QSTR(MP_QSTR_FRAME_DELIMITER), MP_ROM_INT(UART_FRAME_DELIMITER) },
+    { MP_ROM_QSTR(MP_QSTR_FRAME_IDLE), MP_ROM_INT(UART_FRAME_IDLE) },
+    { MP_ROM_QSTR(MP_QSTR_FRAME_LENGTH), MP_ROM_INT(UART_FRAME_LENGTH) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(pyb_uart_locals_dict, pyb_uart_locals_dict_table);
@@ -331,11 +499,27 @@ STATIC mp_uint_t pyb_uart_read(mp_obj_t self_in, void *buf_in, mp_uint_t size, i
         return MP_STREAM_ERROR;
     }
 
-    // read the data
+    // framed: one whole frame per call; one that does not fit stays queued
+    if (uart_frame[self->uart_id].mode != UART_FRAME_NONE) {
+        int n = uart_frame_read(self->uart_id, buf_in, size);
+        if (n < 0) {
+            *errcode = MP_EAGAIN;
+            return MP_STREAM_ERROR;
+        }
+        if ((mp_uint_t)n > size) {
+            *errcode = MP_ENOBUFS;
+            return MP_STREAM_ERROR;
+        }
+        return n;
+    }
+
+    // read the data: copy out whatever is buffered at once
     uint8_t *buf = buf_in;
     for (;;) {
-        *buf++ = uart_rx_char(self->uart_id);
-        if (--size == 0 || !uart_rx_wait(self->uart_id, self->timeout_char * 1000)) {
+        size_t n = uart_rx_read(self->uart_id, buf, size);
+        buf += n;
+        size -= n;
+        if (size == 0 || !uart_rx_wait(self->uart_id, self->timeout_char * 1000)) {
             // return number of bytes read
             return buf - (uint8_t*)buf_in;
         }
@@ -410,4 +594,6 @@ MP_DEFINE_CONST_OBJ_TYPE(
 
 MP_REGISTER_ROOT_POINTER(const char * readline_hist[8]);
 MP_REGISTER_ROOT_POINTER(uint8_t* uart_rxbuf[2]);
+MP_REGISTER_ROOT_POINTER(mp_obj_t uart_frame_callback[2]);
+MP_REGISTER_ROOT_POINTER(mp_obj_t uart_frame_owner[2]);
 
@@ -39,6 +39,7 @@
 #include "py/mpstate.h"
 #include "py/mphal.h"
 #include "shared/runtime/pyexec.h"
+#include "extmod/misc.h"
 
 #include "stdbool.h"
 #include "api_os.h"
@@ -46,7 +47,6 @@
 #include "api_debug.h"
 #include "api_hal_pm.h"
 #include "api_hal_uart.h"
-#include "buffer.h"
 #include "api_network.h"
 #include "time.h"
 #include "api_fs.h"
@@ -56,6 +56,7 @@
 #include "mphalport.h"
 #include "mpconfigport.h"
 #include "modcellular.h"
+#include "moduhttp.h"
 #include "modgps.h"
 #include "modmachine.h"
 
@@ -63,31 +64,90 @@
 #define AppMain_TASK_PRIORITY      0
 #define MICROPYTHON_TASK_STACK_SIZE     (2048 * 4)
 #define MICROPYTHON_TASK_PRIORITY       1
-#define UART_CIRCLE_FIFO_BUFFER_MAX_LENGTH 2048
 
-#define MICROPYTHON_HEAP_MAX_SIZE (1024 * 2048)
-#define MICROPYTHON_HEAP_MIN_SIZE (2048)
+#define MICROPYTHON_HEAP_MAX_SIZE (1024 * 2048)   // total over all blocks
+#define MICROPYTHON_HEAP_MIN_SIZE (2048)          // the first block
+#define MICROPYTHON_HEAP_INIT_SIZE (1024 * 512)   // gathered at startup
+#define MICROPYTHON_HEAP_SPLIT_MIN (1024 * 16)    // smallest extra block
+#define MICROPYTHON_HEAP_GROW_SIZE (1024 * 64)    // grow on demand by this much
+#define MICROPYTHON_HEAP_BLOCKS (16)
 
-STATIC void* heap;
+// The heap is split over OS blocks: fragmented memory still ends up in the
+// heap and the heap can grow when a collection does not free enough
+STATIC void* heap_blocks[MICROPYTHON_HEAP_BLOCKS];
+STATIC size_t heap_blocks_n = 0;
+STATIC size_t heap_size = 0;
 
 HANDLE mainTaskHandle  = NULL;
 HANDLE microPyTaskHandle = NULL;
-Buffer_t fifoBuffer; // ringbuf
-uint8_t  fifoBufferData[UART_CIRCLE_FIFO_BUFFER_MAX_LENGTH];
+
+#if MICROPY_REPL_EVENT_DRIVEN
+// The MicroPython task sleeps in OS_WaitEvent between these events. Events
+// are static and at most one of each kind is queued at a time, so they can
+// be posted from rx callbacks and the scheduler without allocation.
 
 typedef enum
 {
-    MICROPY_EVENT_ID_UART_RECEIVED = 1, //param1: length, param2:data(uint8_t*)
-    MICROPY_EVENT_ID_UART_MAX
+    MICROPY_EVENT_ID_UART_RECEIVED = 1, // REPL input available
+    MICROPY_EVENT_ID_SCHEDULED,         // a callback was scheduled
+    MICROPY_EVENT_ID_MAX
 } MicroPy_Event_ID_t;
 
 typedef struct
 {
     MicroPy_Event_ID_t id;
-    uint32_t param1;
-    uint8_t* pParam1;
 } MicroPy_Event_t;
 
+STATIC MicroPy_Event_t micropy_events[MICROPY_EVENT_ID_MAX];
+STATIC volatile uint8_t micropy_events_queued[MICROPY_EVENT_ID_MAX];
+
+STATIC void micropy_notify(MicroPy_Event_ID_t id) {
+    // Wakes up the MicroPython task
+    if (!microPyTaskHandle || micropy_events_queued[id])
+        return;
+    micropy_events_queued[id] = 1;
+    micropy_events[id].id = id;
+    if (!OS_SendEvent(microPyTaskHandle, (void*) &micropy_events[id], OS_TIME_OUT_NO_WAIT, 0))
+        micropy_events_queued[id] = 0;
+}
+
+void mp_hal_wake_stdin(void) {
+    micropy_notify(MICROPY_EVENT_ID_UART_RECEIVED);
+}
+
+// Set by MICROPY_SCHED_HOOK_SCHEDULED
+volatile uint8_t mp_hal_wake_pending = 0;
+
+void mp_hal_wake_scheduled(void) {
+    // Outside of atomic sections only: OS_SendEvent may switch tasks
+    mp_hal_wake_pending = 0;
+    micropy_notify(MICROPY_EVENT_ID_SCHEDULED);
+}
+
+STATIC int micropy_repl_input(void) {
+    // Feeds pending input to the REPL; returns non-zero on soft reset
+    for (;;) {
+        int c = mp_uos_dupterm_rx_chr();
+        if (c == -2)
+            continue;  // Ctrl-C: the interrupt is scheduled, input goes on
+        if (c < 0)
+            return 0;
+        if (pyexec_event_repl_process_char(c) & PYEXEC_FORCED_EXIT)
+            return 1;
+    }
+}
+
+STATIC void micropy_run_scheduled(void) {
+    // Runs callbacks scheduled so far; callbacks scheduled meanwhile post
+    // a new event and run on the next pass so that input is not starved
+    for (int i = 0; i < MICROPY_SCHEDULER_DEPTH && MP_STATE_VM(sched_state) == MP_SCHED_PENDING; i++)
+        mp_handle_pending(false);
+}
+
+// shared/ is not scanned for root pointers (see readline_hist in machine_uart.c)
+MP_REGISTER_ROOT_POINTER(vstr_t *repl_line);
+#endif
+
 extern mp_uint_t gc_helper_get_regs_and_sp(mp_uint_t*);
 
 #if MICROPY_ENABLE_COMPILER
@@ -109,9 +169,12 @@ extern mp_uint_t gc_helper_get_regs_and_sp(mp_uint_t*);
 #endif
 
 
+#if !MICROPY_GPRS_A9_SIM
+// The CSDK toolchain links against it as a function
 void __builtin_unreachable (void) {
 
 }
+#endif
 
 STATIC void *stack_top;
 
@@ -129,21 +192,50 @@ void NORETURN nlr_jump_fail(void *val) {
 }
 
 #if MICROPY_ENABLE_GC
-void* mp_allocate_heap(uint32_t* size) {
-    uint32_t h_size = MICROPYTHON_HEAP_MAX_SIZE;
-    void* ptr = NULL;
-    while (!ptr) {
-        if (h_size < MICROPYTHON_HEAP_MIN_SIZE) {
-            mp_fatal_error(MP_FATAL_REASON_HEAP_INIT, NULL);
-        }
-        ptr = OS_Malloc(h_size);
-        if (!ptr) {
-            h_size = h_size >> 1;
+STATIC size_t mp_heap_add(size_t size, size_t min_size) {
+    // Hands the largest OS block of at most size (halving down to min_size)
+    // over to the GC; returns its size or 0
+    if (heap_blocks_n == MICROPYTHON_HEAP_BLOCKS)
+        return 0;
+    if (size > MICROPYTHON_HEAP_MAX_SIZE - heap_size)
+        size = MICROPYTHON_HEAP_MAX_SIZE - heap_size;
+    for (; size >= min_size; size >>= 1) {
+        void* ptr = OS_Malloc(size);
+        if (ptr) {
+            if (heap_blocks_n)
+                gc_add(ptr, ptr + size);
+            else
+                gc_init(ptr, ptr + size);
+            heap_blocks[heap_blocks_n++] = ptr;
+            heap_size += size;
+            return size;
         }
     }
-    size[0] = h_size;
-    return ptr;
+    return 0;
+}
+
+void mp_allocate_heap(void) {
+    // The largest block available, then smaller ones up to the initial size
+    if (!mp_heap_add(MICROPYTHON_HEAP_MAX_SIZE, MICROPYTHON_HEAP_MIN_SIZE))
+        mp_fatal_error(MP_FATAL_REASON_HEAP_INIT, NULL);
+    while (heap_size < MICROPYTHON_HEAP_INIT_SIZE && mp_heap_add(MICROPYTHON_HEAP_INIT_SIZE - heap_size, MICROPYTHON_HEAP_SPLIT_MIN));
+}
+
+void mp_free_heap(void) {
+    for (size_t i = 0; i < heap_blocks_n; i++)
+        OS_Free(heap_blocks[i]);
+    heap_blocks_n = 0;
+    heap_size = 0;
 }
+
+#if MICROPY_GC_SPLIT_HEAP_AUTO
+bool gc_try_add_heap(size_t failed_alloc) {
+    // Called when a collection did not free enough: the area also holds the
+    // allocation tables and the area header
+    size_t needed = failed_alloc + MAX(2048, failed_alloc * 13 / 512);
+    return mp_heap_add(MAX(needed, MICROPYTHON_HEAP_GROW_SIZE), needed) != 0;
+}
+#endif
 #endif
 
 /*
@@ -164,8 +256,6 @@ void MicroPyTask(void *pData) {
 
     OS_Task_Info_t info;
     OS_GetTaskInfo(microPyTaskHandle, &info);
-    MicroPy_Event_t* event;
-    Buffer_Init(&fifoBuffer, fifoBufferData, sizeof(fifoBufferData));
 
 soft_reset:
     mp_stack_ctrl_init();
@@ -173,17 +263,17 @@ soft_reset:
     mp_stack_set_top((void *) stack_top);
     mp_stack_set_limit(MICROPYTHON_TASK_STACK_SIZE * 4 - 1024);
 #if MICROPY_ENABLE_GC
-    uint32_t heap_size;
-    heap = mp_allocate_heap(&heap_size);
-    gc_init(heap, heap + heap_size);
+    mp_allocate_heap();
 #endif
     mp_init();
     moduos_init0();
     modcellular_init0();
+    moduhttp_init0();
     modgps_init0();
     modmachine_init0();
     mp_obj_list_init(mp_sys_path, 0);
     mp_obj_list_append(mp_sys_path, MP_OBJ_NEW_QSTR(MP_QSTR_)); // current dir (or base dir of the script)
+    mp_obj_list_append(mp_sys_path, MP_OBJ_NEW_QSTR(MP_QSTR__dot_frozen)); // frozen modules (gpstrack, uasyncio, etc.)
     mp_obj_list_append(mp_sys_path, MP_OBJ_NEW_QSTR(MP_QSTR__slash_lib));
     mp_obj_list_append(mp_sys_path, MP_OBJ_NEW_QSTR(MP_QSTR__slash_));
     mp_obj_list_init(mp_sys_argv, 0);
@@ -193,30 +283,24 @@ soft_reset:
     if (pyexec_mode_kind == PYEXEC_MODE_FRIENDLY_REPL) {
         pyexec_file_if_exists("main.py");
     }
-    // pyexec_event_repl_init();
-    
-    // while (1) if (OS_WaitEvent(microPyTaskHandle, (void**)&event, OS_TIME_OUT_WAIT_FOREVER)) {
-    while (1) {
-
-        /* switch(event->id) {
-            case MICROPY_EVENT_ID_UART_RECEIVED: {
-                uint8_t c;
-                Trace(1, "micropy task received data length: %d", event->param1);
-                while (Buffer_Gets(&fifoBuffer, &c, 1))
-                    if (pyexec_event_repl_process_char((int)c)) {
-                        reset = 1;
-                        break;
-                    }
-                Trace(1, "REPL complete");
-                break;
-            }
-            default:
-                break;
-        }
-
-        OS_Free(event->pParam1);
-        OS_Free(event);*/
 
+#if MICROPY_REPL_EVENT_DRIVEN
+    // REPL input, scheduled callbacks (cellular, GPS, UART frames, etc.)
+    // and soft resets are all handled here; the task sleeps otherwise
+    pyexec_event_repl_init();
+    micropy_run_scheduled();
+    for (;;) {
+        MicroPy_Event_t* event;
+        if (!OS_WaitEvent(microPyTaskHandle, (void**)&event, OS_TIME_OUT_WAIT_FOREVER))
+            continue;
+        micropy_events_queued[event->id] = 0;
+        // dupterm streams other than UART are polled on any event
+        if (micropy_repl_input())
+            break;
+        micropy_run_scheduled();
+    }
+#else
+    while (1) {
         if (pyexec_mode_kind == PYEXEC_MODE_RAW_REPL) {
             if (pyexec_raw_repl() != 0) {
                 break;
@@ -227,14 +311,18 @@ soft_reset:
             }
         }
     }
+#endif
 
+    // dupterm streams live on the heap: print while they are still there
+    mp_hal_stdout_tx_str("PYB: soft reboot\r\n");
+    mp_hal_delay_us(10000); // allow UART to flush output
 #if MICROPY_ENABLE_GC
     gc_sweep_all();
 #endif
     mp_deinit();
-    OS_Free(heap);
-    mp_hal_stdout_tx_str("PYB: soft reboot\r\n");
-    mp_hal_delay_us(10000); // allow UART to flush output
+#if MICROPY_ENABLE_GC
+    mp_free_heap();
+#endif
 
     goto soft_reset;
 }
@@ -376,39 +464,7 @@ void EventDispatch(API_Event_t* pEvent)
 
         // UART
         // ====
-        case API_EVENT_ID_UART_RECEIVED:
-            /*Trace(1,"UART%d received:%d,%s",pEvent->param1,pEvent->param2,pEvent->pParam1);
-            if(pEvent->param1 == UART1)
-            {
-                MicroPy_Event_t* event = (MicroPy_Event_t*)OS_Malloc(sizeof(MicroPy_Event_t));
-                if(!event)
-                {
-                    Trace(1,"malloc fail");
-                    break;
-                }
-                for(uint16_t i=0; i<pEvent->param2; ++i)
-                {
-                   if (pEvent->pParam1[i] == mp_interrupt_char) {
-                        // inline version of mp_keyboard_interrupt();
-                        MP_STATE_VM(mp_pending_exception) = MP_OBJ_FROM_PTR(&MP_STATE_VM(mp_kbd_exception));
-                        #if MICROPY_ENABLE_SCHEDULER
-                        if (MP_STATE_VM(sched_state) == MP_SCHED_IDLE) {
-                            MP_STATE_VM(sched_state) = MP_SCHED_PENDING;
-                        }
-                        #endif
-                   }
-                   else
-                   {
-                       Buffer_Puts(&fifoBuffer,pEvent->pParam1+i,1);
-                       len++;
-                   }
-                }
-                memset((void*)event,0,sizeof(MicroPy_Event_t));
-                event->id = MICROPY_EVENT_ID_UART_RECEIVED;
-                event->param1 = len;
-                OS_SendEvent(microPyTaskHandle, (void*) event, OS_TIME_OUT_WAIT_FOREVER, 0);
-            }*/
-            break;
+        // UART data arrives through rx callbacks, see uart.c
 
         // GPS
         // ===
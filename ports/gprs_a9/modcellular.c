@@ -27,6 +27,7 @@
  */
 
 #include "modcellular.h"
+#include "modusocket.h"
 #include "mphalport.h"
 #include "timeout.h"
 
@@ -36,6 +37,8 @@
 #include "py/binary.h"
 #include "py/objexcept.h"
 #include "py/objarray.h"
+#include "py/stream.h"
+#include "py/mphal.h"
 
 #include "api_info.h"
 #include "api_sim.h"
@@ -94,20 +97,40 @@ uint8_t network_status = 0;
 uint16_t network_exception = NTW_NO_EXC;
 uint8_t network_signal_quality = 0;
 uint8_t network_signal_rx_level = 0;
+
+// Signal history: written by the SDK task while signal_seq is odd
+typedef struct _signal_sample_t {
+    uint32_t stamp;
+    uint8_t quality;
+    uint8_t rx_level;
+} signal_sample_t;
+
+signal_sample_t signal_history[MICROPY_PY_CELLULAR_SIGNAL_HISTORY];
+volatile uint32_t signal_history_n = 0;
+volatile uint32_t signal_seq = 0;
 mp_obj_t network_status_callback = mp_const_none;
 
 // SMS send flag
 uint8_t sms_send_flag = 0;
 uint8_t ussd_send_flag = 0;
-mp_obj_t ussd_response = mp_const_none;
+
+// Messages are exchanged as PDUs: requested by the user and the actual
+// modem format which may differ while a message is being sent
+uint8_t sms_pdu_mode = 0;
+volatile uint8_t sms_format_pdu = 0;
+uint8_t sms_concat_ref = 0;
 
 // -------------------
 // Vars: SMS retrieval
 // -------------------
 
-// A buffer used for listing messages
-mp_obj_list_t *sms_list_buffer = NULL;
+// Messages listed into MP_STATE_PORT(cellular_sms_list) so far
 uint8_t sms_list_buffer_count = 0;
+// Records reported by the modem, including the ones dropped on the way
+volatile uint8_t sms_list_seen = 0;
+// An SMS iterator is consuming records
+uint8_t sms_iter_active = 0;
+uint8_t sms_iter_generation = 0;
 
 // SMS received
 mp_obj_t sms_callback = mp_const_none;
@@ -127,20 +150,756 @@ Network_Operator_Info_t *network_list_buffer = NULL;
 // Vars: base stations
 // -------------------
 
+// The last cell info snapshot: written by the SDK task while cells_seq is
+// odd, readers retry if cells_seq changes under them
 Network_Location_t cells[MAX_CELLS];
 int8_t cells_n = 0;
+volatile uint32_t cells_seq = 0;
+volatile uint32_t cells_stamp = 0;
+volatile uint8_t cells_pending = 0;
+// The on_stations_change callback is MP_STATE_PORT(cellular_cells_callback)
+MP_REGISTER_ROOT_POINTER(mp_obj_t cellular_cells_callback);
 
 // -----------
 // Vars: Calls
 // -----------
 
-// SMS parsing
-STATIC mp_obj_t modcellular_sms_from_record(SMS_Message_Info_t* record);
-STATIC mp_obj_t modcellular_sms_from_raw(uint8_t* header, uint32_t header_length, uint8_t* content, uint32_t content_length);
-
 // Incoming call
 mp_obj_t call_callback = mp_const_none;
 
+// ---------------------
+// Vars: GPRS supervisor
+// ---------------------
+
+#define SUPERVISOR_OFF 0
+#define SUPERVISOR_ATTACHING 1
+#define SUPERVISOR_ACTIVATING 2
+#define SUPERVISOR_UP 3
+#define SUPERVISOR_BACKOFF 4
+
+#define SUPERVISOR_BACKOFF_MIN 1000
+#define SUPERVISOR_BACKOFF_MAX 300000
+
+// The supervisor state is changed by the SDK task only, except for
+// switching it on and off
+typedef struct _gprs_supervisor_t {
+    volatile uint8_t state;
+    uint32_t backoff_min;
+    uint32_t backoff_max;
+    uint32_t backoff;
+    uint32_t since;
+    uint32_t up_total;
+    uint32_t down_since;
+    uint32_t outages;
+    uint32_t outage_total;
+    uint32_t attempts;
+} gprs_supervisor_t;
+
+STATIC Network_PDP_Context_t gprs_context;
+STATIC gprs_supervisor_t supervisor;
+
+// Link up/down: the on_gprs callback is MP_STATE_PORT(cellular_gprs_callback)
+MP_REGISTER_ROOT_POINTER(mp_obj_t cellular_gprs_callback);
+
+// ------
+// Events
+// ------
+
+// Notify handlers below run in the SDK event task and must not touch the
+// MicroPython heap. Each event is copied into a fixed ring of plain structs
+// instead; a single drain function scheduled on the MicroPython task turns
+// queued events into objects and calls the callbacks. The ring has exactly
+// one producer and one consumer and needs no locks.
+
+#define EVENT_STATUS 1
+#define EVENT_SMS_SENT 2
+#define EVENT_SMS 3
+#define EVENT_SMS_RECORD 4
+#define EVENT_CALL_INCOMING 5
+#define EVENT_CALL_HANGUP 6
+#define EVENT_USSD 7
+#define EVENT_CELLS 8
+#define EVENT_GPRS 9
+
+#define EVENT_NUMBER_LEN 24
+#define EVENT_TEXT_LEN 212
+#define EVENT_SCHEDULE_RETRY 10  // ms
+
+#define SMS_RECORD_QUEUE 8
+#define SMS_RECORD_WAIT 2000        // ms the SDK task waits for an idle consumer
+#define SMS_RECORD_WAIT_SLICE 10    // ms between event polls of the consumer
+
+#if MICROPY_PY_CELLULAR_EVENT_QUEUE & (MICROPY_PY_CELLULAR_EVENT_QUEUE - 1)
+#error "MICROPY_PY_CELLULAR_EVENT_QUEUE must be a power of two"
+#endif
+
+// Keeps the compiler from moving slot accesses across index updates
+#define EVENT_BARRIER() __asm__ volatile ("" ::: "memory")
+
+typedef struct _modcellular_event_t {
+    uint8_t kind;
+    uint8_t pn_type;
+    uint8_t status;
+    uint8_t number_len;
+    int32_t value;
+    uint8_t text_len;
+    uint8_t coding;     // SMS_CODING_*
+    uint8_t part;       // concatenated messages: part number,
+    uint8_t parts;      // the number of parts (0 if not concatenated)
+    uint16_t ref;       // and the reference number
+    char number[EVENT_NUMBER_LEN];
+    char text[EVENT_TEXT_LEN];
+} modcellular_event_t;
+
+STATIC modcellular_event_t event_queue[MICROPY_PY_CELLULAR_EVENT_QUEUE];
+STATIC volatile uint32_t event_head = 0;  // written by the SDK task only
+STATIC volatile uint32_t event_tail = 0;  // written by the MicroPython task only
+STATIC volatile uint32_t event_dropped = 0;  // written by the SDK task only
+STATIC volatile uint32_t event_peak = 0;
+STATIC volatile uint8_t event_drain_scheduled = 0;
+STATIC uint32_t event_delivered = 0;
+STATIC uint32_t event_dropped_reported = 0;
+
+// The last USSD response: filled before ussd_send_flag is raised
+STATIC modcellular_event_t ussd_response;
+
+// Records listed by the modem have a ring of their own: they are taken by
+// sms.list() and SMS iterators polling in the MicroPython task and never
+// hold back the callbacks. A full ring holds the SDK task back while the
+// consumer keeps taking records; each side sleeps on a semaphore raised by
+// the other one.
+STATIC modcellular_event_t sms_record_queue[SMS_RECORD_QUEUE];
+STATIC volatile uint32_t sms_record_head = 0;  // written by the SDK task only
+STATIC volatile uint32_t sms_record_tail = 0;  // written by the MicroPython task only
+STATIC volatile uint32_t sms_record_touched = 0;  // the last time the consumer looked
+STATIC volatile uint8_t sms_record_room_waiting = 0;
+STATIC volatile uint8_t sms_record_ready_waiting = 0;
+STATIC HANDLE sms_record_room_sem = NULL;
+STATIC HANDLE sms_record_ready_sem = NULL;
+
+STATIC void modcellular_sms_record_room_wake(void) {
+    // Wakes the SDK task waiting for a free slot or for a consumer that is
+    // gone
+    if (sms_record_room_waiting) {
+        sms_record_room_waiting = 0;
+        OS_ReleaseSemaphore(sms_record_room_sem);
+    }
+}
+
+STATIC mp_obj_t modcellular_sms_new(const modcellular_event_t *event, mp_obj_t message);
+STATIC mp_obj_t modcellular_sms_from_event(const modcellular_event_t *event);
+STATIC mp_obj_t modcellular_sms_reassemble(const modcellular_event_t *event);
+
+STATIC mp_obj_t modcellular_ussd_from_event(const modcellular_event_t *event) {
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int(event->value),
+        mp_obj_new_str(event->text, event->text_len),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+
+STATIC void modcellular_event_release(void) {
+    // Frees the oldest slot; runs in the MicroPython task
+    EVENT_BARRIER();
+    event_tail ++;
+    event_delivered ++;
+}
+
+STATIC void modcellular_events_drain(void) {
+    // Delivers all queued events; runs in the MicroPython task from the
+    // scheduler only
+    event_drain_scheduled = 0;
+    while (event_tail != event_head) {
+        // The slot is released before anything is allocated: objects are
+        // made from a copy
+        EVENT_BARRIER();
+        modcellular_event_t copy = event_queue[event_tail % MICROPY_PY_CELLULAR_EVENT_QUEUE];
+        modcellular_event_t *event = &copy;
+        modcellular_event_release();
+
+        mp_obj_t callback = mp_const_none;
+        mp_obj_t arg = mp_const_none;
+
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) != 0) {
+            // Out of memory: the event is lost, the others are delivered
+            mp_obj_print_exception(&mp_plat_print, MP_OBJ_FROM_PTR(nlr.ret_val));
+            continue;
+        }
+        switch (event->kind) {
+            case EVENT_STATUS:
+                callback = network_status_callback;
+                arg = mp_obj_new_int(event->value);
+                break;
+            case EVENT_SMS_SENT:
+                callback = sms_callback;
+                arg = mp_obj_new_int(SMS_SENT);
+                break;
+            case EVENT_SMS:
+                // Parts of concatenated messages are delivered together
+                if (event->parts > 1) {
+                    arg = modcellular_sms_reassemble(event);
+                    if (arg != MP_OBJ_NULL)
+                        callback = sms_callback;
+                } else {
+                    callback = sms_callback;
+                    arg = modcellular_sms_from_event(event);
+                }
+                break;
+            case EVENT_CALL_INCOMING:
+                callback = call_callback;
+                arg = mp_obj_new_str(event->number, event->number_len);
+                break;
+            case EVENT_CALL_HANGUP:
+                callback = call_callback;
+                arg = mp_obj_new_bool(event->value);
+                break;
+            case EVENT_USSD:
+                callback = ussd_callback;
+                arg = modcellular_ussd_from_event(event);
+                break;
+            case EVENT_GPRS:
+                callback = MP_STATE_PORT(cellular_gprs_callback);
+                arg = mp_obj_new_bool(event->value);
+                break;
+            case EVENT_CELLS:
+                callback = MP_STATE_PORT(cellular_cells_callback);
+                arg = mp_obj_new_bytes((uint8_t*) event->text, event->text_len);
+                break;
+        }
+        nlr_pop();
+
+        if (callback && callback != mp_const_none)
+            mp_call_function_1_protected(callback, arg);
+    }
+}
+
+STATIC mp_obj_t modcellular_events_drain_cb(mp_obj_t arg) {
+    modcellular_events_drain();
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modcellular_events_drain_obj, modcellular_events_drain_cb);
+
+extern HANDLE mainTaskHandle;
+
+STATIC void modcellular_events_schedule(void);
+
+STATIC void modcellular_events_schedule_timer(void *param) {
+    modcellular_events_schedule();
+}
+
+STATIC void modcellular_events_schedule(void) {
+    // One scheduler entry serves any number of queued events; SDK task
+    // only. A full scheduler queue is retried from a timer: no other event
+    // may come to do it
+    if (event_drain_scheduled || event_tail == event_head)
+        return;
+    event_drain_scheduled = 1;
+    if (!mp_sched_schedule(MP_OBJ_FROM_PTR(&modcellular_events_drain_obj), mp_const_none)) {
+        event_drain_scheduled = 0;
+        OS_StopCallbackTimer(mainTaskHandle, modcellular_events_schedule_timer, NULL);
+        OS_StartCallbackTimer(mainTaskHandle, EVENT_SCHEDULE_RETRY, modcellular_events_schedule_timer, NULL);
+    }
+}
+
+STATIC modcellular_event_t *modcellular_event_clear(modcellular_event_t *event, uint8_t kind) {
+    event->kind = kind;
+    event->pn_type = 0;
+    event->status = 0;
+    event->number_len = 0;
+    event->value = 0;
+    event->text_len = 0;
+    event->coding = 0;
+    event->parts = 0;
+    return event;
+}
+
+STATIC modcellular_event_t *modcellular_event_reserve(uint8_t kind) {
+    // Returns the next free slot or NULL if the queue is full; SDK task only
+    if (event_head - event_tail >= MICROPY_PY_CELLULAR_EVENT_QUEUE) {
+        event_dropped ++;
+        return NULL;
+    }
+    return modcellular_event_clear(&event_queue[event_head % MICROPY_PY_CELLULAR_EVENT_QUEUE], kind);
+}
+
+STATIC void modcellular_event_commit(void) {
+    // Publishes the slot returned by modcellular_event_reserve
+    EVENT_BARRIER();
+    event_head ++;
+
+    uint32_t pending = event_head - event_tail;
+    if (pending > event_peak)
+        event_peak = pending;
+
+    modcellular_events_schedule();
+}
+
+STATIC void modcellular_event_set_number(modcellular_event_t *event, const char *number, size_t len) {
+    if (len > EVENT_NUMBER_LEN)
+        len = EVENT_NUMBER_LEN;
+    memcpy(event->number, number, len);
+    event->number_len = len;
+}
+
+STATIC void modcellular_event_set_text(modcellular_event_t *event, const uint8_t *text, size_t len) {
+    // Long texts are cut at a UTF-8 character boundary
+    if (len > EVENT_TEXT_LEN) {
+        len = EVENT_TEXT_LEN;
+        while (len && (text[len] & 0xC0) == 0x80)
+            len --;
+    }
+    memcpy(event->text, text, len);
+    event->text_len = len;
+}
+
+// ---
+// PDU
+// ---
+
+// Binary and concatenated messages are exchanged as PDUs (3GPP TS 23.040).
+// Incoming PDUs are decoded into plain events by the SDK task; parts of
+// concatenated messages are put together in the MicroPython task.
+
+#define SMS_CODING_TEXT 0   // decoded by the modem (text mode)
+#define SMS_CODING_GSM7 1   // one septet per byte
+#define SMS_CODING_8BIT 2
+#define SMS_CODING_UCS2 3
+
+#define PDU_MAX_LEN 176
+#define PDU_DATA_LEN 140
+#define PDU_PART_LEN 134    // data in a part of a concatenated message
+#define SMS_PDU_NUMBER_LEN 20
+#define SMS_PARTS_MAX 8       // parts of a received message
+#define SMS_PENDING_MAX 8     // incomplete messages kept
+#define SMS_PARTS_TIMEOUT 1800000
+#define SMS_PARTS_STAMP_MASK 0x3FFFFFFF
+
+// GSM 03.38 default alphabet
+STATIC const uint16_t gsm7_table[128] = {
+    '@', 0xA3, '$', 0xA5, 0xE8, 0xE9, 0xF9, 0xEC, 0xF2, 0xC7, '\n', 0xD8, 0xF8, '\r', 0xC5, 0xE5,
+    0x394, '_', 0x3A6, 0x393, 0x39B, 0x3A9, 0x3A0, 0x3A8, 0x3A3, 0x398, 0x39E, 0xA0, 0xC6, 0xE6, 0xDF, 0xC9,
+    ' ', '!', '"', '#', 0xA4, '%', '&', '\'', '(', ')', '*', '+', ',', '-', '.', '/',
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', ':', ';', '<', '=', '>', '?',
+    0xA1, 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O',
+    'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 0xC4, 0xD6, 0xD1, 0xDC, 0xA7,
+    0xBF, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o',
+    'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', 0xE4, 0xF6, 0xF1, 0xFC, 0xE0,
+};
+
+STATIC unichar modcellular_gsm7_extension(uint8_t c) {
+    // A character following the escape septet
+    switch (c) {
+        case 0x0A: return 0x0C;
+        case 0x14: return '^';
+        case 0x28: return '{';
+        case 0x29: return '}';
+        case 0x2F: return '\\';
+        case 0x3C: return '[';
+        case 0x3D: return '~';
+        case 0x3E: return ']';
+        case 0x40: return '|';
+        case 0x65: return 0x20AC;
+    }
+    return gsm7_table[c & 0x7F];
+}
+
+STATIC uint8_t modcellular_septet(const uint8_t *data, size_t bit) {
+    // Extracts a packed septet starting at the given bit
+    uint16_t word = data[bit / 8];
+    if (bit % 8 > 1)
+        word |= data[bit / 8 + 1] << 8;
+    return (word >> (bit % 8)) & 0x7F;
+}
+
+STATIC int modcellular_hex_decode(const uint8_t *src, size_t len, uint8_t *dest, size_t max) {
+    // Returns the number of octets decoded or -1 if src is not hex
+    while (len && unichar_isspace(src[len - 1]))
+        len --;
+    if (len % 2 || len / 2 > max)
+        return -1;
+    for (size_t i = 0; i < len; i++) {
+        if (!unichar_isxdigit(src[i]))
+            return -1;
+        uint8_t nibble = unichar_xdigit_value(src[i]);
+        dest[i / 2] = i % 2 ? dest[i / 2] | nibble : nibble << 4;
+    }
+    return len / 2;
+}
+
+STATIC bool modcellular_pdu_deliver(const uint8_t *pdu, size_t len, modcellular_event_t *event) {
+    // Decodes SMS-DELIVER into the event; false if malformed. Runs in
+    // the SDK task
+    if (len == 0)
+        return false;
+    size_t pos = 1 + pdu[0];  // service center address
+    if (pos + 3 > len)
+        return false;
+    uint8_t first = pdu[pos++];
+    if (first & 0x03)
+        return false;  // not SMS-DELIVER
+
+    // Originator
+    uint8_t digits = pdu[pos++];
+    uint8_t type = pdu[pos++];
+    size_t octets = (digits + 1) / 2;
+    if (pos + octets + 10 > len)
+        return false;
+    size_t n = 0;
+    if ((type & 0x70) == 0x50) {
+        // Alphanumeric, packed
+        for (size_t i = 0; i < digits * 4 / 7 && n < EVENT_NUMBER_LEN; i++) {
+            uint8_t c = modcellular_septet(pdu + pos, i * 7);
+            event->number[n++] = gsm7_table[c] < 0x80 ? gsm7_table[c] : '?';
+        }
+    } else {
+        if ((type & 0x70) == 0x10)
+            event->number[n++] = '+';
+        for (size_t i = 0; i < digits && n < EVENT_NUMBER_LEN; i++) {
+            event->number[n++] = "0123456789*#abc?"[(pdu[pos + i / 2] >> (4 * (i % 2))) & 0x0F];
+        }
+    }
+    event->number_len = n;
+    event->pn_type = type;
+    pos += octets + 1;  // and protocol identifier
+
+    uint8_t dcs = pdu[pos++];
+    pos += 7;  // time stamp
+    uint8_t udl = pdu[pos++];
+    const uint8_t *ud = pdu + pos;
+    size_t ud_len = len - pos;
+
+    event->coding = SMS_CODING_GSM7;
+    if ((dcs & 0x80) == 0x00) {
+        if ((dcs & 0x0C) == 0x04)
+            event->coding = SMS_CODING_8BIT;
+        else if ((dcs & 0x0C) == 0x08)
+            event->coding = SMS_CODING_UCS2;
+    } else if ((dcs & 0xF0) == 0xF0) {
+        if (dcs & 0x04)
+            event->coding = SMS_CODING_8BIT;
+    } else if ((dcs & 0xF0) == 0xE0) {
+        event->coding = SMS_CODING_UCS2;
+    }
+
+    // User data header: only concatenation is of interest
+    size_t header = 0;
+    if (first & 0x40) {
+        if (ud_len < 1 || (size_t) ud[0] + 1 > ud_len)
+            return false;
+        header = ud[0] + 1;
+        for (size_t i = 1; i + 2 <= header && i + 2 + ud[i + 1] <= header; i += 2 + ud[i + 1]) {
+            if (ud[i] == 0x00 && ud[i + 1] == 3) {
+                event->ref = ud[i + 2];
+                event->parts = ud[i + 3];
+                event->part = ud[i + 4];
+            } else if (ud[i] == 0x08 && ud[i + 1] == 4) {
+                event->ref = (ud[i + 2] << 8) | ud[i + 3];
+                event->parts = ud[i + 4];
+                event->part = ud[i + 5];
+            }
+        }
+    }
+
+    size_t count;
+    if (event->coding == SMS_CODING_GSM7) {
+        // Septets, the header is padded to a septet boundary
+        size_t skip = (header * 8 + 6) / 7;
+        if (udl < skip || ((size_t) udl * 7 + 7) / 8 > ud_len)
+            return false;
+        count = MIN(udl - skip, EVENT_TEXT_LEN);
+        for (size_t i = 0; i < count; i++) {
+            event->text[i] = modcellular_septet(ud, (skip + i) * 7);
+        }
+    } else {
+        if (udl > ud_len || udl < header)
+            return false;
+        count = MIN(udl - header, EVENT_TEXT_LEN);
+        memcpy(event->text, ud + header, count);
+    }
+    event->text_len = count;
+    return true;
+}
+
+STATIC size_t modcellular_pdu_submit(const char *number, const uint8_t *data, size_t len, uint8_t ref, uint8_t parts, uint8_t part, char *hex) {
+    // Encodes SMS-SUBMIT with 8-bit data into hex; returns its length
+    uint8_t pdu[PDU_MAX_LEN];
+    size_t pos = 0;
+    pdu[pos++] = 0x00;  // default service center
+    pdu[pos++] = parts > 1 ? 0x51 : 0x11;  // relative validity, header
+    pdu[pos++] = 0x00;  // reference assigned by the modem
+
+    uint8_t type = 0x81;
+    if (*number == '+') {
+        number ++;
+        type = 0x91;
+    }
+    size_t digits = strlen(number);
+    pdu[pos++] = digits;
+    pdu[pos++] = type;
+    for (size_t i = 0; i < digits; i += 2) {
+        pdu[pos++] = (number[i] - '0') | ((i + 1 < digits ? number[i + 1] - '0' : 0x0F) << 4);
+    }
+
+    pdu[pos++] = 0x00;  // protocol identifier
+    pdu[pos++] = 0x04;  // 8-bit data
+    pdu[pos++] = 0xA7;  // validity: 24 hours, same as in text mode
+    if (parts > 1) {
+        pdu[pos++] = len + 6;
+        pdu[pos++] = 5;
+        pdu[pos++] = 0x00;
+        pdu[pos++] = 3;
+        pdu[pos++] = ref;
+        pdu[pos++] = parts;
+        pdu[pos++] = part;
+    } else {
+        pdu[pos++] = len;
+    }
+    memcpy(pdu + pos, data, len);
+    pos += len;
+
+    for (size_t i = 0; i < pos; i++) {
+        hex[2 * i] = "0123456789ABCDEF"[pdu[i] >> 4];
+        hex[2 * i + 1] = "0123456789ABCDEF"[pdu[i] & 0x0F];
+    }
+    hex[2 * pos] = 0;
+    return 2 * pos;
+}
+
+STATIC mp_obj_t modcellular_sms_payload(uint8_t coding, const uint8_t *data, size_t len) {
+    // Converts message contents into str, or bytes for binary messages
+    vstr_t vstr;
+    switch (coding) {
+        case SMS_CODING_8BIT:
+            return mp_obj_new_bytes(data, len);
+
+        case SMS_CODING_GSM7:
+            vstr_init(&vstr, len);
+            for (size_t i = 0; i < len; i++) {
+                if (data[i] == 0x1B && i + 1 < len)
+                    vstr_add_char(&vstr, modcellular_gsm7_extension(data[++i]));
+                else
+                    vstr_add_char(&vstr, gsm7_table[data[i] & 0x7F]);
+            }
+            return mp_obj_new_str_from_vstr(&vstr);
+
+        case SMS_CODING_UCS2:
+            vstr_init(&vstr, len);
+            for (size_t i = 0; i + 1 < len; i += 2) {
+                unichar c = (data[i] << 8) | data[i + 1];
+                if (c >= 0xD800 && c < 0xDC00 && i + 3 < len) {
+                    unichar low = (data[i + 2] << 8) | data[i + 3];
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                        i += 2;
+                    }
+                }
+                vstr_add_char(&vstr, c);
+            }
+            return mp_obj_new_str_from_vstr(&vstr);
+    }
+    return mp_obj_new_str((const char*) data, len);
+}
+
+STATIC mp_obj_t modcellular_sms_reassemble(const modcellular_event_t *event) {
+    // Keeps a part of a concatenated message; returns the complete SMS or
+    // MP_OBJ_NULL if other parts are missing
+    if (event->parts > SMS_PARTS_MAX || event->part == 0 || event->part > event->parts) {
+        network_exception = NTW_EXC_SMS_DROP;
+        return MP_OBJ_NULL;
+    }
+    if (MP_STATE_PORT(cellular_sms_parts) == MP_OBJ_NULL)
+        MP_STATE_PORT(cellular_sms_parts) = mp_obj_new_dict(0);
+    mp_map_t *map = mp_obj_dict_get_map(MP_STATE_PORT(cellular_sms_parts));
+
+    // Pending messages: [stamp, coding, part1, part2, ...]
+    uint32_t now = mp_hal_ticks_ms() & SMS_PARTS_STAMP_MASK;
+    mp_obj_t oldest = MP_OBJ_NULL;
+    uint32_t oldest_age = 0;
+    for (size_t i = 0; i < map->alloc; i++) {
+        if (!mp_map_slot_is_filled(map, i))
+            continue;
+        mp_obj_list_t *pending = MP_OBJ_TO_PTR(map->table[i].value);
+        uint32_t age = (now - MP_OBJ_SMALL_INT_VALUE(pending->items[0])) & SMS_PARTS_STAMP_MASK;
+        if (age > SMS_PARTS_TIMEOUT) {
+            mp_map_lookup(map, map->table[i].key, MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+        } else if (age >= oldest_age) {
+            oldest = map->table[i].key;
+            oldest_age = age;
+        }
+    }
+
+    char key_c[EVENT_NUMBER_LEN + 8];
+    int key_len = snprintf(key_c, sizeof(key_c), "%.*s:%u", event->number_len, event->number, event->ref);
+    mp_obj_t key = mp_obj_new_str(key_c, key_len);
+
+    mp_map_elem_t *elem = mp_map_lookup(map, key, MP_MAP_LOOKUP);
+    mp_obj_list_t *pending;
+    if (elem == NULL) {
+        if (map->used >= SMS_PENDING_MAX)
+            mp_map_lookup(map, oldest, MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+        pending = MP_OBJ_TO_PTR(mp_obj_new_list(event->parts + 2, NULL));
+        pending->items[0] = MP_OBJ_NEW_SMALL_INT(now);
+        pending->items[1] = MP_OBJ_NEW_SMALL_INT(event->coding);
+        for (size_t i = 2; i < pending->len; i++) {
+            pending->items[i] = mp_const_none;
+        }
+        mp_map_lookup(map, key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = MP_OBJ_FROM_PTR(pending);
+    } else {
+        pending = MP_OBJ_TO_PTR(elem->value);
+        if (pending->len != (size_t) event->parts + 2)
+            return MP_OBJ_NULL;  // a different message with the same reference
+    }
+    pending->items[event->part + 1] = mp_obj_new_bytes((const uint8_t*) event->text, event->text_len);
+
+    vstr_t vstr;
+    vstr_init(&vstr, event->parts * PDU_DATA_LEN);
+    for (size_t i = 2; i < pending->len; i++) {
+        if (pending->items[i] == mp_const_none) {
+            vstr_clear(&vstr);
+            return MP_OBJ_NULL;
+        }
+        size_t len;
+        const char *data = mp_obj_str_get_data(pending->items[i], &len);
+        vstr_add_strn(&vstr, data, len);
+    }
+    mp_map_lookup(map, key, MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+
+    mp_obj_t message = modcellular_sms_payload(MP_OBJ_SMALL_INT_VALUE(pending->items[1]), (const uint8_t*) vstr.buf, vstr.len);
+    vstr_clear(&vstr);
+    return modcellular_sms_new(event, message);
+}
+
+MP_REGISTER_ROOT_POINTER(mp_obj_t cellular_sms_parts);
+MP_REGISTER_ROOT_POINTER(struct _mp_obj_list_t *cellular_sms_list);
+
+// ---------------
+// GPRS supervisor
+// ---------------
+
+// Keeps the data link up: lost or failed connections are retried from the
+// SDK task with an exponential backoff. Timers run callbacks in the SDK
+// task, so all transitions below happen there.
+
+STATIC void modcellular_supervisor_timer(void *param);
+
+STATIC void modcellular_supervisor_arm(uint32_t ms) {
+    OS_StopCallbackTimer(mainTaskHandle, modcellular_supervisor_timer, NULL);
+    OS_StartCallbackTimer(mainTaskHandle, ms, modcellular_supervisor_timer, NULL);
+}
+
+STATIC void modcellular_supervisor_set(uint8_t state) {
+    uint32_t now = mp_hal_ticks_ms();
+    if (supervisor.state == SUPERVISOR_UP)
+        supervisor.up_total += now - supervisor.since;
+    supervisor.state = state;
+    supervisor.since = now;
+}
+
+STATIC void modcellular_supervisor_link(bool up) {
+    if (MP_STATE_PORT(cellular_gprs_callback) != mp_const_none) {
+        modcellular_event_t *event = modcellular_event_reserve(EVENT_GPRS);
+        if (event) {
+            event->value = up;
+            modcellular_event_commit();
+        }
+    }
+}
+
+STATIC void modcellular_supervisor_fail(void) {
+    // Waits before the next attempt, doubling the delay every time
+    modcellular_supervisor_set(SUPERVISOR_BACKOFF);
+    modcellular_supervisor_arm(supervisor.backoff);
+    supervisor.backoff = MIN(supervisor.backoff * 2, supervisor.backoff_max);
+}
+
+STATIC void modcellular_supervisor_activate(void) {
+    modcellular_supervisor_set(SUPERVISOR_ACTIVATING);
+    if (!Network_StartActive(gprs_context)) {
+        modcellular_supervisor_fail();
+        return;
+    }
+    modcellular_supervisor_arm(TIMEOUT_GPRS_ACTIVATION);
+}
+
+STATIC void modcellular_supervisor_attempt(void) {
+    uint8_t attached;
+    supervisor.attempts ++;
+    if (Network_GetAttachStatus(&attached) && attached) {
+        modcellular_supervisor_activate();
+        return;
+    }
+    modcellular_supervisor_set(SUPERVISOR_ATTACHING);
+    if (!Network_StartAttach()) {
+        modcellular_supervisor_fail();
+        return;
+    }
+    modcellular_supervisor_arm(TIMEOUT_GPRS_ATTACHMENT);
+}
+
+STATIC void modcellular_supervisor_timer(void *param) {
+    switch (supervisor.state) {
+        case SUPERVISOR_BACKOFF:
+            modcellular_supervisor_attempt();
+            break;
+        case SUPERVISOR_ATTACHING:
+        case SUPERVISOR_ACTIVATING:
+            // The attempt timed out
+            modcellular_supervisor_fail();
+            break;
+    }
+}
+
+STATIC void modcellular_supervisor_attached(void) {
+    if (supervisor.state == SUPERVISOR_ATTACHING)
+        modcellular_supervisor_activate();
+}
+
+STATIC void modcellular_supervisor_active(void) {
+    if (supervisor.state == SUPERVISOR_OFF || supervisor.state == SUPERVISOR_UP)
+        return;
+    OS_StopCallbackTimer(mainTaskHandle, modcellular_supervisor_timer, NULL);
+    if (supervisor.down_since) {
+        supervisor.outage_total += mp_hal_ticks_ms() - supervisor.down_since;
+        supervisor.down_since = 0;
+    }
+    supervisor.backoff = supervisor.backoff_min;
+    modcellular_supervisor_set(SUPERVISOR_UP);
+    modcellular_supervisor_link(true);
+}
+
+STATIC void modcellular_supervisor_lost(void) {
+    // Detachment, deactivation or a failed attempt
+    switch (supervisor.state) {
+        case SUPERVISOR_UP:
+            supervisor.outages ++;
+            supervisor.down_since = mp_hal_ticks_ms();
+            supervisor.backoff = supervisor.backoff_min;
+            modcellular_supervisor_link(false);
+            modcellular_supervisor_fail();
+            break;
+        case SUPERVISOR_ATTACHING:
+        case SUPERVISOR_ACTIVATING:
+            modcellular_supervisor_fail();
+            break;
+    }
+}
+
+STATIC void modcellular_supervisor_enter(uint8_t state) {
+    // Runs in the MicroPython task: the SDK task does not see a transition
+    // half made
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    modcellular_supervisor_set(state);
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+}
+
+STATIC void modcellular_supervisor_stop(void) {
+    // Runs in the MicroPython task; a timer firing meanwhile finds it off
+    modcellular_supervisor_enter(SUPERVISOR_OFF);
+    OS_StopCallbackTimer(mainTaskHandle, modcellular_supervisor_timer, NULL);
+}
+
 // ----
 // Init
 // ----
@@ -151,10 +910,27 @@ void modcellular_init0(void) {
     sms_callback = mp_const_none;
     call_callback = mp_const_none;
     ussd_callback = mp_const_none;
+    MP_STATE_PORT(cellular_cells_callback) = mp_const_none;
+    MP_STATE_PORT(cellular_gprs_callback) = mp_const_none;
+
+    // Stop supervising GPRS
+    modcellular_supervisor_stop();
+
+    // Drop events left from before the reset
+    event_tail = event_head;
+    event_drain_scheduled = 0;
+    sms_record_tail = sms_record_head;
+    MP_STATE_PORT(cellular_sms_list) = NULL;
+    memset(MP_STATE_PORT(cellular_ops), 0, sizeof(MP_STATE_PORT(cellular_ops)));
+    sms_iter_active = 0;
+    modcellular_sms_record_room_wake();
+    MP_STATE_PORT(cellular_sms_parts) = MP_OBJ_NULL;
 
     // Reset statuses
     network_exception = NTW_NO_EXC;
     cells_n = 0;
+    cells_seq = 0;
+    cells_pending = 0;
 
     uint8_t status;
 
@@ -186,6 +962,8 @@ void modcellular_init0(void) {
     Network_SetFlightMode(0);
 
     // Set SMS storage
+    sms_pdu_mode = 0;
+    sms_format_pdu = 0;
     if (!SMS_SetFormat(SMS_FORMAT_TEXT, SIM0))
         mp_printf(&mp_plat_print, "Warning: modcellular_init0 failed to reset SMS format\n");
 
@@ -211,6 +989,13 @@ NORETURN void mp_raise_RuntimeError(const char *msg) {
     mp_raise_msg(&mp_type_RuntimeError, msg);
 }
 
+// Network failures: the errno is one of NTW_EXC_* exported as cellular.E*
+MP_DEFINE_EXCEPTION(CellularError, OSError)
+
+NORETURN void mp_raise_CellularError(uint16_t code) {
+    nlr_raise(mp_obj_new_exception_arg1(&mp_type_CellularError, MP_OBJ_NEW_SMALL_INT(code)));
+}
+
 // ------
 // Notify
 // ------
@@ -218,7 +1003,13 @@ NORETURN void mp_raise_RuntimeError(const char *msg) {
 void modcellular_network_status_update(uint8_t new_status, uint16_t new_exception) {
     if (new_exception) network_exception = new_exception;
     network_status = new_status;
-    if (network_status_callback && network_status_callback != mp_const_none) mp_sched_schedule(network_status_callback, mp_obj_new_int(network_status));
+    if (network_status_callback && network_status_callback != mp_const_none) {
+        modcellular_event_t *event = modcellular_event_reserve(EVENT_STATUS);
+        if (event) {
+            event->value = new_status;
+            modcellular_event_commit();
+        }
+    }
 }
 
 void modcellular_notify_no_sim(API_Event_t* event) {
@@ -255,28 +1046,35 @@ void modcellular_notify_dereg(API_Event_t* event) {
 
 void modcellular_notify_det(API_Event_t* event) {
     modcellular_network_status_update(network_status & ~NTW_ATT_BIT, 0);
+    modcellular_supervisor_lost();
 }
 
 void modcellular_notify_att_failed(API_Event_t* event) {
     modcellular_network_status_update(network_status & ~NTW_ATT_BIT, NTW_EXC_ATT_FAILED);
+    modcellular_supervisor_lost();
 }
 
 void modcellular_notify_att(API_Event_t* event) {
     modcellular_network_status_update(network_status | NTW_ATT_BIT, 0);
+    modcellular_supervisor_attached();
 }
 
 // Activate
 
 void modcellular_notify_deact(API_Event_t* event) {
+    modusocket_dns_flush();
     modcellular_network_status_update(network_status & ~NTW_ACT_BIT, 0);
+    modcellular_supervisor_lost();
 }
 
 void modcellular_notify_act_failed(API_Event_t* event) {
     modcellular_network_status_update(network_status & ~NTW_ACT_BIT, NTW_EXC_ACT_FAILED);
+    modcellular_supervisor_lost();
 }
 
 void modcellular_notify_act(API_Event_t* event) {
     modcellular_network_status_update(network_status | NTW_ACT_BIT, 0);
+    modcellular_supervisor_active();
 }
 
 // Networks
@@ -293,22 +1091,64 @@ void modcellular_notify_ntwlist(API_Event_t* event) {
 
 // SMS
 
+STATIC bool modcellular_sms_record_room(void) {
+    // Waits for a free record slot while the consumer is busy taking
+    // records; SDK task only. Records are dropped if nothing takes them.
+    while (sms_record_head - sms_record_tail >= SMS_RECORD_QUEUE) {
+        if (!(sms_iter_active || MP_STATE_PORT(cellular_sms_list)) || mp_hal_ticks_ms() - sms_record_touched >= SMS_RECORD_WAIT)
+            return false;
+        sms_record_room_waiting = 1;
+        EVENT_BARRIER();
+        if (sms_record_head - sms_record_tail >= SMS_RECORD_QUEUE)
+            OS_WaitForSemaphore(sms_record_room_sem, SMS_RECORD_WAIT);
+        sms_record_room_waiting = 0;
+    }
+    return true;
+}
+
 void modcellular_notify_sms_list(API_Event_t* event) {
     SMS_Message_Info_t* messageInfo = (SMS_Message_Info_t*)event->pParam1;
 
-    if (sms_list_buffer && (sms_list_buffer->len > sms_list_buffer_count)) {
-        sms_list_buffer->items[sms_list_buffer_count] = modcellular_sms_from_record(messageInfo);
-        sms_list_buffer_count ++;
+    modcellular_event_t *record = NULL;
+    if (modcellular_sms_record_room())
+        record = modcellular_event_clear(&sms_record_queue[sms_record_head % SMS_RECORD_QUEUE], EVENT_SMS_RECORD);
+    if (record) {
+        record->value = messageInfo->index;
+        record->status = (uint8_t)messageInfo->status;
+        if (sms_format_pdu) {
+            // Parts of concatenated messages are listed separately
+            uint8_t pdu[PDU_MAX_LEN];
+            int len = modcellular_hex_decode(messageInfo->data, messageInfo->dataLen, pdu, sizeof(pdu));
+            if (len < 0 || !modcellular_pdu_deliver(pdu, len, record)) {
+                record->coding = SMS_CODING_TEXT;
+                record->text_len = 0;
+            }
+        } else {
+            const char *number = (char*)messageInfo->phoneNumber + 1;
+            record->pn_type = (uint8_t)messageInfo->phoneNumberType;
+            modcellular_event_set_number(record, number, strnlen(number, SMS_PHONE_NUMBER_MAX_LEN - 1));
+            modcellular_event_set_text(record, messageInfo->data, messageInfo->dataLen);
+        }
+        EVENT_BARRIER();
+        sms_record_head ++;
+        if (sms_record_ready_waiting) {
+            sms_record_ready_waiting = 0;
+            OS_ReleaseSemaphore(sms_record_ready_sem);
+        }
     } else {
         network_exception = NTW_EXC_SMS_DROP;
     }
+    // Counted after the record is queued: see modcellular_sms_list_ready
+    sms_list_seen ++;
     OS_Free(messageInfo->data);
 }
 
 void modcellular_notify_sms_sent(API_Event_t* event) {
     sms_send_flag = 1;
-    if (sms_callback && sms_callback != mp_const_none)
-        mp_sched_schedule(sms_callback, mp_obj_new_int(SMS_SENT));
+    if (sms_callback && sms_callback != mp_const_none) {
+        if (modcellular_event_reserve(EVENT_SMS_SENT))
+            modcellular_event_commit();
+    }
 }
 
 void modcellular_notify_sms_error(API_Event_t* event) {
@@ -316,7 +1156,21 @@ void modcellular_notify_sms_error(API_Event_t* event) {
 }
 
 void modcellular_notify_sms_receipt(API_Event_t* event) {
-    if (sms_callback && sms_callback != mp_const_none) {
+    if (sms_callback && sms_callback != mp_const_none && sms_format_pdu) {
+        // The content is the PDU in hex
+        uint8_t pdu[PDU_MAX_LEN];
+        int len = modcellular_hex_decode(event->pParam2, event->param2, pdu, sizeof(pdu));
+
+        modcellular_event_t *sms = modcellular_event_reserve(EVENT_SMS);
+        if (sms) {
+            if (len < 0 || !modcellular_pdu_deliver(pdu, len, sms)) {
+                network_exception = NTW_EXC_SMS_DROP;
+                return;
+            }
+            modcellular_event_commit();
+        }
+
+    } else if (sms_callback && sms_callback != mp_const_none) {
         SMS_Encode_Type_t encodeType = event->param1;
         uint32_t content_length = event->param2;
         uint8_t* header = event->pParam1;
@@ -327,7 +1181,8 @@ void modcellular_notify_sms_receipt(API_Event_t* event) {
 
         if (encodeType == SMS_ENCODE_TYPE_UNICODE) {
             if (!SMS_Unicode2LocalLanguage(content,content_length,CHARSET_UTF_8,&gbk,&gbkLen)) {
-                 mp_raise_ValueError("Failed to convert sms to Unicode");
+                network_exception = NTW_EXC_SMS_DROP;
+                return;
             }
         }
         else {
@@ -335,13 +1190,22 @@ void modcellular_notify_sms_receipt(API_Event_t* event) {
             gbkLen = content_length;
         }
 
-        mp_obj_t sms = modcellular_sms_from_raw(header, strlen((char*) header), gbk, gbkLen);
+        modcellular_event_t *sms = modcellular_event_reserve(EVENT_SMS);
+        if (sms) {
+            // The header starts with the quoted phone number
+            if (header[0] == '"') {
+                const char *number = (char*) header + 1;
+                const char *end = strchr(number, '"');
+                if (end)
+                    modcellular_event_set_number(sms, number, end - number);
+            }
+            modcellular_event_set_text(sms, gbk, gbkLen);
+            modcellular_event_commit();
+        }
 
         if (encodeType == SMS_ENCODE_TYPE_UNICODE) {
             OS_Free(gbk);
         }
-
-        mp_sched_schedule(sms_callback, sms);
     }
 }
 
@@ -350,41 +1214,66 @@ void modcellular_notify_sms_receipt(API_Event_t* event) {
 void modcellular_notify_signal(API_Event_t* event) {
     network_signal_quality = event->param1;
     network_signal_rx_level = event->param2;
+
+    signal_seq ++;
+    EVENT_BARRIER();
+    signal_sample_t *sample = &signal_history[signal_history_n % MICROPY_PY_CELLULAR_SIGNAL_HISTORY];
+    sample->stamp = mp_hal_ticks_ms();
+    sample->quality = event->param1;
+    sample->rx_level = event->param2;
+    signal_history_n ++;
+    EVENT_BARRIER();
+    signal_seq ++;
 }
 
 // Calls
 
 void modcellular_notify_call_incoming(API_Event_t* event) {
-    if (call_callback && call_callback != mp_const_none)
-        mp_sched_schedule(call_callback, mp_obj_new_str((char*) event->pParam1, strlen((char*) event->pParam1)));
+    if (call_callback && call_callback != mp_const_none) {
+        modcellular_event_t *call = modcellular_event_reserve(EVENT_CALL_INCOMING);
+        if (call) {
+            modcellular_event_set_number(call, (char*) event->pParam1, strlen((char*) event->pParam1));
+            modcellular_event_commit();
+        }
+    }
 }
 
 void modcellular_notify_call_hangup(API_Event_t* event) {
     if (event->param2)
         network_exception = (uint8_t) event->param2 + 0x0F;
-    if (call_callback && call_callback != mp_const_none)
-        mp_sched_schedule(call_callback, mp_obj_new_bool(event->param1));
+    if (call_callback && call_callback != mp_const_none) {
+        modcellular_event_t *call = modcellular_event_reserve(EVENT_CALL_HANGUP);
+        if (call) {
+            call->value = event->param1;
+            modcellular_event_commit();
+        }
+    }
 }
 
 // USSD
 
-mp_obj_t decode_ussd(API_Event_t* event) {
+STATIC void modcellular_ussd_decode(API_Event_t* event, modcellular_event_t *target) {
     USSD_Type_t* incoming = (USSD_Type_t*) event->pParam1;
-    char code[incoming->usdStringSize + 1];
-    int len = GSM_7BitTo8Bit(incoming->usdString, (uint8_t*) code, incoming->usdStringSize);
+    uint8_t code[incoming->usdStringSize * 8 / 7 + 1];
+    int len = GSM_7BitTo8Bit(incoming->usdString, code, incoming->usdStringSize);
 
-    mp_obj_t tuple[2] = {
-        mp_obj_new_int(incoming->option),
-        mp_obj_new_str(code, len),
-    };
-    return mp_obj_new_tuple(2, tuple);
+    target->kind = EVENT_USSD;
+    target->number_len = 0;
+    target->value = incoming->option;
+    modcellular_event_set_text(target, code, len);
 }
 
 void modcellular_notify_ussd_sent(API_Event_t* event) {
+    modcellular_ussd_decode(event, &ussd_response);
+    EVENT_BARRIER();
     ussd_send_flag = 1;
-    ussd_response = decode_ussd(event);
-    if (ussd_callback && ussd_callback != mp_const_none)
-        mp_sched_schedule(ussd_callback, ussd_response);
+    if (ussd_callback && ussd_callback != mp_const_none) {
+        modcellular_event_t *ussd = modcellular_event_reserve(EVENT_USSD);
+        if (ussd) {
+            memcpy(ussd, &ussd_response, sizeof(modcellular_event_t));
+            modcellular_event_commit();
+        }
+    }
 }
 
 void modcellular_notify_ussd_failed(API_Event_t* event) {
@@ -392,17 +1281,322 @@ void modcellular_notify_ussd_failed(API_Event_t* event) {
 }
 
 void modcellular_notify_incoming_ussd(API_Event_t* event) {
-    if (ussd_callback && ussd_callback != mp_const_none)
-        mp_sched_schedule(ussd_callback, decode_ussd(event));
+    if (ussd_callback && ussd_callback != mp_const_none) {
+        modcellular_event_t *ussd = modcellular_event_reserve(EVENT_USSD);
+        if (ussd) {
+            modcellular_ussd_decode(event, ussd);
+            modcellular_event_commit();
+        }
+    }
 }
 
 // Base stations
 
+// Station records: little-endian mcc, mnc, lac, arfcn (uint16), cell_id
+// (uint32), bsic, rx_lev, rx_lev_sub (uint8) and a padding byte
+#define STATION_RECORD_SIZE 16
+
+#if MAX_CELLS * STATION_RECORD_SIZE > EVENT_TEXT_LEN
+#error "Station records do not fit into an event"
+#endif
+
+STATIC void modcellular_pack_u16(uint8_t *dest, uint16_t value) {
+    dest[0] = value;
+    dest[1] = value >> 8;
+}
+
+STATIC size_t modcellular_cells_pack(const Network_Location_t *src, int n, uint8_t *dest) {
+    // Packs stations into records; returns the number of bytes written
+    for (int i=0; i<n; i++, dest += STATION_RECORD_SIZE) {
+        modcellular_pack_u16(dest + 0, MCC(src[i].sMcc));
+        modcellular_pack_u16(dest + 2, MNC(src[i].sMnc));
+        modcellular_pack_u16(dest + 4, src[i].sLac);
+        modcellular_pack_u16(dest + 6, src[i].nArfcn);
+        modcellular_pack_u16(dest + 8, src[i].sCellID);
+        modcellular_pack_u16(dest + 10, (uint32_t) src[i].sCellID >> 16);
+        dest[12] = src[i].iBsic;
+        dest[13] = src[i].iRxLev;
+        dest[14] = src[i].iRxLevSub;
+        dest[15] = 0;
+    }
+    return n * STATION_RECORD_SIZE;
+}
+
+STATIC bool modcellular_cell_same(const Network_Location_t *a, const Network_Location_t *b) {
+    return !memcmp(a->sMcc, b->sMcc, sizeof(a->sMcc)) && !memcmp(a->sMnc, b->sMnc, sizeof(a->sMnc)) &&
+        a->sLac == b->sLac && a->sCellID == b->sCellID;
+}
+
+STATIC bool modcellular_cells_changed(const Network_Location_t *update, int n) {
+    // Compares the serving cell and the set of neighbours with the snapshot;
+    // signal levels are ignored
+    if (!cells_seq || n != cells_n)
+        return true;
+    if (n == 0)
+        return false;
+    if (!modcellular_cell_same(&update[0], &cells[0]))
+        return true;
+    for (int i=1; i<n; i++) {
+        int j;
+        for (j=1; j<n && !modcellular_cell_same(&update[i], &cells[j]); j++);
+        if (j == n)
+            return true;
+    }
+    return false;
+}
+
 void modcellular_notify_cell_info(API_Event_t* event) {
-    cells_n = event->param1;
-    memcpy(cells, event->pParam1, MIN(cells_n * sizeof(Network_Location_t), sizeof(cells)));
+    Network_Location_t *update = (Network_Location_t*) event->pParam1;
+    int n = MIN(event->param1, MAX_CELLS);
+    bool changed = modcellular_cells_changed(update, n);
+
+    cells_seq ++;
+    EVENT_BARRIER();
+    memcpy(cells, update, n * sizeof(Network_Location_t));
+    cells_n = n;
+    cells_stamp = mp_hal_ticks_ms();
+    EVENT_BARRIER();
+    cells_seq ++;
+    cells_pending = 0;
+
+    if (changed && MP_STATE_PORT(cellular_cells_callback) != mp_const_none) {
+        modcellular_event_t *records = modcellular_event_reserve(EVENT_CELLS);
+        if (records) {
+            records->text_len = modcellular_cells_pack(cells, n, (uint8_t*) records->text);
+            modcellular_event_commit();
+        }
+    }
+}
+
+// ----------
+// Operations
+// ----------
+
+// Slow modem requests are started right away and completed by the notify
+// handlers above which update network_status, network_list_buffer, cells
+// and the send flags. An operation object polls these with ready(), which is
+// cheap, does not allocate and never raises: it is called from the stream
+// ioctl by uselect (and thus by uasyncio). finish() builds the result in the
+// interpreter context once the operation is complete.
+
+typedef struct _modcellular_op_t modcellular_op_t;
+
+typedef bool (*modcellular_op_ready_t)(modcellular_op_t *op);
+typedef mp_obj_t (*modcellular_op_finish_t)(modcellular_op_t *op);
+
+#define OP_PENDING 0
+#define OP_READY 1
+#define OP_FAILED 2
+#define OP_TIMEDOUT 3
+#define OP_DONE 4
+
+struct _modcellular_op_t {
+    mp_obj_base_t base;
+    modcellular_op_ready_t ready;
+    modcellular_op_finish_t finish;
+    uint32_t start;
+    uint32_t timeout;
+    uint32_t arg;
+    uint16_t failure;               // network_exception value aborting the operation
+    uint16_t error;                 // CellularError code (NTW_EXC_*) if failed
+    uint8_t state;
+    uint8_t stage;                  // for operations with several steps
+    const char *timeout_warning;    // if set, the operation completes with a warning on timeout
+    mp_obj_t result;
+};
+
+// Operations of a kind share modem state (the send flags, the list
+// buffers, the GPRS context): one of each kind runs at a time. Blocking
+// calls hold their kind with an operation that never gets ready; a kind is
+// free again once its operation is complete or timed out.
+
+#define OP_KIND_SMS_SEND 0
+#define OP_KIND_SMS_LIST 1
+#define OP_KIND_GPRS 2
+#define OP_KIND_SCAN 3
+#define OP_KIND_REGISTER 4
+#define OP_KIND_USSD 5
+#define OP_KIND_STATIONS 6
+#define OP_KINDS 7
+
+STATIC const mp_obj_type_t modcellular_op_type;
+
+STATIC mp_obj_t modcellular_op_new(modcellular_op_ready_t ready, modcellular_op_finish_t finish, uint32_t timeout, uint16_t failure) {
+    modcellular_op_t *op = m_new_obj(modcellular_op_t);
+    op->base.type = &modcellular_op_type;
+    op->ready = ready;
+    op->finish = finish;
+    op->start = mp_hal_ticks_ms();
+    op->timeout = timeout;
+    op->arg = 0;
+    op->failure = failure;
+    op->error = 0;
+    op->state = OP_PENDING;
+    op->stage = 0;
+    op->timeout_warning = NULL;
+    op->result = mp_const_none;
+    // Stale exceptions of the same kind should not fail the new operation
+    if (failure && network_exception == failure) {
+        network_exception = NTW_NO_EXC;
+    }
+    return MP_OBJ_FROM_PTR(op);
+}
+
+STATIC bool modcellular_op_poll(modcellular_op_t *op) {
+    // Advances the operation; true if complete
+    if (op->state != OP_PENDING) {
+        return true;
+    }
+    if (op->ready(op)) {
+        op->state = op->error ? OP_FAILED : OP_READY;
+    } else if (op->failure && network_exception == op->failure) {
+        network_exception = NTW_NO_EXC;
+        op->error = op->failure;
+        op->state = OP_FAILED;
+    } else if (mp_hal_ticks_ms() - op->start >= op->timeout) {
+        op->state = OP_TIMEDOUT;
+    }
+    return op->state != OP_PENDING;
+}
+
+STATIC void modcellular_op_check(uint8_t kind) {
+    // Raises if an operation of the kind is in progress. A complete one
+    // takes its result now: the next operation reuses the state behind it
+    mp_obj_t other = MP_STATE_PORT(cellular_ops)[kind];
+    if (other != MP_OBJ_NULL) {
+        modcellular_op_t *op = MP_OBJ_TO_PTR(other);
+        if (!modcellular_op_poll(op))
+            mp_raise_CellularError(MP_EALREADY);
+        MP_STATE_PORT(cellular_ops)[kind] = MP_OBJ_NULL;
+        if (op->state == OP_READY) {
+            op->result = op->finish(op);
+            op->state = OP_DONE;
+        }
+    }
+}
+
+STATIC mp_obj_t modcellular_op_claim(uint8_t kind, mp_obj_t op) {
+    // Makes op the running operation of the kind
+    MP_STATIC_ASSERT(MP_ARRAY_SIZE(MP_STATE_PORT(cellular_ops)) == OP_KINDS);
+    MP_STATE_PORT(cellular_ops)[kind] = op;
+    return op;
+}
+
+STATIC bool modcellular_op_blocking_ready(modcellular_op_t *op) {
+    return false;
 }
 
+STATIC modcellular_op_t *modcellular_op_block(uint8_t kind, uint32_t timeout) {
+    // Holds the kind for a blocking call once the request is made, for
+    // timeout ms at most; release with modcellular_op_unblock
+    mp_obj_t op = modcellular_op_new(modcellular_op_blocking_ready, NULL, timeout, 0);
+    return MP_OBJ_TO_PTR(modcellular_op_claim(kind, op));
+}
+
+STATIC void modcellular_op_unblock(modcellular_op_t *op) {
+    op->state = OP_DONE;
+}
+
+STATIC mp_obj_t modcellular_op_result(modcellular_op_t *op) {
+    // Retrieves the result of a complete operation or raises
+    switch (op->state) {
+        case OP_FAILED:
+            mp_raise_CellularError(op->error);
+        case OP_TIMEDOUT:
+            if (op->timeout_warning == NULL) {
+                mp_raise_OSError(MP_ETIMEDOUT);
+            }
+            mp_warning(NULL, op->timeout_warning);
+            // fall through
+        case OP_READY:
+            op->result = op->finish(op);
+            op->state = OP_DONE;
+            // fall through
+        default:
+            return op->result;
+    }
+}
+
+STATIC mp_obj_t modcellular_op_iternext(mp_obj_t self_in) {
+    // ========================================
+    // Operation.__next__(): awaits completion.
+    // ========================================
+    modcellular_op_t *self = MP_OBJ_TO_PTR(self_in);
+    if (modcellular_op_poll(self)) {
+        return mp_make_stop_iteration(modcellular_op_result(self));
+    }
+    // Suspend the current uasyncio task until the stream ioctl below reports
+    // completion, the same way ThreadSafeFlag.wait() does
+    mp_obj_t uasyncio = mp_import_name(MP_QSTR_uasyncio, mp_const_none, MP_OBJ_NEW_SMALL_INT(0));
+    mp_obj_t io_queue = mp_load_attr(mp_load_attr(uasyncio, MP_QSTR_core), MP_QSTR__io_queue);
+    mp_obj_t dest[3];
+    mp_load_method(io_queue, MP_QSTR_queue_read, dest);
+    dest[2] = self_in;
+    mp_call_method_n_kw(1, 0, dest);
+    return mp_const_none;
+}
+
+STATIC mp_uint_t modcellular_op_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    // ========================================
+    // Stream: IO control (polling only).
+    // ========================================
+    modcellular_op_t *self = MP_OBJ_TO_PTR(self_in);
+    if (request == MP_STREAM_POLL) {
+        return modcellular_op_poll(self) ? arg & MP_STREAM_POLL_RD : 0;
+    }
+    *errcode = MP_EINVAL;
+    return MP_STREAM_ERROR;
+}
+
+STATIC mp_obj_t modcellular_op_done(mp_obj_t self_in) {
+    // ========================================
+    // Checks whether the operation is complete.
+    // Returns:
+    //     True if complete.
+    // ========================================
+    return mp_obj_new_bool(modcellular_op_poll(MP_OBJ_TO_PTR(self_in)));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modcellular_op_done_obj, modcellular_op_done);
+
+STATIC mp_obj_t modcellular_op_wait(mp_obj_t self_in) {
+    // ========================================
+    // Blocks until the operation is complete.
+    // Returns:
+    //     The result of the operation.
+    // ========================================
+    modcellular_op_t *self = MP_OBJ_TO_PTR(self_in);
+    while (!modcellular_op_poll(self)) {
+        OS_Sleep(1);
+        MICROPY_EVENT_POLL_HOOK
+    }
+    return modcellular_op_result(self);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modcellular_op_wait_obj, modcellular_op_wait);
+
+STATIC const mp_rom_map_elem_t modcellular_op_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_done), MP_ROM_PTR(&modcellular_op_done_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wait), MP_ROM_PTR(&modcellular_op_wait_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(modcellular_op_locals_dict, modcellular_op_locals_dict_table);
+
+STATIC const mp_stream_p_t modcellular_op_stream_p = {
+    .ioctl = modcellular_op_ioctl,
+};
+
+STATIC MP_DEFINE_CONST_OBJ_TYPE(
+    modcellular_op_type,
+    MP_QSTR_Operation,
+    MP_TYPE_FLAG_ITER_IS_ITERNEXT,
+    iter, modcellular_op_iternext,
+    protocol, &modcellular_op_stream_p,
+    locals_dict, &modcellular_op_locals_dict
+);
+
+MP_REGISTER_ROOT_POINTER(mp_obj_t cellular_ops[7]);  // OP_KINDS
+
 // -------
 // Classes
 // -------
@@ -446,47 +1640,168 @@ mp_obj_t modcellular_sms_make_new(const mp_obj_type_t *type, size_t n_args, size
     return MP_OBJ_FROM_PTR(self);
 }
 
-STATIC mp_obj_t modcellular_sms_send(size_t n_args, const mp_obj_t *args) {
-    // ========================================
-    // Sends an SMS messsage.
-    // Args:
-    //     timeout (int): optional timeout in ms;
-    // ========================================
-    REQUIRES_NETWORK_REGISTRATION;
+#define SMS_SEND_TIMEOUT_WARNING "Failed to send SMS immidiately. The module will continue attempts sending it"
 
-    mp_int_t timeout = TIMEOUT_SMS_SEND;
-    if (n_args == 2)
-        timeout = mp_obj_get_int(args[1]);
+STATIC bool modcellular_sms_set_format(uint8_t pdu) {
+    // Switches the modem between text and PDU modes
+    if (sms_format_pdu == pdu)
+        return true;
+    if (!SMS_SetFormat(pdu ? SMS_FORMAT_PDU : SMS_FORMAT_TEXT, SIM0))
+        return false;
+    sms_format_pdu = pdu;
+    return true;
+}
 
-    sms_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+STATIC bool modcellular_sms_submit_part(mp_obj_t message, uint8_t parts, uint8_t part) {
+    // Submits a part of a binary message: message is a (number, data) tuple
+    mp_obj_t *items;
+    mp_obj_get_array_fixed_n(message, 2, &items);
+    size_t len;
+    const uint8_t *data = (const uint8_t*) mp_obj_str_get_data(items[1], &len);
 
-    if (self->purpose != 0)
-        mp_raise_ValueError("A message with non-zero purpose cannot be sent");
+    size_t offset = 0;
+    if (parts > 1) {
+        offset = (part - 1) * PDU_PART_LEN;
+        len = MIN(len - offset, PDU_PART_LEN);
+    }
 
-    const char* destination_c = mp_obj_str_get_str(self->phone_number);
-    const char* message_c = mp_obj_str_get_str(self->message);
+    char hex[2 * PDU_MAX_LEN + 1];
+    size_t hex_len = modcellular_pdu_submit(mp_obj_str_get_str(items[0]), data + offset, len, sms_concat_ref, parts, part, hex);
+    sms_send_flag = 0;
+    return SMS_SendMessage(mp_obj_str_get_str(items[0]), (uint8_t*) hex, hex_len, SIM0);
+}
+
+STATIC bool modcellular_sms_send_ready(modcellular_op_t *op) {
+    if (!sms_send_flag)
+        return false;
+    if (op->stage < op->arg) {
+        // Parts are submitted one at a time, each with its own timeout
+        if (!modcellular_sms_submit_part(op->result, op->arg, op->stage + 1)) {
+            op->error = NTW_EXC_SMS_SEND;
+            modcellular_sms_set_format(sms_pdu_mode);
+            return true;
+        }
+        op->stage ++;
+        op->start = mp_hal_ticks_ms();
+        return false;
+    }
+    return true;
+}
 
-    uint8_t* unicode = NULL;
-    uint32_t unicodeLen;
+STATIC mp_obj_t modcellular_sms_send_finish(modcellular_op_t *op) {
+    sms_send_flag = 0;
+    modcellular_sms_set_format(sms_pdu_mode);
+    return mp_const_none;
+}
+
+STATIC mp_obj_t modcellular_sms_send_start(mp_obj_t self_in, uint32_t timeout, uint16_t failure) {
+    // Submits the message (or its first part); returns the operation
+    sms_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->purpose != 0)
+        mp_raise_ValueError("A message with non-zero purpose cannot be sent");
+
+    modcellular_op_check(OP_KIND_SMS_SEND);
+    const char* destination_c = mp_obj_str_get_str(self->phone_number);
+    mp_obj_t op_in = modcellular_op_new(modcellular_sms_send_ready, modcellular_sms_send_finish, timeout, failure);
+    modcellular_op_t *op = MP_OBJ_TO_PTR(op_in);
+    op->timeout_warning = SMS_SEND_TIMEOUT_WARNING;
+    op->arg = 1;
+    op->stage = 1;
+
+    if (!mp_obj_is_str(self->message)) {
+        // Binary messages are sent as 8-bit PDUs, split into parts if needed
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(self->message, &bufinfo, MP_BUFFER_READ);
+
+        const char *digits = destination_c + (destination_c[0] == '+');
+        size_t n_digits = strlen(digits);
+        if (n_digits == 0 || n_digits > SMS_PDU_NUMBER_LEN || strspn(digits, "0123456789") != n_digits)
+            mp_raise_ValueError("Binary messages require a numeric phone number");
+
+        if (bufinfo.len > PDU_DATA_LEN)
+            op->arg = (bufinfo.len + PDU_PART_LEN - 1) / PDU_PART_LEN;
+        if (op->arg > 255)
+            mp_raise_ValueError("The message is too long");
+
+        mp_obj_t message[2] = {self->phone_number, mp_obj_new_bytes(bufinfo.buf, bufinfo.len)};
+        op->result = mp_obj_new_tuple(2, message);
+
+        if (!modcellular_sms_set_format(1))
+            mp_raise_ValueError("Failed to switch to PDU mode");
+        sms_concat_ref ++;
+        if (!modcellular_sms_submit_part(op->result, op->arg, 1)) {
+            modcellular_sms_set_format(sms_pdu_mode);
+            mp_raise_ValueError("Failed to submit SMS message for sending");
+        }
+        return modcellular_op_claim(OP_KIND_SMS_SEND, op_in);
+    }
+
+    const char* message_c = mp_obj_str_get_str(self->message);
+
+    uint8_t* unicode = NULL;
+    uint32_t unicodeLen;
 
     if (!SMS_LocalLanguage2Unicode((uint8_t*)message_c, strlen(message_c), CHARSET_UTF_8, &unicode, &unicodeLen))
         mp_raise_ValueError("Failed to convert to Unicode before sending SMS");
 
+    if (!modcellular_sms_set_format(0)) {
+        OS_Free(unicode);
+        mp_raise_ValueError("Failed to switch to text mode");
+    }
+
     sms_send_flag = 0;
     if (!SMS_SendMessage(destination_c, unicode, unicodeLen, SIM0)) {
         OS_Free(unicode);
+        modcellular_sms_set_format(sms_pdu_mode);
         mp_raise_ValueError("Failed to submit SMS message for sending");
     }
     OS_Free(unicode);
+    return modcellular_op_claim(OP_KIND_SMS_SEND, op_in);
+}
 
-    WAIT_UNTIL(sms_send_flag, timeout, 100, mp_warning(NULL, "Failed to send SMS immidiately. The module will continue attempts sending it"));
+STATIC mp_obj_t modcellular_sms_send(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Sends an SMS messsage.
+    // Args:
+    //     timeout (int): optional timeout in ms;
+    // ========================================
+    REQUIRES_NETWORK_REGISTRATION;
 
-    sms_send_flag = 0;
-    return mp_const_none;
+    mp_int_t timeout = TIMEOUT_SMS_SEND;
+    if (n_args == 2)
+        timeout = mp_obj_get_int(args[1]);
+
+    mp_obj_t op = modcellular_sms_send_start(args[0], timeout, 0);
+
+    // A zero timeout submits a single-part message without waiting
+    if (timeout == 0 && ((modcellular_op_t*) MP_OBJ_TO_PTR(op))->arg == 1)
+        return modcellular_sms_send_finish(MP_OBJ_TO_PTR(op));
+
+    return modcellular_op_wait(op);
 }
 
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_sms_send_obj, 1, 2, modcellular_sms_send);
 
+STATIC mp_obj_t modcellular_sms_send_async(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Sends an SMS messsage without blocking.
+    // Args:
+    //     timeout (int): optional timeout in ms;
+    // Returns:
+    //     An awaitable operation.
+    // ========================================
+    REQUIRES_NETWORK_REGISTRATION;
+
+    mp_int_t timeout = TIMEOUT_SMS_SEND;
+    if (n_args == 2)
+        timeout = mp_obj_get_int(args[1]);
+
+    return modcellular_sms_send_start(args[0], timeout, NTW_EXC_SMS_SEND);
+}
+
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_sms_send_async_obj, 1, 2, modcellular_sms_send_async);
+
 STATIC mp_obj_t modcellular_sms_withdraw(mp_obj_t self_in) {
     // ========================================
     // Withdraws an SMS message from the SIM card.
@@ -536,26 +1851,96 @@ STATIC mp_obj_t modcellular_sms__withdraw_by_index(mp_obj_t index) {
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(modcellular_sms__withdraw_by_index_obj, modcellular_sms__withdraw_by_index);
 STATIC MP_DEFINE_CONST_STATICMETHOD_OBJ(modcellular_sms__withdraw_by_index_static_class_obj, MP_ROM_PTR(&modcellular_sms__withdraw_by_index_obj));
 
-STATIC mp_obj_t modcellular_sms_list(void) {
-    // ========================================
-    // Lists SMS messages.
-    // Returns:
-    //     A list of SMS messages.
-    // ========================================
-    REQUIRES_NETWORK_REGISTRATION;
+#define SMS_LIST_TIMEOUT_WARNING "Failed to poll all SMS: the list may be incomplete"
+
+STATIC modcellular_event_t *modcellular_sms_record_peek(void) {
+    // The oldest listed record or NULL; MicroPython task only
+    sms_record_touched = mp_hal_ticks_ms();
+    if (sms_record_tail == sms_record_head)
+        return NULL;
+    EVENT_BARRIER();
+    return &sms_record_queue[sms_record_tail % SMS_RECORD_QUEUE];
+}
+
+STATIC void modcellular_sms_record_release(void) {
+    EVENT_BARRIER();
+    sms_record_tail ++;
+    modcellular_sms_record_room_wake();
+}
+
+STATIC void modcellular_sms_record_wait(uint32_t ms) {
+    // Sleeps until a record is listed or for ms at most, handling pending
+    // events in between
+    if (ms > SMS_RECORD_WAIT_SLICE)
+        ms = SMS_RECORD_WAIT_SLICE;
+    sms_record_ready_waiting = 1;
+    EVENT_BARRIER();
+    if (sms_record_tail == sms_record_head)
+        OS_WaitForSemaphore(sms_record_ready_sem, ms);
+    sms_record_ready_waiting = 0;
+    MICROPY_EVENT_POLL_HOOK
+}
+
+STATIC void modcellular_sms_records_reset(void) {
+    // Drops records left from an earlier listing
+    if (!sms_record_room_sem) {
+        sms_record_room_sem = OS_CreateSemaphore(0);
+        sms_record_ready_sem = OS_CreateSemaphore(0);
+    }
+    sms_record_touched = mp_hal_ticks_ms();
+    sms_record_tail = sms_record_head;
+    sms_list_seen = 0;
+}
+
+STATIC void modcellular_sms_list_take(void) {
+    // Moves listed records into the list buffer
+    modcellular_event_t *record;
+    while ((record = modcellular_sms_record_peek()) != NULL) {
+        mp_obj_list_t *list = MP_STATE_PORT(cellular_sms_list);
+        if (list && (list->len > sms_list_buffer_count)) {
+            list->items[sms_list_buffer_count] = modcellular_sms_from_event(record);
+            sms_list_buffer_count ++;
+        } else {
+            network_exception = NTW_EXC_SMS_DROP;
+        }
+        modcellular_sms_record_release();
+    }
+}
 
+STATIC uint32_t modcellular_sms_list_start(void) {
+    // Requests all messages; returns the number expected
     SMS_Storage_Info_t storage;
     SMS_GetStorageInfo(&storage, SMS_STORAGE_SIM_CARD);
-    
-    sms_list_buffer = mp_obj_new_list(storage.used, NULL);
+
+    MP_STATE_PORT(cellular_sms_list) = mp_obj_new_list(storage.used, NULL);
     sms_list_buffer_count = 0;
+    sms_iter_active = 0;
+    modcellular_sms_records_reset();
 
+    // A send that failed may have left the other format on
+    modcellular_sms_set_format(sms_pdu_mode);
     SMS_ListMessageRequst(SMS_STATUS_ALL, SMS_STORAGE_SIM_CARD);
-    WAIT_UNTIL(sms_list_buffer_count == storage.used, TIMEOUT_SMS_LIST, 100, mp_warning(NULL, "Failed to poll all SMS: the list may be incomplete"));
+    return storage.used;
+}
+
+STATIC bool modcellular_sms_list_complete(uint32_t expected) {
+    // Records are counted after they are queued: checking the count before
+    // taking them guarantees that all of them reach the list
+    bool complete = sms_list_seen == expected;
+    modcellular_sms_list_take();
+    return complete;
+}
+
+STATIC bool modcellular_sms_list_ready(modcellular_op_t *op) {
+    return modcellular_sms_list_complete(op->arg);
+}
+
+STATIC mp_obj_t modcellular_sms_list_finish(modcellular_op_t *op) {
+    modcellular_sms_list_take();
+    mp_obj_list_t *result = MP_STATE_PORT(cellular_sms_list);
+    MP_STATE_PORT(cellular_sms_list) = NULL;
+    modcellular_sms_record_room_wake();
 
-    mp_obj_list_t *result = sms_list_buffer;
-    sms_list_buffer = NULL;
-    
     uint16_t i;
     for (i = sms_list_buffer_count; i < result->len; i++) {
         result->items[i] = mp_const_none;
@@ -565,9 +1950,220 @@ STATIC mp_obj_t modcellular_sms_list(void) {
     return (mp_obj_t)result;
 }
 
+STATIC mp_obj_t modcellular_sms_list(void) {
+    // ========================================
+    // Lists SMS messages.
+    // Returns:
+    //     A list of SMS messages.
+    // ========================================
+    REQUIRES_NETWORK_REGISTRATION;
+
+    modcellular_op_check(OP_KIND_SMS_LIST);
+    uint32_t used = modcellular_sms_list_start();
+    modcellular_op_t *block = modcellular_op_block(OP_KIND_SMS_LIST, TIMEOUT_SMS_LIST);
+    WAIT_UNTIL(modcellular_sms_list_complete(used), TIMEOUT_SMS_LIST, 100, mp_warning(NULL, SMS_LIST_TIMEOUT_WARNING));
+    modcellular_op_unblock(block);
+
+    return modcellular_sms_list_finish(NULL);
+}
+
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_sms_list_obj, modcellular_sms_list);
 STATIC MP_DEFINE_CONST_STATICMETHOD_OBJ(modcellular_sms_list_static_class_obj, MP_ROM_PTR(&modcellular_sms_list_obj));
 
+STATIC mp_obj_t modcellular_sms_list_async(void) {
+    // ========================================
+    // Lists SMS messages without blocking.
+    // Returns:
+    //     An awaitable operation resulting in
+    //     the list of SMS messages.
+    // ========================================
+    REQUIRES_NETWORK_REGISTRATION;
+
+    modcellular_op_check(OP_KIND_SMS_LIST);
+    uint32_t used = modcellular_sms_list_start();
+    mp_obj_t op = modcellular_op_new(modcellular_sms_list_ready, modcellular_sms_list_finish, TIMEOUT_SMS_LIST, 0);
+    ((modcellular_op_t*) MP_OBJ_TO_PTR(op))->arg = used;
+    ((modcellular_op_t*) MP_OBJ_TO_PTR(op))->timeout_warning = SMS_LIST_TIMEOUT_WARNING;
+    return modcellular_op_claim(OP_KIND_SMS_LIST, op);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_sms_list_async_obj, modcellular_sms_list_async);
+STATIC MP_DEFINE_CONST_STATICMETHOD_OBJ(modcellular_sms_list_async_static_class_obj, MP_ROM_PTR(&modcellular_sms_list_async_obj));
+
+// Streaming retrieval: records stay in their ring as plain structs until
+// the iterator takes them one by one
+
+#define SMS_LIST_IDLE 2000
+#define SMS_ITER_DROP_WARNING "Some SMS were dropped while listing: iterate again to retrieve them"
+
+// Sent statuses are counted together by SMS_GetStorageInfo
+#define SMS_STATUS_SENT_ANY (SMS_STATUS_ALL & ~(SMS_STATUS_UNREAD | SMS_STATUS_READ | SMS_STATUS_UNSENT))
+
+typedef struct _modcellular_sms_iter_t {
+    mp_obj_base_t base;
+    uint32_t expected;
+    uint32_t taken;
+    uint32_t skipped;
+    uint8_t status;
+    uint32_t timeout;
+    uint32_t last;
+    uint8_t generation;
+} modcellular_sms_iter_t;
+
+STATIC mp_obj_t modcellular_sms_iter_iternext(mp_obj_t self_in) {
+    modcellular_sms_iter_t *self = MP_OBJ_TO_PTR(self_in);
+
+    while (sms_iter_active && self->generation == sms_iter_generation) {
+        // Read before taking: all records counted so far are queued
+        bool complete = sms_list_seen >= self->expected;
+
+        modcellular_event_t *record = modcellular_sms_record_peek();
+        if (record) {
+            self->last = mp_hal_ticks_ms();
+            if (!(record->status & self->status)) {
+                // Listed along with other sent statuses
+                modcellular_sms_record_release();
+                self->skipped ++;
+                continue;
+            }
+            mp_obj_t sms = modcellular_sms_from_event(record);
+            modcellular_sms_record_release();
+            self->taken ++;
+            return sms;
+        }
+
+        // Records lost by the modem would never complete the count: the
+        // listing also ends after a pause
+        uint32_t idle = mp_hal_ticks_ms() - self->last;
+        uint32_t limit = self->taken ? SMS_LIST_IDLE : self->timeout;
+        if (complete || idle > limit) {
+            sms_iter_active = 0;
+            modcellular_sms_record_room_wake();
+            if (sms_list_seen > self->taken + self->skipped)
+                mp_warning(NULL, SMS_ITER_DROP_WARNING);
+            break;
+        }
+
+        modcellular_sms_record_wait(limit - idle + 1);
+    }
+    return MP_OBJ_STOP_ITERATION;
+}
+
+STATIC mp_obj_t modcellular_sms_iter_del(mp_obj_t self_in) {
+    // Releases records held for an abandoned iterator
+    modcellular_sms_iter_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->generation == sms_iter_generation) {
+        sms_iter_active = 0;
+        modcellular_sms_record_room_wake();
+    }
+    return mp_const_none;
+}
+
+STATIC bool modcellular_sms_iter_ready(modcellular_op_t *op) {
+    // Holds OP_KIND_SMS_LIST for the iterator of generation op->arg; an
+    // abandoned one releases it TIMEOUT_SMS_LIST after it last looked for
+    // records
+    if (!sms_iter_active || op->arg != sms_iter_generation)
+        return true;
+    op->start = sms_record_touched;
+    return false;
+}
+
+STATIC mp_obj_t modcellular_sms_iter_finish(modcellular_op_t *op) {
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modcellular_sms_iter_del_obj, modcellular_sms_iter_del);
+
+STATIC const mp_rom_map_elem_t modcellular_sms_iter_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&modcellular_sms_iter_del_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(modcellular_sms_iter_locals_dict, modcellular_sms_iter_locals_dict_table);
+
+STATIC MP_DEFINE_CONST_OBJ_TYPE(
+    modcellular_sms_iter_type,
+    MP_QSTR_iterator,
+    MP_TYPE_FLAG_ITER_IS_ITERNEXT,
+    iter, modcellular_sms_iter_iternext,
+    locals_dict, &modcellular_sms_iter_locals_dict
+);
+
+STATIC mp_obj_t modcellular_sms_iter(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Iterates over SMS messages as they arrive.
+    // Only a few messages are held in memory at
+    // any time; each of them can be withdrawn
+    // during the iteration.
+    // Args:
+    //     status (int): messages to list, one of
+    //     SMS_STATUS_* constants;
+    //     timeout (int): optional timeout in ms
+    //     for the first message;
+    // Returns:
+    //     An iterator over SMS messages.
+    // ========================================
+    REQUIRES_NETWORK_REGISTRATION;
+
+    mp_int_t status = SMS_STATUS_ALL;
+    if (n_args > 0)
+        status = mp_obj_get_int(args[0]);
+    mp_int_t timeout = TIMEOUT_SMS_LIST;
+    if (n_args > 1)
+        timeout = mp_obj_get_int(args[1]);
+
+    // Listings share the record ring
+    modcellular_op_check(OP_KIND_SMS_LIST);
+
+    // The listing ends once the modem has reported as many messages as the
+    // storage holds with the requested statuses
+    SMS_Storage_Info_t storage;
+    SMS_GetStorageInfo(&storage, SMS_STORAGE_SIM_CARD);
+    uint32_t expected = storage.used;
+    if ((status & SMS_STATUS_ALL) != SMS_STATUS_ALL) {
+        expected = 0;
+        if (status & SMS_STATUS_UNREAD)
+            expected += storage.unReadRecords;
+        if (status & SMS_STATUS_READ)
+            expected += storage.readRecords;
+        if (status & SMS_STATUS_UNSENT)
+            expected += storage.unsentRecords;
+        if (status & SMS_STATUS_SENT_ANY)
+            expected += storage.sentRecords;
+    }
+
+    modcellular_sms_iter_t *self = m_new_obj_with_finaliser(modcellular_sms_iter_t);
+    self->base.type = &modcellular_sms_iter_type;
+    self->expected = expected;
+    self->taken = 0;
+    self->skipped = 0;
+    self->status = status;
+    self->timeout = timeout;
+    self->last = mp_hal_ticks_ms();
+    self->generation = ++ sms_iter_generation;
+
+    modcellular_sms_records_reset();
+    modcellular_sms_set_format(sms_pdu_mode);
+    sms_iter_active = expected > 0;
+    if (!sms_iter_active)
+        return MP_OBJ_FROM_PTR(self);
+
+    mp_int_t request = status & SMS_STATUS_SENT_ANY ? status | SMS_STATUS_SENT_ANY : status;
+    if (!SMS_ListMessageRequst(request, SMS_STORAGE_SIM_CARD)) {
+        sms_iter_active = 0;
+        mp_raise_ValueError("Failed to request SMS");
+    }
+
+    mp_obj_t op = modcellular_op_new(modcellular_sms_iter_ready, modcellular_sms_iter_finish, TIMEOUT_SMS_LIST, 0);
+    ((modcellular_op_t*) MP_OBJ_TO_PTR(op))->arg = self->generation;
+    modcellular_op_claim(OP_KIND_SMS_LIST, op);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_sms_iter_obj, 0, 2, modcellular_sms_iter);
+STATIC MP_DEFINE_CONST_STATICMETHOD_OBJ(modcellular_sms_iter_static_class_obj, MP_ROM_PTR(&modcellular_sms_iter_obj));
+
 STATIC mp_obj_t modcellular_sms_get_storage_size(void) {
     // ========================================
     // Retrieves SMS storage size.
@@ -625,12 +2221,21 @@ STATIC void modcellular_sms_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
         // .send
         } else if (attr == MP_QSTR_send) {
             mp_convert_member_lookup(self_in, mp_obj_get_type(self_in), (mp_obj_t)MP_ROM_PTR(&modcellular_sms_send_obj), dest);
+        // .send_async
+        } else if (attr == MP_QSTR_send_async) {
+            mp_convert_member_lookup(self_in, mp_obj_get_type(self_in), (mp_obj_t)MP_ROM_PTR(&modcellular_sms_send_async_obj), dest);
         // .withdraw
         } else if (attr == MP_QSTR_withdraw) {
             mp_convert_member_lookup(self_in, mp_obj_get_type(self_in), (mp_obj_t)MP_ROM_PTR(&modcellular_sms_withdraw_obj), dest);
         // .list[static]
         } else if (attr == MP_QSTR_list) {
             mp_convert_member_lookup(self_in, mp_obj_get_type(self_in), (mp_obj_t)MP_ROM_PTR(&modcellular_sms_list_static_class_obj), dest);
+        // .list_async[static]
+        } else if (attr == MP_QSTR_list_async) {
+            mp_convert_member_lookup(self_in, mp_obj_get_type(self_in), (mp_obj_t)MP_ROM_PTR(&modcellular_sms_list_async_static_class_obj), dest);
+        // .iter[static]
+        } else if (attr == MP_QSTR_iter) {
+            mp_convert_member_lookup(self_in, mp_obj_get_type(self_in), (mp_obj_t)MP_ROM_PTR(&modcellular_sms_iter_static_class_obj), dest);
         // .get_storage_size[static]
         } else if (attr == MP_QSTR_get_storage_size) {
             mp_convert_member_lookup(self_in, mp_obj_get_type(self_in), (mp_obj_t)MP_ROM_PTR(&modcellular_sms_get_storage_size_static_class_obj), dest);
@@ -657,8 +2262,11 @@ STATIC void modcellular_sms_print(const mp_print_t *print, mp_obj_t self_in, mp_
 
 STATIC const mp_rom_map_elem_t sms_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_send), MP_ROM_PTR(&modcellular_sms_send_obj) },
+    { MP_ROM_QSTR(MP_QSTR_send_async), MP_ROM_PTR(&modcellular_sms_send_async_obj) },
     { MP_ROM_QSTR(MP_QSTR_withdraw), MP_ROM_PTR(&modcellular_sms_withdraw_obj) },
     { MP_ROM_QSTR(MP_QSTR_list), MP_ROM_PTR(&modcellular_sms_list_static_class_obj) },
+    { MP_ROM_QSTR(MP_QSTR_list_async), MP_ROM_PTR(&modcellular_sms_list_async_static_class_obj) },
+    { MP_ROM_QSTR(MP_QSTR_iter), MP_ROM_PTR(&modcellular_sms_iter_static_class_obj) },
     { MP_ROM_QSTR(MP_QSTR_get_storage_size), MP_ROM_PTR(&modcellular_sms_get_storage_size_static_class_obj) },
     { MP_ROM_QSTR(MP_QSTR__withdraw_by_index), MP_ROM_PTR(&modcellular_sms__withdraw_by_index_static_class_obj) },
 };
@@ -680,54 +2288,26 @@ STATIC MP_DEFINE_CONST_OBJ_TYPE(
 // Private
 // -------
 
-STATIC mp_obj_t modcellular_sms_from_record(SMS_Message_Info_t* record) {
+STATIC mp_obj_t modcellular_sms_new(const modcellular_event_t *event, mp_obj_t message) {
     // ========================================
-    // Prepares an SMS object from the record.
+    // Prepares an SMS object from a queued event.
+    // Args:
+    //     message (str, bytes): message contents;
     // Returns:
     //     A new SMS object.
     // ========================================
     sms_obj_t *self = m_new_obj_with_finaliser(sms_obj_t);
     self->base.type = &modcellular_sms_type;
-    self->index = record->index;
-    self->purpose = (uint8_t)record->status;
-    self->pn_type = (uint8_t)record->phoneNumberType;
-    self->phone_number = mp_obj_new_str((char*)record->phoneNumber + 1, SMS_PHONE_NUMBER_MAX_LEN - 1);
-    self->message = mp_obj_new_str((char*)record->data, record->dataLen);
+    self->index = event->value;
+    self->purpose = event->status;
+    self->pn_type = event->pn_type;
+    self->phone_number = mp_obj_new_str(event->number, event->number_len);
+    self->message = message;
     return MP_OBJ_FROM_PTR(self);
 }
 
-STATIC mp_obj_t modcellular_sms_from_raw(uint8_t* header, uint32_t header_length, uint8_t* content, uint32_t content_length) {
-    // ========================================
-    // Prepares an SMS object from raw header and contents.
-    // Returns:
-    //     A new SMS object.
-    // ========================================
-
-    // TODO: This function is not tested / not used. It parses
-    // raw event data and assembles a message.
-    if (header[0] != '"') {
-        return mp_const_none;
-    }
-
-    uint32_t i;
-    for (i=1; i<header_length; i++) {
-        if (header[i] == '"') {
-            break;
-        }
-    }
-
-    if (header[i] != '"') {
-        return mp_const_none;
-    }
-
-    sms_obj_t *self = m_new_obj_with_finaliser(sms_obj_t);
-    self->base.type = &modcellular_sms_type;
-    self->index = 0;
-    self->purpose = 0;
-    self->pn_type = 0;
-    self->phone_number = mp_obj_new_str((char*)header + 1, i - 1);
-    self->message = mp_obj_new_str((char*)content, content_length);
-    return MP_OBJ_FROM_PTR(self);
+STATIC mp_obj_t modcellular_sms_from_event(const modcellular_event_t *event) {
+    return modcellular_sms_new(event, modcellular_sms_payload(event->coding, (const uint8_t*) event->text, event->text_len));
 }
 
 // -------
@@ -749,6 +2329,78 @@ STATIC mp_obj_t modcellular_get_signal_quality(void) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_get_signal_quality_obj, modcellular_get_signal_quality);
 
+#define SIGNAL_WINDOW 60000
+
+STATIC mp_obj_t modcellular_signal_stats(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Signal statistics over recent samples.
+    // Args:
+    //     window (int): the time window in ms;
+    //     rx_level (bool): use the rx level
+    //     instead of the quality;
+    // Returns:
+    //     The number of samples, min, max, mean
+    //     and the trend (the least-squares slope
+    //     per minute) of the signal; None if no
+    //     samples are available.
+    // ========================================
+    mp_int_t window = n_args > 0 ? mp_obj_get_int(args[0]) : SIGNAL_WINDOW;
+    if (window < 0)
+        mp_raise_ValueError("Window must be non-negative");
+    bool rx_level = n_args > 1 && mp_obj_is_true(args[1]);
+
+    // Samples are copied out and reduced without holding up the SDK task
+    signal_sample_t history[MICROPY_PY_CELLULAR_SIGNAL_HISTORY];
+    uint32_t total, seq;
+    do {
+        seq = signal_seq;
+        EVENT_BARRIER();
+        total = signal_history_n;
+        memcpy(history, signal_history, sizeof(history));
+        EVENT_BARRIER();
+    } while ((seq & 1) || seq != signal_seq);
+
+    uint32_t now = mp_hal_ticks_ms();
+    uint32_t count = 0;
+    uint8_t lo = 0xFF, hi = 0;
+    mp_float_t sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+
+    for (uint32_t i = 0; i < MIN(total, MICROPY_PY_CELLULAR_SIGNAL_HISTORY); i++) {
+        signal_sample_t *sample = &history[(total - 1 - i) % MICROPY_PY_CELLULAR_SIGNAL_HISTORY];
+        uint32_t age = now - sample->stamp;
+        if (age > (mp_uint_t) window)
+            break;
+        uint8_t value = rx_level ? sample->rx_level : sample->quality;
+        if (value == 99)
+            continue;  // not known
+        lo = MIN(lo, value);
+        hi = MAX(hi, value);
+        mp_float_t x = - (mp_float_t) age / 60000;
+        sum_x += x;
+        sum_y += value;
+        sum_xx += x * x;
+        sum_xy += x * value;
+        count ++;
+    }
+
+    if (!count) {
+        mp_obj_t tuple[5] = {MP_OBJ_NEW_SMALL_INT(0), mp_const_none, mp_const_none, mp_const_none, mp_const_none};
+        return mp_obj_new_tuple(5, tuple);
+    }
+
+    mp_float_t denominator = count * sum_xx - sum_x * sum_x;
+    mp_obj_t tuple[5] = {
+        mp_obj_new_int(count),
+        mp_obj_new_int(lo),
+        mp_obj_new_int(hi),
+        mp_obj_new_float(sum_y / count),
+        mp_obj_new_float(denominator > 0 ? (count * sum_xy - sum_x * sum_y) / denominator : 0),
+    };
+    return mp_obj_new_tuple(5, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_signal_stats_obj, 0, 2, modcellular_signal_stats);
+
 STATIC mp_obj_t modcellular_get_imei(void) {
     // ========================================
     // Retrieves IMEI number.
@@ -780,7 +2432,7 @@ STATIC mp_obj_t modcellular_poll_network_exception(void) {
     // ========================================
     // Raises a last network exception.
     // ========================================
-    uint8_t e = network_exception;
+    uint16_t e = network_exception;
     network_exception = NTW_NO_EXC;
 
     switch (e) {
@@ -788,7 +2440,7 @@ STATIC mp_obj_t modcellular_poll_network_exception(void) {
             break;
 
         default:
-            mp_raise_OSError(e);
+            mp_raise_CellularError(e);
             break;
 
     }
@@ -928,6 +2580,42 @@ bool __is_attached(void) {
     return false;
 }
 
+STATIC mp_obj_t modcellular_gprs_finish(modcellular_op_t *op) {
+    return mp_obj_new_bool(network_status & NTW_ACT_BIT);
+}
+
+STATIC bool modcellular_gprs_off_ready(modcellular_op_t *op) {
+    return !(network_status & NTW_ACT_BIT);
+}
+
+STATIC bool modcellular_gprs_on_ready(modcellular_op_t *op) {
+    // Stage 0: waiting for attachment, stage 1: waiting for activation
+    if (op->stage == 0) {
+        if (!__is_attached()) {
+            return false;
+        }
+        op->stage = 1;
+        op->failure = NTW_EXC_ACT_FAILED;
+        // eg left behind by the supervisor
+        if (network_exception == NTW_EXC_ACT_FAILED)
+            network_exception = NTW_NO_EXC;
+        if (!Network_StartActive(gprs_context)) {
+            op->error = NTW_EXC_ACT_FAILED;
+            return true;
+        }
+    }
+    return network_status & NTW_ACT_BIT;
+}
+
+STATIC void modcellular_gprs_set_context(const mp_obj_t *args) {
+    const char* c_apn = mp_obj_str_get_str(args[0]);
+    const char* c_user = mp_obj_str_get_str(args[1]);
+    const char* c_pass = mp_obj_str_get_str(args[2]);
+    memcpy(gprs_context.apn, c_apn, MIN(strlen(c_apn) + 1, sizeof(gprs_context.apn)));
+    memcpy(gprs_context.userName, c_user, MIN(strlen(c_user) + 1, sizeof(gprs_context.userName)));
+    memcpy(gprs_context.userPasswd, c_pass, MIN(strlen(c_pass) + 1, sizeof(gprs_context.userPasswd)));
+}
+
 STATIC mp_obj_t modcellular_gprs(size_t n_args, const mp_obj_t *args) {
     // ========================================
     // Polls and switches GPRS status.
@@ -953,37 +2641,41 @@ STATIC mp_obj_t modcellular_gprs(size_t n_args, const mp_obj_t *args) {
         mp_int_t timeout = TIMEOUT_GPRS_ACTIVATION;
         if (n_args == 2) timeout = mp_obj_get_int(args[1]);
 
+        modcellular_op_check(OP_KIND_GPRS);
+        modcellular_supervisor_stop();
         if (network_status & NTW_ACT_BIT) {
             if (!Network_StartDeactive(1)) {
                 mp_raise_RuntimeError("Cannot initiate context deactivation");
                 return mp_const_none;
             }
+            modcellular_op_t *block = modcellular_op_block(OP_KIND_GPRS, timeout);
             WAIT_UNTIL(!(network_status & NTW_ACT_BIT), timeout, 100, mp_raise_OSError(MP_ETIMEDOUT));
+            modcellular_op_unblock(block);
         }
 
     } else if (n_args == 3 || n_args == 4) {
-        const char* c_apn = mp_obj_str_get_str(args[0]);
-        const char* c_user = mp_obj_str_get_str(args[1]);
-        const char* c_pass = mp_obj_str_get_str(args[2]);
         mp_int_t timeout = TIMEOUT_GPRS_ACTIVATION;
         if (n_args == 4) timeout = mp_obj_get_int(args[3]);
 
+        // The link is managed by hand from now on
+        modcellular_op_check(OP_KIND_GPRS);
+        modcellular_supervisor_stop();
         if (network_status & NTW_ACT_BIT) {
             mp_raise_ValueError("GPRS is already on");
             return mp_const_none;
         }
-        WAIT_UNTIL(__is_attached(), TIMEOUT_GPRS_ATTACHMENT, 100, mp_raise_RuntimeError("Network is not attached: try resetting"));
+        modcellular_gprs_set_context(args);
+        modcellular_op_t *block = modcellular_op_block(OP_KIND_GPRS, TIMEOUT_GPRS_ATTACHMENT + timeout);
+        WAIT_UNTIL(__is_attached(), TIMEOUT_GPRS_ATTACHMENT, 100, {modcellular_op_unblock(block); mp_raise_RuntimeError("Network is not attached: try resetting");});
 
         if (!(network_status & NTW_ACT_BIT)) {
-            Network_PDP_Context_t context;
-            memcpy(context.apn, c_apn, MIN(strlen(c_apn) + 1, sizeof(context.apn)));
-            memcpy(context.userName, c_user, MIN(strlen(c_user) + 1, sizeof(context.userName)));
-            memcpy(context.userPasswd, c_pass, MIN(strlen(c_pass) + 1, sizeof(context.userPasswd)));
-
-            if (!Network_StartActive(context))
+            if (!Network_StartActive(gprs_context)) {
+                modcellular_op_unblock(block);
                 mp_raise_RuntimeError("Cannot initiate context activation");
-            WAIT_UNTIL(network_status & NTW_ACT_BIT, timeout, 100, mp_raise_OSError(MP_ETIMEDOUT));
+            }
+            WAIT_UNTIL(network_status & NTW_ACT_BIT, timeout, 100, {modcellular_op_unblock(block); mp_raise_OSError(MP_ETIMEDOUT);});
         }
+        modcellular_op_unblock(block);
 
     } else if (n_args != 0) {
         mp_raise_ValueError("Unexpected number of argument: 0, 1 or 3 required");
@@ -994,17 +2686,159 @@ STATIC mp_obj_t modcellular_gprs(size_t n_args, const mp_obj_t *args) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_gprs_obj, 0, 4, modcellular_gprs);
 
-STATIC mp_obj_t modcellular_scan(void) {
+STATIC mp_obj_t modcellular_gprs_async(size_t n_args, const mp_obj_t *args) {
     // ========================================
-    // Lists network operators.
+    // Switches GPRS status without blocking.
+    // Args:
+    //     apn (str, bool): access point name
+    //     or False if GPRS shutdown requested.
+    //     user (str): username;
+    //     pass (str): password;
+    //     timeout (int): time to wait until
+    //     connected;
+    // Returns:
+    //     An awaitable operation resulting in
+    //     True if GPRS is active.
+    // ========================================
+    REQUIRES_NETWORK_REGISTRATION;
+
+    if (n_args == 1 || n_args == 2) {
+        if (mp_obj_get_int(args[0]) != 0) {
+            mp_raise_ValueError("Unkown integer argument supplied, zero (or False) expected");
+            return mp_const_none;
+        }
+        mp_int_t timeout = TIMEOUT_GPRS_ACTIVATION;
+        if (n_args == 2) timeout = mp_obj_get_int(args[1]);
+
+        modcellular_op_check(OP_KIND_GPRS);
+        modcellular_supervisor_stop();
+        if ((network_status & NTW_ACT_BIT) && !Network_StartDeactive(1)) {
+            mp_raise_RuntimeError("Cannot initiate context deactivation");
+            return mp_const_none;
+        }
+        return modcellular_op_claim(OP_KIND_GPRS, modcellular_op_new(modcellular_gprs_off_ready, modcellular_gprs_finish, timeout, 0));
+
+    } else if (n_args == 3 || n_args == 4) {
+        mp_int_t timeout = TIMEOUT_GPRS_ACTIVATION;
+        if (n_args == 4) timeout = mp_obj_get_int(args[3]);
+
+        // The link is managed by hand from now on
+        modcellular_op_check(OP_KIND_GPRS);
+        modcellular_supervisor_stop();
+        if (network_status & NTW_ACT_BIT) {
+            mp_raise_ValueError("GPRS is already on");
+            return mp_const_none;
+        }
+        modcellular_gprs_set_context(args);
+        // Activation starts from ready() once attached
+        return modcellular_op_claim(OP_KIND_GPRS, modcellular_op_new(modcellular_gprs_on_ready, modcellular_gprs_finish, TIMEOUT_GPRS_ATTACHMENT + timeout, NTW_EXC_ATT_FAILED));
+    }
+
+    mp_raise_ValueError("Unexpected number of argument: 1 or 3 required");
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_gprs_async_obj, 1, 4, modcellular_gprs_async);
+
+STATIC mp_obj_t modcellular_gprs_supervise(size_t n_args, const mp_obj_t *args) {
     // ========================================
+    // Keeps GPRS connected in the background.
+    // Args:
+    //     apn (str, bool): access point name
+    //     or False to stop supervising.
+    //     user (str): username;
+    //     pass (str): password;
+    //     backoff_min (int): the delay in ms
+    //     before the first reconnect attempt;
+    //     backoff_max (int): the maximal delay
+    //     between attempts;
+    // ========================================
+    if (n_args == 1) {
+        if (mp_obj_get_int(args[0]) != 0) {
+            mp_raise_ValueError("Unkown integer argument supplied, zero (or False) expected");
+            return mp_const_none;
+        }
+        modcellular_supervisor_stop();
+        return mp_const_none;
+    }
+    if (n_args < 3) {
+        mp_raise_ValueError("Unexpected number of argument: 1 or 3 required");
+        return mp_const_none;
+    }
+
+    mp_int_t backoff_min = n_args > 3 ? mp_obj_get_int(args[3]) : SUPERVISOR_BACKOFF_MIN;
+    mp_int_t backoff_max = n_args > 4 ? mp_obj_get_int(args[4]) : SUPERVISOR_BACKOFF_MAX;
+    if (backoff_min <= 0 || backoff_max < backoff_min) {
+        mp_raise_ValueError("Invalid backoff: 0 < backoff_min <= backoff_max expected");
+        return mp_const_none;
+    }
+
+    modcellular_op_check(OP_KIND_GPRS);
+    modcellular_supervisor_stop();
+    modcellular_gprs_set_context(args);
+    supervisor.backoff_min = backoff_min;
+    supervisor.backoff_max = backoff_max;
+    supervisor.backoff = backoff_min;
+    supervisor.up_total = 0;
+    supervisor.down_since = 0;
+    supervisor.outages = 0;
+    supervisor.outage_total = 0;
+    supervisor.attempts = 0;
+
+    if (network_status & NTW_ACT_BIT) {
+        modcellular_supervisor_enter(SUPERVISOR_UP);
+    } else {
+        // The first attempt is made from the SDK task right away
+        supervisor.down_since = mp_hal_ticks_ms();
+        modcellular_supervisor_enter(SUPERVISOR_BACKOFF);
+        modcellular_supervisor_arm(1);
+    }
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_gprs_supervise_obj, 1, 5, modcellular_gprs_supervise);
+
+STATIC mp_obj_t modcellular_gprs_supervisor_stats(void) {
+    // ========================================
+    // Reports the GPRS supervisor state.
+    // Returns:
+    //     A tuple with the state, the duration
+    //     of the current session, the total time
+    //     connected, the number of outages, their
+    //     total duration (all in ms), the number
+    //     of connection attempts and the current
+    //     backoff delay in ms.
+    // ========================================
+    uint32_t now = mp_hal_ticks_ms();
+    uint8_t state = supervisor.state;
+    uint32_t session = state == SUPERVISOR_UP ? now - supervisor.since : 0;
+    uint32_t outage = supervisor.down_since ? now - supervisor.down_since : 0;
+    mp_obj_t tuple[7] = {
+        mp_obj_new_int(state),
+        mp_obj_new_int_from_uint(session),
+        mp_obj_new_int_from_uint(supervisor.up_total + session),
+        mp_obj_new_int_from_uint(supervisor.outages),
+        mp_obj_new_int_from_uint(supervisor.outage_total + outage),
+        mp_obj_new_int_from_uint(supervisor.attempts),
+        mp_obj_new_int_from_uint(supervisor.backoff),
+    };
+    return mp_obj_new_tuple(7, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_gprs_supervisor_stats_obj, modcellular_gprs_supervisor_stats);
+
+STATIC void modcellular_scan_start(void) {
     network_list_buffer = NULL;
     if (!Network_GetAvailableOperatorReq()) {
         mp_raise_RuntimeError("Failed to poll available operators");
-        return mp_const_none;
     }
-    WAIT_UNTIL(network_list_buffer != NULL, TIMEOUT_LIST_OPERATORS, 100, mp_raise_OSError(MP_ETIMEDOUT));
+}
 
+STATIC bool modcellular_scan_ready(modcellular_op_t *op) {
+    return network_list_buffer != NULL;
+}
+
+STATIC mp_obj_t modcellular_scan_finish(modcellular_op_t *op) {
     mp_obj_t items[network_list_buffer_len];
     for (int i=0; i < network_list_buffer_len; i++) {
 
@@ -1024,55 +2858,41 @@ STATIC mp_obj_t modcellular_scan(void) {
     }
 
     free(network_list_buffer);
+    network_list_buffer = NULL;
 
     return mp_obj_new_list(sizeof(items) / sizeof(mp_obj_t), items);
 }
 
-STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_scan_obj, modcellular_scan);
-
-STATIC mp_obj_t modcellular_register(size_t n_args, const mp_obj_t *args) {
+STATIC mp_obj_t modcellular_scan(void) {
     // ========================================
     // Lists network operators.
     // ========================================
-    if (n_args == 1) {
-        mp_int_t flag = mp_obj_get_int(args[0]);
-        if (flag != 0) {
-            mp_raise_ValueError("Unkown integer argument supplied, zero (or False) expected");
-            return mp_const_none;
-        }
-
-        if (!Network_DeRegister()) {
-            mp_raise_RuntimeError("Failed to request deregistration");
-            return mp_const_none;
-        }
-        WAIT_UNTIL(!(network_status & NTW_REG_BIT), TIMEOUT_REG, 100, mp_raise_OSError(MP_ETIMEDOUT));
-        return mp_const_none;
-    } else if (n_args == 2) {
-        mp_obj_array_t *op_id = MP_OBJ_TO_PTR(args[0]);
-        mp_int_t op_mode = mp_obj_get_int(args[1]);
-
-        if (op_id->base.type != &mp_type_bytearray) {
-            mp_raise_ValueError("A bytearray expected");
-            return mp_const_none;
-        }
+    modcellular_op_check(OP_KIND_SCAN);
+    modcellular_scan_start();
+    modcellular_op_t *block = modcellular_op_block(OP_KIND_SCAN, TIMEOUT_LIST_OPERATORS);
+    WAIT_UNTIL(network_list_buffer != NULL, TIMEOUT_LIST_OPERATORS, 100, mp_raise_OSError(MP_ETIMEDOUT));
+    modcellular_op_unblock(block);
+    return modcellular_scan_finish(NULL);
+}
 
-        if (op_id->len != 6) {
-            mp_raise_ValueError("The length of the input bytearray should be 6");
-            return mp_const_none;
-        }
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_scan_obj, modcellular_scan);
 
-        if (op_mode != NETWORK_REGISTER_MODE_MANUAL && op_mode != NETWORK_REGISTER_MODE_AUTO && op_mode != NETWORK_REGISTER_MODE_MANUAL_AUTO) {
-            mp_raise_ValueError("The mode should be one of NETWORK_REGISTER_MODE_*");
-            return mp_const_none;
-        }
+STATIC mp_obj_t modcellular_scan_async(void) {
+    // ========================================
+    // Lists network operators without blocking.
+    // Returns:
+    //     An awaitable operation resulting in
+    //     the list of operators.
+    // ========================================
+    modcellular_op_check(OP_KIND_SCAN);
+    modcellular_scan_start();
+    return modcellular_op_claim(OP_KIND_SCAN, modcellular_op_new(modcellular_scan_ready, modcellular_scan_finish, TIMEOUT_LIST_OPERATORS, 0));
+}
 
-        if (!Network_Register((uint8_t*) op_id->items, (Network_Register_Mode_t) op_mode)) {
-            mp_raise_RuntimeError("Failed to request network registration");
-            return mp_const_none;
-        }
-        WAIT_UNTIL(network_status & NTW_REG_BIT, TIMEOUT_REG, 100, mp_raise_OSError(MP_ETIMEDOUT));
-    }
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_scan_async_obj, modcellular_scan_async);
 
+STATIC mp_obj_t modcellular_register_finish(modcellular_op_t *op) {
+    // The current operator
     uint8_t op_id[6];
     Network_Register_Mode_t op_mode;
 
@@ -1096,8 +2916,96 @@ STATIC mp_obj_t modcellular_register(size_t n_args, const mp_obj_t *args) {
     return mp_obj_new_tuple(sizeof(tuple) / sizeof(mp_obj_t), tuple);
 }
 
+STATIC mp_obj_t modcellular_deregister_finish(modcellular_op_t *op) {
+    return mp_const_none;
+}
+
+STATIC bool modcellular_register_ready(modcellular_op_t *op) {
+    return network_status & NTW_REG_BIT;
+}
+
+STATIC bool modcellular_deregister_ready(modcellular_op_t *op) {
+    return !(network_status & NTW_REG_BIT);
+}
+
+STATIC bool modcellular_register_start(size_t n_args, const mp_obj_t *args) {
+    // Requests (de)registration; true if registration was requested
+    if (n_args == 1) {
+        mp_int_t flag = mp_obj_get_int(args[0]);
+        if (flag != 0) {
+            mp_raise_ValueError("Unkown integer argument supplied, zero (or False) expected");
+        }
+
+        if (!Network_DeRegister()) {
+            mp_raise_RuntimeError("Failed to request deregistration");
+        }
+        return false;
+    }
+
+    mp_obj_array_t *op_id = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t op_mode = mp_obj_get_int(args[1]);
+
+    if (op_id->base.type != &mp_type_bytearray) {
+        mp_raise_ValueError("A bytearray expected");
+    }
+
+    if (op_id->len != 6) {
+        mp_raise_ValueError("The length of the input bytearray should be 6");
+    }
+
+    if (op_mode != NETWORK_REGISTER_MODE_MANUAL && op_mode != NETWORK_REGISTER_MODE_AUTO && op_mode != NETWORK_REGISTER_MODE_MANUAL_AUTO) {
+        mp_raise_ValueError("The mode should be one of NETWORK_REGISTER_MODE_*");
+    }
+
+    if (!Network_Register((uint8_t*) op_id->items, (Network_Register_Mode_t) op_mode)) {
+        mp_raise_RuntimeError("Failed to request network registration");
+    }
+    return true;
+}
+
+STATIC mp_obj_t modcellular_register(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Lists network operators.
+    // ========================================
+    if (n_args > 0) {
+        modcellular_op_check(OP_KIND_REGISTER);
+        bool registering = modcellular_register_start(n_args, args);
+        modcellular_op_t *block = modcellular_op_block(OP_KIND_REGISTER, TIMEOUT_REG);
+        if (registering) {
+            WAIT_UNTIL(network_status & NTW_REG_BIT, TIMEOUT_REG, 100, mp_raise_OSError(MP_ETIMEDOUT));
+            modcellular_op_unblock(block);
+        } else {
+            WAIT_UNTIL(!(network_status & NTW_REG_BIT), TIMEOUT_REG, 100, mp_raise_OSError(MP_ETIMEDOUT));
+            modcellular_op_unblock(block);
+            return mp_const_none;
+        }
+    }
+    return modcellular_register_finish(NULL);
+}
+
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_register_obj, 0, 2, modcellular_register);
 
+STATIC mp_obj_t modcellular_register_async(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Registers on the network (or deregisters)
+    // without blocking.
+    // Args:
+    //     op_id (bytearray, bool): operator ID
+    //     or False to deregister;
+    //     mode (int): registration mode;
+    // Returns:
+    //     An awaitable operation resulting in
+    //     the current operator.
+    // ========================================
+    modcellular_op_check(OP_KIND_REGISTER);
+    if (modcellular_register_start(n_args, args)) {
+        return modcellular_op_claim(OP_KIND_REGISTER, modcellular_op_new(modcellular_register_ready, modcellular_register_finish, TIMEOUT_REG, NTW_EXC_REG_DENIED));
+    }
+    return modcellular_op_claim(OP_KIND_REGISTER, modcellular_op_new(modcellular_deregister_ready, modcellular_deregister_finish, TIMEOUT_REG, 0));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_register_async_obj, 1, 2, modcellular_register_async);
+
 STATIC mp_obj_t modcellular_dial(mp_obj_t tn_in) {
     // ========================================
     // Dial a number.
@@ -1125,6 +3033,33 @@ STATIC mp_obj_t modcellular_dial(mp_obj_t tn_in) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(modcellular_dial_obj, modcellular_dial);
 
+STATIC void modcellular_ussd_start(mp_obj_t code_in) {
+    const char* code = mp_obj_str_get_str(code_in);
+    uint8_t code7[2 * strlen(code) + 1];
+    int len = GSM_8BitTo7Bit((const uint8_t*) code, code7, strlen(code));
+
+    USSD_Type_t ussd;
+    ussd.usdString = (uint8_t*) code7;
+    ussd.usdStringSize = len;
+    ussd.option = 3;
+    ussd.dcs = 0x0F;
+
+    ussd_send_flag = 0;
+    int result = SS_SendUSSD(ussd);
+    if (result)
+        mp_raise_ValueError("Failed to submit USSD");
+}
+
+STATIC bool modcellular_ussd_ready(modcellular_op_t *op) {
+    return ussd_send_flag;
+}
+
+STATIC mp_obj_t modcellular_ussd_finish(modcellular_op_t *op) {
+    mp_obj_t rtn = ussd_send_flag ? modcellular_ussd_from_event(&ussd_response) : mp_const_none;
+    ussd_send_flag = 0;
+    return rtn;
+}
+
 STATIC mp_obj_t modcellular_ussd(size_t n_args, const mp_obj_t *args) {
     // ========================================
     // USSD request.
@@ -1140,92 +3075,197 @@ STATIC mp_obj_t modcellular_ussd(size_t n_args, const mp_obj_t *args) {
     if (n_args == 2)
         timeout = mp_obj_get_int(args[1]);
 
-    const char* code = mp_obj_str_get_str(args[0]);
-    uint8_t code7[2 * strlen(code) + 1];
-    int len = GSM_8BitTo7Bit((const uint8_t*) code, code7, strlen(code));
-
-    USSD_Type_t ussd;
-    ussd.usdString = (uint8_t*) code7;
-    ussd.usdStringSize = len;
-    ussd.option = 3;
-    ussd.dcs = 0x0F;
-
-    ussd_send_flag = 0;
-    ussd_response = mp_const_none;
-    int result = SS_SendUSSD(ussd);
-    if (result)
-        mp_raise_ValueError("Failed to submit USSD");
+    modcellular_op_check(OP_KIND_USSD);
+    modcellular_ussd_start(args[0]);
+    modcellular_op_t *block = modcellular_op_block(OP_KIND_USSD, timeout);
 
     if (timeout == 0)
         return mp_const_none;
 
     WAIT_UNTIL(ussd_send_flag, timeout, 100, mp_raise_OSError(MP_ETIMEDOUT));
-    mp_obj_t rtn = ussd_response;
-    ussd_send_flag = 0;
-    ussd_response = 0;
-    return rtn;
+    modcellular_op_unblock(block);
+    return modcellular_ussd_finish(NULL);
 }
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_ussd_obj, 1, 2, modcellular_ussd);
 
-STATIC mp_obj_t modcellular_stations(void) {
+STATIC mp_obj_t modcellular_ussd_async(size_t n_args, const mp_obj_t *args) {
     // ========================================
-    // Polls base stations.
+    // USSD request without blocking.
+    // Args:
+    //     code (str): the request;
+    //     timeout (int, optional): timeout in ms;
+    // Returns:
+    //     An awaitable operation resulting in
+    //     the USSD response.
     // ========================================
-    cells_n = -1;
+    REQUIRES_NETWORK_REGISTRATION;
+
+    mp_int_t timeout = TIMEOUT_USSD_RESPONSE;
+    if (n_args == 2)
+        timeout = mp_obj_get_int(args[1]);
+
+    modcellular_op_check(OP_KIND_USSD);
+    modcellular_ussd_start(args[0]);
+    return modcellular_op_claim(OP_KIND_USSD, modcellular_op_new(modcellular_ussd_ready, modcellular_ussd_finish, timeout, NTW_EXC_USSD_SEND));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_ussd_async_obj, 1, 2, modcellular_ussd_async);
+
+#define STATIONS_MAX_AGE 5000
+
+STATIC int modcellular_stations_snapshot(Network_Location_t *dest, uint32_t *stamp) {
+    // Copies the last snapshot out; returns the number of stations
+    uint32_t seq;
+    int n;
+    do {
+        seq = cells_seq;
+        EVENT_BARRIER();
+        n = cells_n;
+        memcpy(dest, cells, n * sizeof(Network_Location_t));
+        *stamp = cells_stamp;
+        EVENT_BARRIER();
+    } while ((seq & 1) || seq != cells_seq);
+    return n;
+}
+
+STATIC void modcellular_stations_start(void) {
+    cells_pending = 1;
     if (!Network_GetCellInfoRequst()) {
+        cells_pending = 0;
         mp_raise_RuntimeError("Failed to poll base stations");
-        return mp_const_none;
     }
-    WAIT_UNTIL(cells_n >= 0, TIMEOUT_STATIONS, 100, mp_raise_OSError(MP_ETIMEDOUT));
+}
+
+STATIC bool modcellular_stations_ready(modcellular_op_t *op) {
+    return !cells_pending;
+}
+
+STATIC int modcellular_stations_refresh(mp_int_t max_age, Network_Location_t *dest, uint32_t *stamp) {
+    // Returns the snapshot, polling stations if it is older than max_age;
+    // negative max_age polls unconditionally
+    int n = modcellular_stations_snapshot(dest, stamp);
+    if (max_age < 0 || !cells_seq || mp_hal_ticks_ms() - *stamp > (mp_uint_t) max_age) {
+        modcellular_op_check(OP_KIND_STATIONS);
+        modcellular_stations_start();
+        modcellular_op_t *block = modcellular_op_block(OP_KIND_STATIONS, TIMEOUT_STATIONS);
+        WAIT_UNTIL(!cells_pending, TIMEOUT_STATIONS, 100, mp_raise_OSError(MP_ETIMEDOUT));
+        modcellular_op_unblock(block);
+        n = modcellular_stations_snapshot(dest, stamp);
+    }
+    return n;
+}
 
-    mp_obj_t stations[cells_n];
-    for (int i=0; i<cells_n; i++) {
+STATIC mp_obj_t modcellular_stations_tuple(const Network_Location_t *src, int n) {
+    mp_obj_t stations[n];
+    for (int i=0; i<n; i++) {
         mp_obj_t tuple[8] = {
-            mp_obj_new_int(MCC(cells[i].sMcc)),
-            mp_obj_new_int(MNC(cells[i].sMnc)),
-            mp_obj_new_int(cells[i].sLac),
-            mp_obj_new_int(cells[i].sCellID),
-            mp_obj_new_int(cells[i].iBsic),
-            mp_obj_new_int(cells[i].iRxLev),
-            mp_obj_new_int(cells[i].iRxLevSub),
-            mp_obj_new_int(cells[i].nArfcn),
+            mp_obj_new_int(MCC(src[i].sMcc)),
+            mp_obj_new_int(MNC(src[i].sMnc)),
+            mp_obj_new_int(src[i].sLac),
+            mp_obj_new_int(src[i].sCellID),
+            mp_obj_new_int(src[i].iBsic),
+            mp_obj_new_int(src[i].iRxLev),
+            mp_obj_new_int(src[i].iRxLevSub),
+            mp_obj_new_int(src[i].nArfcn),
         };
         stations[i] = mp_obj_new_tuple(sizeof(tuple) / sizeof(mp_obj_t), tuple);
     }
-    return mp_obj_new_tuple(sizeof(stations) / sizeof(mp_obj_t), stations);
+    return mp_obj_new_tuple(n, stations);
 }
 
-STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_stations_obj, modcellular_stations);
+STATIC mp_obj_t modcellular_stations_finish(modcellular_op_t *op) {
+    Network_Location_t snapshot[MAX_CELLS];
+    uint32_t stamp;
+    int n = modcellular_stations_snapshot(snapshot, &stamp);
+    return modcellular_stations_tuple(snapshot, n);
+}
 
-STATIC mp_obj_t modcellular_agps_station_data(void) {
+STATIC mp_obj_t modcellular_stations(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Polls base stations.
+    // Args:
+    //     max_age (int): optional age in ms of
+    //     the last poll results that are still
+    //     returned without polling again;
+    // ========================================
+    Network_Location_t snapshot[MAX_CELLS];
+    uint32_t stamp;
+    int n = modcellular_stations_refresh(n_args ? mp_obj_get_int(args[0]) : -1, snapshot, &stamp);
+    return modcellular_stations_tuple(snapshot, n);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_stations_obj, 0, 1, modcellular_stations);
+
+STATIC mp_obj_t modcellular_stations_async(void) {
+    // ========================================
+    // Polls base stations without blocking.
+    // Returns:
+    //     An awaitable operation resulting in
+    //     base station records.
+    // ========================================
+    modcellular_op_check(OP_KIND_STATIONS);
+    modcellular_stations_start();
+    return modcellular_op_claim(OP_KIND_STATIONS, modcellular_op_new(modcellular_stations_ready, modcellular_stations_finish, TIMEOUT_STATIONS, 0));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_stations_async_obj, modcellular_stations_async);
+
+STATIC mp_obj_t modcellular_station_records(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Base stations as packed records.
+    // Args:
+    //     max_age (int): age in ms of the last
+    //     poll results that are still returned
+    //     without polling again;
+    // Returns:
+    //     A bytes object with STATION_RECORD_SIZE
+    //     bytes per station and the age of the
+    //     data in ms.
+    // ========================================
+    Network_Location_t snapshot[MAX_CELLS];
+    uint32_t stamp;
+    int n = modcellular_stations_refresh(n_args ? mp_obj_get_int(args[0]) : STATIONS_MAX_AGE, snapshot, &stamp);
+
+    uint8_t records[MAX_CELLS * STATION_RECORD_SIZE];
+    mp_obj_t tuple[2] = {
+        mp_obj_new_bytes(records, modcellular_cells_pack(snapshot, n, records)),
+        mp_obj_new_int_from_uint(mp_hal_ticks_ms() - stamp),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_station_records_obj, 0, 1, modcellular_station_records);
+
+STATIC mp_obj_t modcellular_agps_station_data(size_t n_args, const mp_obj_t *args) {
     // ========================================
     // Polls base stations and returns mcc, mnc
     // and a list of lac, cell_id, signal level
     // for each base station.
+    // Args:
+    //     max_age (int): optional age in ms of
+    //     the last poll results that are still
+    //     returned without polling again;
     // ========================================
-    cells_n = -1;
-    if (!Network_GetCellInfoRequst()) {
-        mp_raise_RuntimeError("Failed to poll base stations");
-        return mp_const_none;
-    }
-    WAIT_UNTIL(cells_n >= 0, TIMEOUT_STATIONS, 100, mp_raise_OSError(MP_ETIMEDOUT));
+    Network_Location_t snapshot[MAX_CELLS];
+    uint32_t stamp;
+    int n = modcellular_stations_refresh(n_args ? mp_obj_get_int(args[0]) : -1, snapshot, &stamp);
 
-    if (cells_n == 0) {
+    if (n == 0) {
         mp_raise_RuntimeError("No station data available");
         return mp_const_none;
     }
 
     // just return the first mcc/mnc in the list
-    int mcc = MCC(cells[0].sMcc);
-    int mnc = MNC(cells[0].sMnc);
+    int mcc = MCC(snapshot[0].sMcc);
+    int mnc = MNC(snapshot[0].sMnc);
     mp_obj_t list = mp_obj_new_list(0, NULL);
-    for (int i=0; i<cells_n; i++) {
-        if (MCC(cells[i].sMcc) == mcc && MNC(cells[i].sMnc) == mnc) {
+    for (int i=0; i<n; i++) {
+        if (MCC(snapshot[i].sMcc) == mcc && MNC(snapshot[i].sMnc) == mnc) {
             mp_obj_t tuple[3] = {
-                mp_obj_new_int(cells[i].sLac),
-                mp_obj_new_int(cells[i].sCellID),
-                mp_obj_new_int(cells[i].iRxLev),
+                mp_obj_new_int(snapshot[i].sLac),
+                mp_obj_new_int(snapshot[i].sCellID),
+                mp_obj_new_int(snapshot[i].iRxLev),
             };
             mp_obj_list_append(list, mp_obj_new_tuple(sizeof(tuple) / sizeof(mp_obj_t), tuple));
         }
@@ -1238,7 +3278,7 @@ STATIC mp_obj_t modcellular_agps_station_data(void) {
     return mp_obj_new_tuple(3, tuple);
 }
 
-STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_agps_station_data_obj, modcellular_agps_station_data);
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_agps_station_data_obj, 0, 1, modcellular_agps_station_data);
 
 STATIC mp_obj_t modcellular_reset(void) {
     // ========================================
@@ -1250,6 +3290,28 @@ STATIC mp_obj_t modcellular_reset(void) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(modcellular_reset_obj, modcellular_reset);
 
+STATIC mp_obj_t modcellular_sms_pdu_mode(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Switches SMS receiving and listing to
+    // PDU mode: binary messages are reported
+    // as bytes and concatenated messages are
+    // put together before being reported.
+    // Args:
+    //     enable (bool): PDU mode on or off;
+    // Returns:
+    //     True if PDU mode is on.
+    // ========================================
+    if (n_args == 1) {
+        uint8_t enable = mp_obj_is_true(args[0]);
+        if (!modcellular_sms_set_format(enable))
+            mp_raise_RuntimeError("Failed to set SMS format");
+        sms_pdu_mode = enable;
+    }
+    return mp_obj_new_bool(sms_pdu_mode);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_sms_pdu_mode_obj, 0, 1, modcellular_sms_pdu_mode);
+
 STATIC mp_obj_t modcellular_on_status_event(mp_obj_t callable) {
     // ========================================
     // Sets a callback on status event.
@@ -1302,13 +3364,72 @@ STATIC mp_obj_t modcellular_on_ussd(mp_obj_t callable) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(modcellular_on_ussd_obj, modcellular_on_ussd);
 
+STATIC mp_obj_t modcellular_on_stations_change(mp_obj_t callable) {
+    // ========================================
+    // Sets a callback on base station changes.
+    // Args:
+    //     callback (Callable): a callback to
+    //     execute when the serving station or
+    //     the set of neighbours polled changes.
+    // ========================================
+    MP_STATE_PORT(cellular_cells_callback) = callable;
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modcellular_on_stations_change_obj, modcellular_on_stations_change);
+
+STATIC mp_obj_t modcellular_on_gprs(mp_obj_t callable) {
+    // ========================================
+    // Sets a callback on GPRS link changes.
+    // Args:
+    //     callback (Callable): a callback to
+    //     execute when the supervised link
+    //     becomes usable or is lost.
+    // ========================================
+    MP_STATE_PORT(cellular_gprs_callback) = callable;
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modcellular_on_gprs_obj, modcellular_on_gprs);
+
+STATIC mp_obj_t modcellular_event_stats(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Reports the event queue statistics.
+    // Args:
+    //     reset (bool): resets counters if True;
+    // Returns:
+    //     A tuple with the numbers of events delivered,
+    //     dropped because the queue was full, pending
+    //     and the peak queue length.
+    // ========================================
+    uint32_t dropped = event_dropped;
+    uint32_t head = event_head;
+    mp_obj_t tuple[4] = {
+        mp_obj_new_int_from_uint(event_delivered),
+        mp_obj_new_int_from_uint(dropped - event_dropped_reported),
+        mp_obj_new_int_from_uint(head - event_tail),
+        mp_obj_new_int_from_uint(event_peak),
+    };
+    if (n_args == 1 && mp_obj_is_true(args[0])) {
+        event_delivered = 0;
+        event_dropped_reported = dropped;
+        event_peak = head - event_tail;
+    }
+    return mp_obj_new_tuple(4, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modcellular_event_stats_obj, 0, 1, modcellular_event_stats);
+
 STATIC const mp_map_elem_t mp_module_cellular_globals_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR_cellular) },
 
     { MP_OBJ_NEW_QSTR(MP_QSTR_SMS), (mp_obj_t)MP_ROM_PTR(&modcellular_sms_type) },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_Operation), (mp_obj_t)MP_ROM_PTR(&modcellular_op_type) },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_CellularError), (mp_obj_t)MP_ROM_PTR(&mp_type_CellularError) },
 
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_imei), (mp_obj_t)&modcellular_get_imei_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_signal_quality), (mp_obj_t)&modcellular_get_signal_quality_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_signal_stats), (mp_obj_t)&modcellular_signal_stats_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_poll_network_exception), (mp_obj_t)&modcellular_poll_network_exception_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_network_status), (mp_obj_t)&modcellular_get_network_status_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_is_sim_present), (mp_obj_t)&modcellular_is_sim_present_obj },
@@ -1319,17 +3440,29 @@ STATIC const mp_map_elem_t mp_module_cellular_globals_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_flight_mode), (mp_obj_t)&modcellular_flight_mode_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_bands), (mp_obj_t)&modcellular_set_bands_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_gprs), (mp_obj_t)&modcellular_gprs_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_gprs_async), (mp_obj_t)&modcellular_gprs_async_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_gprs_supervise), (mp_obj_t)&modcellular_gprs_supervise_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_gprs_supervisor_stats), (mp_obj_t)&modcellular_gprs_supervisor_stats_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_scan), (mp_obj_t)&modcellular_scan_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_scan_async), (mp_obj_t)&modcellular_scan_async_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_register), (mp_obj_t)&modcellular_register_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_register_async), (mp_obj_t)&modcellular_register_async_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_dial), (mp_obj_t)&modcellular_dial_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_ussd), (mp_obj_t)&modcellular_ussd_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_ussd_async), (mp_obj_t)&modcellular_ussd_async_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_stations), (mp_obj_t)&modcellular_stations_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_stations_async), (mp_obj_t)&modcellular_stations_async_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_station_records), (mp_obj_t)&modcellular_station_records_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_agps_station_data), (mp_obj_t)&modcellular_agps_station_data_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_reset), (mp_obj_t)&modcellular_reset_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_sms_pdu_mode), (mp_obj_t)&modcellular_sms_pdu_mode_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_on_status_event), (mp_obj_t)&modcellular_on_status_event_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_on_sms), (mp_obj_t)&modcellular_on_sms_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_on_call), (mp_obj_t)&modcellular_on_call_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_on_ussd), (mp_obj_t)&modcellular_on_ussd_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_on_stations_change), (mp_obj_t)&modcellular_on_stations_change_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_on_gprs), (mp_obj_t)&modcellular_on_gprs_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_event_stats), (mp_obj_t)&modcellular_event_stats_obj },
 
     { MP_ROM_QSTR(MP_QSTR_NETWORK_FREQ_BAND_GSM_900P), MP_ROM_INT(NETWORK_FREQ_BAND_GSM_900P) },
     { MP_ROM_QSTR(MP_QSTR_NETWORK_FREQ_BAND_GSM_900E), MP_ROM_INT(NETWORK_FREQ_BAND_GSM_900E) },
@@ -1348,6 +3481,18 @@ STATIC const mp_map_elem_t mp_module_cellular_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_NETWORK_MODE_MANUAL_AUTO), MP_ROM_INT(NETWORK_REGISTER_MODE_MANUAL_AUTO) },
     
     { MP_ROM_QSTR(MP_QSTR_SMS_SENT), MP_ROM_INT(SMS_SENT) },
+    { MP_ROM_QSTR(MP_QSTR_STATION_RECORD_SIZE), MP_ROM_INT(STATION_RECORD_SIZE) },
+
+    { MP_ROM_QSTR(MP_QSTR_SUPERVISOR_OFF), MP_ROM_INT(SUPERVISOR_OFF) },
+    { MP_ROM_QSTR(MP_QSTR_SUPERVISOR_ATTACHING), MP_ROM_INT(SUPERVISOR_ATTACHING) },
+    { MP_ROM_QSTR(MP_QSTR_SUPERVISOR_ACTIVATING), MP_ROM_INT(SUPERVISOR_ACTIVATING) },
+    { MP_ROM_QSTR(MP_QSTR_SUPERVISOR_UP), MP_ROM_INT(SUPERVISOR_UP) },
+    { MP_ROM_QSTR(MP_QSTR_SUPERVISOR_BACKOFF), MP_ROM_INT(SUPERVISOR_BACKOFF) },
+
+    { MP_ROM_QSTR(MP_QSTR_SMS_STATUS_ALL), MP_ROM_INT(SMS_STATUS_ALL) },
+    { MP_ROM_QSTR(MP_QSTR_SMS_STATUS_READ), MP_ROM_INT(SMS_STATUS_READ) },
+    { MP_ROM_QSTR(MP_QSTR_SMS_STATUS_UNREAD), MP_ROM_INT(SMS_STATUS_UNREAD) },
+    { MP_ROM_QSTR(MP_QSTR_SMS_STATUS_UNSENT), MP_ROM_INT(SMS_STATUS_UNSENT) },
 
     { MP_ROM_QSTR(MP_QSTR_ENOSIM), MP_ROM_INT(NTW_EXC_NOSIM) },
     { MP_ROM_QSTR(MP_QSTR_EREGD), MP_ROM_INT(NTW_EXC_REG_DENIED) },
@@ -43,8 +43,8 @@ STATIC mp_obj_t modchip_chip_flash_read(mp_obj_t offset_in, mp_obj_t buf_in) {
     mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
     bool ret;
     Trace(1,"flash read offset:%d,0x%x",offset,offset);
-    uint32_t addr = (uint32_t)HAL_SPI_FLASH_UNCACHE_ADDRESS(offset);
-    Trace(1,"flash read:0x%x",addr);
+    uintptr_t addr = (uintptr_t)HAL_SPI_FLASH_UNCACHE_ADDRESS(offset);
+    Trace(1,"flash read:0x%x",(uint32_t)addr);
     memcpy(bufinfo.buf, (void *)addr, bufinfo.len);
     ret = true;
     if (!ret) {
@@ -27,6 +27,7 @@
  */
 
 #include "modgps.h"
+#include "gpstrack.h"
 #include "timeout.h"
 
 #include "py/nlr.h"
@@ -34,6 +35,7 @@
 #include "py/runtime.h"
 #include "py/binary.h"
 #include "py/objexcept.h"
+#include "py/mphal.h"
 #include "shared/timeutils/timeutils.h"
 
 #include "api_gps.h"
@@ -46,9 +48,271 @@
 
 #include "py/mperrno.h"
 
+#include <math.h>
+
 STATIC mp_obj_t modgps_off(void);
 
+// ----------
+// Fix events
+// ----------
+
+// The fix is followed in the SDK task after each NMEA update. Changes are
+// queued as plain structs and handed to the callback by the MicroPython
+// task; the queue has one producer and one consumer and needs no locks.
+
+#define GPS_FIX_ACQUIRED 1
+#define GPS_FIX_LOST 2
+#define GPS_FIX_MOVED 3
+
+#define GPS_EVENT_QUEUE 8
+#define GPS_FIX_DISTANCE 10
+#define GPS_SCHEDULE_RETRY 10  // ms
+
+#define EARTH_RADIUS 6371000.0
+
+// Keeps the compiler from moving slot accesses across index updates
+#define EVENT_BARRIER() __asm__ volatile ("" ::: "memory")
+
+typedef struct _modgps_event_t {
+    uint8_t kind;
+    int32_t latitude;   // micro-degrees
+    int32_t longitude;
+} modgps_event_t;
+
+STATIC modgps_event_t event_queue[GPS_EVENT_QUEUE];
+STATIC volatile uint32_t event_head = 0;  // written by the SDK task only
+STATIC volatile uint32_t event_tail = 0;  // written by the MicroPython task only
+STATIC volatile uint8_t event_drain_scheduled = 0;
+
+// The last reported fix: SDK task only
+STATIC uint8_t fix_valid = 0;
+STATIC int32_t fix_latitude = 0;
+STATIC int32_t fix_longitude = 0;
+
+// Reports moves longer than this (meters)
+STATIC volatile uint32_t fix_distance = GPS_FIX_DISTANCE;
+
+STATIC void modgps_events_drain(void) {
+    // Calls the callback for each queued event; runs in the MicroPython task
+    event_drain_scheduled = 0;
+    while (event_tail != event_head) {
+        EVENT_BARRIER();
+        modgps_event_t *event = &event_queue[event_tail % GPS_EVENT_QUEUE];
+        mp_obj_t tuple[3] = {
+            mp_obj_new_int(event->kind),
+            mp_obj_new_float(event->latitude / 1e6),
+            mp_obj_new_float(event->longitude / 1e6),
+        };
+        EVENT_BARRIER();
+        event_tail ++;
+
+        mp_obj_t callback = MP_STATE_PORT(gps_fix_callback);
+        if (callback != MP_OBJ_NULL && callback != mp_const_none)
+            mp_call_function_1_protected(callback, mp_obj_new_tuple(3, tuple));
+    }
+}
+
+STATIC mp_obj_t modgps_events_drain_cb(mp_obj_t arg) {
+    modgps_events_drain();
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modgps_events_drain_obj, modgps_events_drain_cb);
+
+extern HANDLE mainTaskHandle;
+
+STATIC void modgps_events_schedule(void);
+
+STATIC void modgps_events_schedule_timer(void *param) {
+    modgps_events_schedule();
+}
+
+STATIC void modgps_events_schedule(void) {
+    // Schedules the drain of queued events; SDK task only. A full scheduler
+    // queue is retried from a timer: no other event may come to do it
+    if (event_drain_scheduled || event_tail == event_head)
+        return;
+    event_drain_scheduled = 1;
+    if (!mp_sched_schedule(MP_OBJ_FROM_PTR(&modgps_events_drain_obj), mp_const_none)) {
+        event_drain_scheduled = 0;
+        OS_StopCallbackTimer(mainTaskHandle, modgps_events_schedule_timer, NULL);
+        OS_StartCallbackTimer(mainTaskHandle, GPS_SCHEDULE_RETRY, modgps_events_schedule_timer, NULL);
+    }
+}
+
+STATIC void modgps_event_push(uint8_t kind, int32_t latitude, int32_t longitude) {
+    // Queues an event for the callback; SDK task only
+    mp_obj_t callback = MP_STATE_PORT(gps_fix_callback);
+    if (callback == MP_OBJ_NULL || callback == mp_const_none)
+        return;
+    if (event_head - event_tail >= GPS_EVENT_QUEUE)
+        return;  // dropped
+    modgps_event_t *event = &event_queue[event_head % GPS_EVENT_QUEUE];
+    event->kind = kind;
+    event->latitude = latitude;
+    event->longitude = longitude;
+    EVENT_BARRIER();
+    event_head ++;
+
+    modgps_events_schedule();
+}
+
+STATIC int32_t modgps_to_udeg(struct minmea_float f) {
+    // NMEA ddmm.mmmm into micro-degrees
+    if (f.scale == 0)
+        return 0;
+    int32_t degrees = f.value / (f.scale * 100);
+    int64_t minutes = f.value - (int64_t) degrees * f.scale * 100;
+    return degrees * 1000000 + (int32_t) (minutes * 1000000 / ((int64_t) f.scale * 60));
+}
+
+STATIC double modgps_distance(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2) {
+    // Equirectangular approximation (meters): fine for short hops
+    double k = EARTH_RADIUS * M_PI / 180e6;
+    double dlon = (double) lon2 - lon1;
+    if (dlon > 180e6)
+        dlon -= 360e6;
+    else if (dlon < -180e6)
+        dlon += 360e6;
+    double dx = dlon * k * cos(((double) lat1 + lat2) * M_PI / 360e6);
+    double dy = ((double) lat2 - lat1) * k;
+    return sqrt(dx * dx + dy * dy);
+}
+
+STATIC void modgps_fix_update(void) {
+    // Compares the fix with the last one reported; SDK task only
+    GPS_Info_t *info = Gps_GetInfo();
+    if (!info->rmc.valid || !info->rmc.latitude.scale || !info->rmc.longitude.scale) {
+        if (fix_valid) {
+            fix_valid = 0;
+            modgps_event_push(GPS_FIX_LOST, fix_latitude, fix_longitude);
+        }
+        return;
+    }
+
+    int32_t latitude = modgps_to_udeg(info->rmc.latitude);
+    int32_t longitude = modgps_to_udeg(info->rmc.longitude);
+    uint8_t kind = GPS_FIX_ACQUIRED;
+    if (fix_valid) {
+        if (modgps_distance(fix_latitude, fix_longitude, latitude, longitude) < fix_distance)
+            return;
+        kind = GPS_FIX_MOVED;
+    }
+    fix_valid = 1;
+    fix_latitude = latitude;
+    fix_longitude = longitude;
+    modgps_event_push(kind, latitude, longitude);
+}
+
+// -------
+// Records
+// -------
+
+// Fixes are packed into fixed-size little-endian records (ustruct format
+// "<IiiiHHBBBx"): time (s since the epoch), latitude, longitude
+// (micro-degrees), altitude (cm), speed (cm/s), course (0.01 degree),
+// HDOP (x10), satellites tracked, flags (RMC valid bit, GGA fix quality
+// in bits 1-3) and a padding byte.
+
+#define GPS_RECORD_VALID 0x01
+#define GPS_TRACK_INTERVAL 1000
+
+// The track: a ring of records filled by the SDK task and read by the
+// MicroPython task. The storage is a root pointer allocated once.
+STATIC volatile uint8_t track_on = 0;
+STATIC uint32_t track_capacity = 0;
+STATIC volatile uint32_t track_head = 0;  // written by the SDK task only
+STATIC volatile uint32_t track_tail = 0;  // written by the MicroPython task only
+STATIC volatile uint32_t track_dropped = 0;
+STATIC uint32_t track_interval = GPS_TRACK_INTERVAL;
+STATIC uint32_t track_last_stamp = 0;
+STATIC uint32_t track_last_time = 0;
+
+STATIC int32_t modgps_scaled(struct minmea_float f, int32_t factor) {
+    // The value multiplied by factor, rounded towards zero
+    if (f.scale == 0)
+        return 0;
+    return (int32_t) ((int64_t) f.value * factor / f.scale);
+}
+
+STATIC void modgps_put_u32(uint8_t *dest, uint32_t value) {
+    dest[0] = value;
+    dest[1] = value >> 8;
+    dest[2] = value >> 16;
+    dest[3] = value >> 24;
+}
+
+STATIC uint32_t modgps_utc(struct minmea_date date, struct minmea_time time) {
+    // Seconds since the epoch; see _get_time
+    return timeutils_mktime(date.year + 2000, date.month, date.day, time.hours, time.minutes, time.seconds);
+}
+
+STATIC bool modgps_record_pack(GPS_Info_t *info, uint8_t *dest) {
+    // Packs the last fix; true if valid. Does not allocate: safe in the SDK task
+    int32_t hdop = modgps_scaled(info->gga.hdop, 10);
+    int32_t speed = MIN(modgps_scaled(info->rmc.speed, 51444) / 1000, 0xFFFF);  // knots
+    int32_t course = modgps_scaled(info->rmc.course, 100);
+    bool valid = info->rmc.valid && info->rmc.latitude.scale && info->rmc.longitude.scale;
+
+    modgps_put_u32(dest, modgps_utc(info->rmc.date, info->rmc.time));
+    modgps_put_u32(dest + 4, modgps_to_udeg(info->rmc.latitude));
+    modgps_put_u32(dest + 8, modgps_to_udeg(info->rmc.longitude));
+    modgps_put_u32(dest + 12, modgps_scaled(info->gga.altitude, 100));
+    dest[16] = speed;
+    dest[17] = speed >> 8;
+    dest[18] = course;
+    dest[19] = course >> 8;
+    dest[20] = MIN(MAX(hdop, 0), 255);
+    dest[21] = info->gga.satellites_tracked;
+    dest[22] = (valid ? GPS_RECORD_VALID : 0) | ((info->gga.fix_quality & 0x07) << 1);
+    dest[23] = 0;
+    return valid;
+}
+
+STATIC void modgps_track_update(void) {
+    // Appends the fix to the track once per interval; SDK task only
+    if (!track_on)
+        return;
+    GPS_Info_t *info = Gps_GetInfo();
+    if (!info->rmc.valid)
+        return;
+
+    // Updates without a new RMC sentence are skipped
+    uint32_t time = modgps_utc(info->rmc.date, info->rmc.time);
+    uint32_t now = mp_hal_ticks_ms();
+    if (time == track_last_time || now - track_last_stamp < track_interval)
+        return;
+
+    if (track_head - track_tail >= track_capacity) {
+        track_dropped ++;
+        return;
+    }
+    uint8_t *dest = MP_STATE_PORT(gps_track) + (track_head % track_capacity) * GPS_RECORD_SIZE;
+    if (!modgps_record_pack(info, dest))
+        return;
+    EVENT_BARRIER();
+    track_head ++;
+    track_last_time = time;
+    track_last_stamp = now;
+}
+
+STATIC void modgps_track_stop(void) {
+    // The SDK task has the higher priority: it is never interrupted by
+    // this function half-way through appending
+    track_on = 0;
+    EVENT_BARRIER();
+    MP_STATE_PORT(gps_track) = NULL;
+    track_capacity = 0;
+    track_head = track_tail = 0;
+}
+
 void modgps_init0(void) {
+    // Drop the callback and events left from before the reset
+    MP_STATE_PORT(gps_fix_callback) = mp_const_none;
+    event_tail = event_head;
+    event_drain_scheduled = 0;
+    fix_distance = GPS_FIX_DISTANCE;
+    modgps_track_stop();
     modgps_off();
 }
 
@@ -60,6 +324,8 @@ GPS_Info_t* gpsInfo = NULL;
 
 void modgps_notify_gps_update(API_Event_t* event) {
     GPS_Update(event->pParam1,event->param1);
+    modgps_fix_update();
+    modgps_track_update();
 }
 
 // -------
@@ -70,23 +336,22 @@ STATIC mp_obj_t modgps_on(size_t n_args, const mp_obj_t *arg) {
     // ========================================
     // Turns GPS on.
     // Args:
-    //     timeout (int): timeout in seconds;
+    //     timeout (int): optional timeout in
+    //     seconds to wait for the fix; returns
+    //     right away if not specified;
     // Raises:
-    //     ValueError if failed to turn GPS on.
+    //     OSError if timed out.
     // ========================================
-    uint32_t timeout = 0;
-    if (n_args == 0) {
-        timeout = DEFAULT_GPS_TIMEOUT;
-    } else {
-        timeout = mp_obj_get_int(arg[0]);
-    }
-    timeout *= 1000 * CLOCKS_PER_MSEC;
     gpsInfo = Gps_GetInfo();
     gpsInfo->rmc.latitude.value = 0;
     gpsInfo->rmc.longitude.value = 0;
     GPS_Init();
     GPS_Open(NULL);
-    WAIT_UNTIL(gpsInfo->rmc.latitude.value, timeout, 100, mp_raise_OSError(MP_ETIMEDOUT));
+    if (n_args == 1) {
+        uint32_t timeout = mp_obj_get_int(arg[0]);
+        timeout *= 1000 * CLOCKS_PER_MSEC;
+        WAIT_UNTIL(gpsInfo->rmc.latitude.value, timeout, 100, mp_raise_OSError(MP_ETIMEDOUT));
+    }
     return mp_const_none;
 }
 
@@ -97,6 +362,7 @@ STATIC mp_obj_t modgps_off(void) {
     // Turns GPS off.
     // ========================================
     GPS_Close();
+    fix_valid = 0;
     return mp_const_none;
 }
 
@@ -128,13 +394,9 @@ STATIC mp_obj_t modgps_get_last_location(void) {
     // ========================================
     REQUIRES_VALID_GPS_INFO;
 
-    int temp = (int)(gpsInfo->rmc.latitude.value/gpsInfo->rmc.latitude.scale/100);
-    double latitude = temp+(double)(gpsInfo->rmc.latitude.value - temp*gpsInfo->rmc.latitude.scale*100)/gpsInfo->rmc.latitude.scale/60.0;
-    temp = (int)(gpsInfo->rmc.longitude.value/gpsInfo->rmc.longitude.scale/100);
-    double longitude = temp+(double)(gpsInfo->rmc.longitude.value - temp*gpsInfo->rmc.longitude.scale*100)/gpsInfo->rmc.longitude.scale/60.0;
     mp_obj_t tuple[2] = {
-        mp_obj_new_float(latitude),
-        mp_obj_new_float(longitude),
+        mp_obj_new_float(modgps_to_udeg(gpsInfo->rmc.latitude) / 1e6),
+        mp_obj_new_float(modgps_to_udeg(gpsInfo->rmc.longitude) / 1e6),
     };
     return mp_obj_new_tuple(2, tuple);
 }
@@ -210,7 +472,7 @@ STATIC mp_obj_t _get_float(struct minmea_float f) {
 STATIC mp_obj_t _get_prn(int* prn) {
     uint8_t prn_u[12];
     for (int i = 0; i < 12; i++) prn_u[i] = prn[i];
-    return mp_obj_new_bytearray(sizeof(prn), prn);
+    return mp_obj_new_bytearray(sizeof(prn_u), prn_u);
 }
 
 STATIC mp_obj_t _get_sat_info(struct minmea_sat_info s) {
@@ -362,6 +624,151 @@ STATIC mp_obj_t modgps_nmea_data(void) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(modgps_nmea_data_obj, modgps_nmea_data);
 
+STATIC mp_obj_t modgps_get_record(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Packs the last fix into a record.
+    // Args:
+    //     buf (bytearray): the buffer to write
+    //     the record to;
+    //     offset (int): offset in the buffer;
+    // Returns:
+    //     True if the fix is valid.
+    // ========================================
+    REQUIRES_VALID_GPS_INFO;
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_WRITE);
+    mp_int_t offset = n_args == 2 ? mp_obj_get_int(args[1]) : 0;
+    if (offset < 0 || offset + GPS_RECORD_SIZE > bufinfo.len)
+        mp_raise_ValueError("Buffer too small");
+
+    return mp_obj_new_bool(modgps_record_pack(gpsInfo, (uint8_t*) bufinfo.buf + offset));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modgps_get_record_obj, 1, 2, modgps_get_record);
+
+STATIC mp_obj_t modgps_track(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Starts or stops recording the track.
+    // Args:
+    //     capacity (int): the number of records
+    //     to keep or 0 to stop;
+    //     interval (int): the minimal interval
+    //     between records in ms;
+    // ========================================
+    mp_int_t capacity = mp_obj_get_int(args[0]);
+    mp_int_t interval = n_args == 2 ? mp_obj_get_int(args[1]) : GPS_TRACK_INTERVAL;
+    if (capacity < 0 || interval < 0)
+        mp_raise_ValueError("Capacity and interval must be non-negative");
+
+    modgps_track_stop();
+    if (capacity) {
+        MP_STATE_PORT(gps_track) = m_new(uint8_t, capacity * GPS_RECORD_SIZE);
+        track_capacity = capacity;
+        track_interval = interval;
+        track_dropped = 0;
+        track_last_time = 0;
+        track_last_stamp = mp_hal_ticks_ms() - interval;
+        // the SDK task sees the track set up before it is switched on
+        EVENT_BARRIER();
+        track_on = 1;
+    }
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modgps_track_obj, 1, 2, modgps_track);
+
+STATIC mp_obj_t modgps_track_read(mp_obj_t buf_in) {
+    // ========================================
+    // Moves recorded fixes into a buffer,
+    // oldest first.
+    // Args:
+    //     buf (bytearray): the buffer;
+    // Returns:
+    //     The number of records written.
+    // ========================================
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+
+    uint32_t n = MIN(track_head - track_tail, bufinfo.len / GPS_RECORD_SIZE);
+    for (uint32_t i = 0; i < n; i++) {
+        EVENT_BARRIER();
+        memcpy((uint8_t*) bufinfo.buf + i * GPS_RECORD_SIZE, MP_STATE_PORT(gps_track) + (track_tail % track_capacity) * GPS_RECORD_SIZE, GPS_RECORD_SIZE);
+        EVENT_BARRIER();
+        track_tail ++;
+    }
+    return mp_obj_new_int_from_uint(n);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modgps_track_read_obj, modgps_track_read);
+
+STATIC mp_obj_t modgps_track_stats(void) {
+    // ========================================
+    // Track statistics.
+    // Returns:
+    //     The number of records pending and
+    //     dropped because the track was full.
+    // ========================================
+    mp_obj_t tuple[2] = {
+        mp_obj_new_int_from_uint(track_head - track_tail),
+        mp_obj_new_int_from_uint(track_dropped),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modgps_track_stats_obj, modgps_track_stats);
+
+STATIC mp_obj_t modgps_track_encode(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Compresses records for uploading.
+    // Args:
+    //     records (bytearray): records;
+    //     out (bytearray): the output buffer;
+    //     tolerance (float): optional path
+    //     simplification tolerance in meters;
+    // Returns:
+    //     The number of bytes written.
+    // ========================================
+    mp_float_t tolerance = n_args == 3 ? mp_obj_get_float(args[2]) : 0;
+
+    mp_buffer_info_t records;
+    mp_get_buffer_raise(args[0], &records, tolerance > 0 ? MP_BUFFER_RW : MP_BUFFER_READ);
+    if (records.len % GPS_RECORD_SIZE)
+        mp_raise_ValueError("Records expected");
+
+    mp_buffer_info_t out;
+    mp_get_buffer_raise(args[1], &out, MP_BUFFER_WRITE);
+
+    size_t len = gpstrack_encode(records.buf, records.len / GPS_RECORD_SIZE, tolerance, out.buf, out.len);
+    if (!len)
+        mp_raise_ValueError("Buffer too small");
+    return mp_obj_new_int_from_uint(len);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modgps_track_encode_obj, 2, 3, modgps_track_encode);
+
+STATIC mp_obj_t modgps_on_fix(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Sets a callback on fix changes.
+    // Args:
+    //     callback (Callable): a callback to
+    //     execute when the fix is acquired,
+    //     lost or moved;
+    //     distance (int): the move in meters
+    //     to report;
+    // ========================================
+    if (n_args == 2) {
+        mp_int_t distance = mp_obj_get_int(args[1]);
+        if (distance < 0)
+            mp_raise_ValueError("Distance must be non-negative");
+        fix_distance = distance;
+    }
+    MP_STATE_PORT(gps_fix_callback) = args[0];
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modgps_on_fix_obj, 1, 2, modgps_on_fix);
+
 STATIC const mp_map_elem_t mp_module_gps_globals_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR_gps) },
 
@@ -373,6 +780,17 @@ STATIC const mp_map_elem_t mp_module_gps_globals_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_satellites), (mp_obj_t)&modgps_get_satellites_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_time), (mp_obj_t)&modgps_time_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_nmea_data), (mp_obj_t)&modgps_nmea_data_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_on_fix), (mp_obj_t)&modgps_on_fix_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_get_record), (mp_obj_t)&modgps_get_record_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_track), (mp_obj_t)&modgps_track_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_track_read), (mp_obj_t)&modgps_track_read_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_track_stats), (mp_obj_t)&modgps_track_stats_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_track_encode), (mp_obj_t)&modgps_track_encode_obj },
+
+    { MP_ROM_QSTR(MP_QSTR_FIX_ACQUIRED), MP_ROM_INT(GPS_FIX_ACQUIRED) },
+    { MP_ROM_QSTR(MP_QSTR_FIX_LOST), MP_ROM_INT(GPS_FIX_LOST) },
+    { MP_ROM_QSTR(MP_QSTR_FIX_MOVED), MP_ROM_INT(GPS_FIX_MOVED) },
+    { MP_ROM_QSTR(MP_QSTR_RECORD_SIZE), MP_ROM_INT(GPS_RECORD_SIZE) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_gps_globals, mp_module_gps_globals_table);
@@ -382,4 +800,6 @@ const mp_obj_module_t gps_module = {
     .globals = (mp_obj_dict_t*)&mp_module_gps_globals,
 };
 
-MP_REGISTER_MODULE(MP_QSTR_gps, gps_module);
\ No newline at end of file
+MP_REGISTER_MODULE(MP_QSTR_gps, gps_module);
+MP_REGISTER_ROOT_POINTER(mp_obj_t gps_fix_callback);
+MP_REGISTER_ROOT_POINTER(uint8_t *gps_track);
\ No newline at end of file
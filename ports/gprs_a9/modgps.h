@@ -34,6 +34,5 @@
 void modgps_init0(void);
 void modgps_notify_gps_update(API_Event_t* event);
 
-#define DEFAULT_GPS_TIMEOUT 5
 #define REQUIRES_VALID_GPS_INFO do { if (!gpsInfo) {mp_raise_OSError(MP_EPERM); return mp_const_none;}} while(0)
 #define REQUIRES_GPS_ON do { if (!GPS_IsOpen()) {mp_raise_OSError(MP_EPERM); return mp_const_none;}} while(0)
@@ -0,0 +1,579 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "py/nlr.h"
+#include "py/obj.h"
+#include "py/objstr.h"
+#include "py/runtime.h"
+#include "py/stream.h"
+#include "py/mperrno.h"
+#include "py/mphal.h"
+
+#include "modusocket.h"
+#include "moduhttp.h"
+
+#define UHTTP_HOST_MAX_LEN (64)
+#define UHTTP_RBUF_LEN (512)
+#define UHTTP_LINE_MAX_LEN (1024)
+#define UHTTP_IDLE_MS (60000)
+#define UHTTP_DEFAULT_TIMEOUT_S (30)
+
+// A connection: the socket and a small read-ahead buffer for parsing
+// status and header lines without byte-sized reads
+typedef struct _uhttp_conn_t {
+    mp_obj_t sock;
+    char host[UHTTP_HOST_MAX_LEN];
+    uint16_t port;
+    bool reused;
+    uint16_t rpos;
+    uint16_t rlen;
+    uint32_t idle_since;
+    uint8_t rbuf[UHTTP_RBUF_LEN];
+} uhttp_conn_t;
+
+// Idle connections are kept in MP_STATE_PORT(uhttp_pool) so that the GC
+// does not collect (and finalise) the sockets
+#define POOL (MP_STATE_PORT(uhttp_pool))
+
+STATIC uint32_t uhttp_requests = 0;
+STATIC uint32_t uhttp_reused = 0;
+STATIC uint32_t uhttp_evicted = 0;
+
+void moduhttp_init0(void) {
+    // Pooled connections do not survive a soft reset: the heap is gone
+    for (int i = 0; i < MICROPY_PY_UHTTP_POOL_SIZE; i++) {
+        POOL[i] = NULL;
+    }
+}
+
+// ----------
+// Connection
+// ----------
+
+STATIC void uhttp_conn_close(uhttp_conn_t *conn) {
+    if (conn->sock != MP_OBJ_NULL) {
+        mp_stream_close(conn->sock);
+        conn->sock = MP_OBJ_NULL;
+    }
+}
+
+STATIC bool uhttp_conn_alive(uhttp_conn_t *conn) {
+    // An idle keep-alive connection has nothing to read: readable means
+    // the server closed it (EOF) or sent garbage, both are unusable
+    if ((uint32_t)(mp_hal_ticks_ms() - conn->idle_since) > UHTTP_IDLE_MS) {
+        return false;
+    }
+    const mp_stream_p_t *stream_p = mp_get_stream(conn->sock);
+    int errcode;
+    mp_uint_t ret = stream_p->ioctl(conn->sock, MP_STREAM_POLL,
+        MP_STREAM_POLL_RD | MP_STREAM_POLL_ERR | MP_STREAM_POLL_HUP, &errcode);
+    return ret == 0;
+}
+
+STATIC uhttp_conn_t *uhttp_pool_take(const char *host, uint16_t port) {
+    for (int i = 0; i < MICROPY_PY_UHTTP_POOL_SIZE; i++) {
+        uhttp_conn_t *conn = POOL[i];
+        if (conn == NULL || conn->port != port || strcmp(conn->host, host)) {
+            continue;
+        }
+        POOL[i] = NULL;
+        if (uhttp_conn_alive(conn)) {
+            conn->reused = true;
+            conn->rpos = conn->rlen = 0;
+            uhttp_reused++;
+            return conn;
+        }
+        uhttp_conn_close(conn);
+        uhttp_evicted++;
+    }
+    return NULL;
+}
+
+STATIC void uhttp_pool_put(uhttp_conn_t *conn) {
+    // Takes a free slot or replaces the connection idle for the longest time
+    conn->idle_since = mp_hal_ticks_ms();
+    int slot = 0;
+    uint32_t idle_max = 0;
+    for (int i = 0; i < MICROPY_PY_UHTTP_POOL_SIZE; i++) {
+        if (POOL[i] == NULL) {
+            slot = i;
+            break;
+        }
+        uhttp_conn_t *other = POOL[i];
+        uint32_t idle = conn->idle_since - other->idle_since;
+        if (idle >= idle_max) {
+            idle_max = idle;
+            slot = i;
+        }
+    }
+    if (POOL[slot] != NULL) {
+        uhttp_conn_close(POOL[slot]);
+        uhttp_evicted++;
+    }
+    POOL[slot] = conn;
+}
+
+STATIC uhttp_conn_t *uhttp_conn_open(const char *host, uint16_t port) {
+    uhttp_conn_t *conn = m_new_obj(uhttp_conn_t);
+    strcpy(conn->host, host);
+    conn->port = port;
+    conn->reused = false;
+    conn->rpos = conn->rlen = 0;
+    conn->sock = MP_OBJ_TYPE_GET_SLOT(&socket_type, make_new)(&socket_type, 0, 0, NULL);
+
+    mp_obj_t dest[3];
+    mp_obj_t address[2] = {
+        mp_obj_new_str(host, strlen(host)),
+        MP_OBJ_NEW_SMALL_INT(port),
+    };
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_load_method(conn->sock, MP_QSTR_settimeout, dest);
+        dest[2] = MP_OBJ_NEW_SMALL_INT(UHTTP_DEFAULT_TIMEOUT_S);
+        mp_call_method_n_kw(1, 0, dest);
+        mp_load_method(conn->sock, MP_QSTR_connect, dest);
+        dest[2] = mp_obj_new_tuple(2, address);
+        mp_call_method_n_kw(1, 0, dest);
+        nlr_pop();
+    } else {
+        uhttp_conn_close(conn);
+        nlr_jump(nlr.ret_val);
+    }
+    return conn;
+}
+
+// -------
+// Reading
+// -------
+
+STATIC bool uhttp_fill(uhttp_conn_t *conn) {
+    // Refills the read-ahead buffer with a single read; false on EOF
+    if (conn->rpos < conn->rlen) {
+        return true;
+    }
+    const mp_stream_p_t *stream_p = mp_get_stream(conn->sock);
+    int errcode;
+    mp_uint_t r = stream_p->read(conn->sock, conn->rbuf, UHTTP_RBUF_LEN, &errcode);
+    if (r == MP_STREAM_ERROR) {
+        // A reset of a re-used connection is handled like EOF so that a
+        // request hitting a connection dropped by the server is retried
+        if (conn->reused && errcode != MP_ETIMEDOUT) {
+            r = 0;
+        } else {
+            mp_raise_OSError(errcode);
+        }
+    }
+    conn->rpos = 0;
+    conn->rlen = r;
+    return r > 0;
+}
+
+STATIC bool uhttp_readline(uhttp_conn_t *conn, vstr_t *line) {
+    // Reads a line without the trailing CRLF; false on EOF before a newline
+    vstr_reset(line);
+    for (;;) {
+        if (!uhttp_fill(conn)) {
+            return false;
+        }
+        uint8_t *start = conn->rbuf + conn->rpos;
+        size_t len = conn->rlen - conn->rpos;
+        uint8_t *nl = memchr(start, '\n', len);
+        size_t n = nl ? (size_t)(nl - start) : len;
+        if (line->len + n > UHTTP_LINE_MAX_LEN) {
+            mp_raise_ValueError("HTTP header line too long");
+        }
+        vstr_add_strn(line, (const char*)start, n);
+        conn->rpos += nl ? n + 1 : n;
+        if (nl) {
+            if (line->len > 0 && line->buf[line->len - 1] == '\r') {
+                line->len--;
+            }
+            return true;
+        }
+    }
+}
+
+STATIC void uhttp_read_body(uhttp_conn_t *conn, vstr_t *body, size_t n) {
+    // Appends exactly n bytes
+    while (n > 0) {
+        if (!uhttp_fill(conn)) {
+            mp_raise_OSError(MP_ECONNRESET);
+        }
+        size_t chunk = MIN(n, (size_t)(conn->rlen - conn->rpos));
+        vstr_add_strn(body, (const char*)conn->rbuf + conn->rpos, chunk);
+        conn->rpos += chunk;
+        n -= chunk;
+    }
+}
+
+STATIC void uhttp_read_chunked(uhttp_conn_t *conn, vstr_t *body, vstr_t *line) {
+    for (;;) {
+        if (!uhttp_readline(conn, line)) {
+            mp_raise_OSError(MP_ECONNRESET);
+        }
+        // Chunk extensions after ';' are ignored by strtoul
+        char *end;
+        unsigned long n = strtoul(vstr_null_terminated_str(line), &end, 16);
+        if (end == line->buf) {
+            mp_raise_ValueError("Invalid HTTP chunk size");
+        }
+        if (n == 0) {
+            break;
+        }
+        uhttp_read_body(conn, body, n);
+        if (!uhttp_readline(conn, line) || line->len) {
+            mp_raise_ValueError("Invalid HTTP chunk");
+        }
+    }
+    // Trailers
+    do {
+        if (!uhttp_readline(conn, line)) {
+            mp_raise_OSError(MP_ECONNRESET);
+        }
+    } while (line->len);
+}
+
+// --------
+// Exchange
+// --------
+
+STATIC bool uhttp_write(uhttp_conn_t *conn, const void *buf, size_t len, bool *sent) {
+    // Write errors on a fresh connection are raised, on a re-used one they
+    // are reported to the caller to retry. sent is set once any byte is out
+    int errcode;
+    mp_uint_t n = mp_stream_rw(conn->sock, (void*)buf, len, &errcode, MP_STREAM_RW_WRITE);
+    if (n > 0) {
+        *sent = true;
+    }
+    if (n == len) {
+        return true;
+    }
+    if (!conn->reused) {
+        mp_raise_OSError(errcode ? errcode : MP_ETIMEDOUT);
+    }
+    return false;
+}
+
+STATIC mp_obj_t uhttp_exchange(uhttp_conn_t *conn, bool head, vstr_t *request, mp_buffer_info_t *data, bool *keep_alive, bool *sent) {
+    // Sends the request and reads the response. Returns MP_OBJ_NULL if the
+    // connection broke before any response byte (the server dropped an idle
+    // connection); sent tells whether the server may have seen the request.
+    if (!uhttp_write(conn, request->buf, request->len, sent)) {
+        return MP_OBJ_NULL;
+    }
+    if (data->len && !uhttp_write(conn, data->buf, data->len, sent)) {
+        return MP_OBJ_NULL;
+    }
+
+    vstr_t line;
+    vstr_init(&line, 64);
+
+    // Status line
+    if (!uhttp_readline(conn, &line)) {
+        return MP_OBJ_NULL;
+    }
+    const char *s = vstr_null_terminated_str(&line);
+    if (line.len < 12 || strncmp(s, "HTTP/1.", 7) || s[8] != ' ') {
+        mp_raise_ValueError("Invalid HTTP status line");
+    }
+    bool http11 = s[7] == '1';
+    int status = atoi(s + 9);
+
+    // Headers
+    mp_obj_t headers = mp_obj_new_dict(0);
+    bool chunked = false;
+    bool close = !http11;
+    mp_int_t content_length = -1;
+    for (;;) {
+        if (!uhttp_readline(conn, &line)) {
+            mp_raise_OSError(MP_ECONNRESET);
+        }
+        if (line.len == 0) {
+            break;
+        }
+        char *name = vstr_null_terminated_str(&line);
+        char *colon = strchr(name, ':');
+        if (colon == NULL) {
+            continue;
+        }
+        *colon = 0;
+        for (char *c = name; *c; c++) {
+            if (*c >= 'A' && *c <= 'Z') *c += 'a' - 'A';
+        }
+        char *value = colon + 1;
+        while (*value == ' ' || *value == '\t') value++;
+
+        if (!strcmp(name, "content-length")) {
+            content_length = atoi(value);
+        } else if (!strcmp(name, "transfer-encoding")) {
+            chunked = strstr(value, "chunked") != NULL;
+        } else if (!strcmp(name, "connection")) {
+            close = strstr(value, "close") != NULL || (!http11 && strstr(value, "keep-alive") == NULL);
+        }
+        mp_obj_dict_store(headers,
+            mp_obj_new_str(name, colon - name),
+            mp_obj_new_str(value, strlen(value)));
+    }
+
+    // Body
+    vstr_t body;
+    if (head || status == 204 || status == 304 || (status >= 100 && status < 200)) {
+        vstr_init(&body, 0);
+    } else if (chunked) {
+        vstr_init(&body, UHTTP_RBUF_LEN);
+        uhttp_read_chunked(conn, &body, &line);
+    } else if (content_length >= 0) {
+        vstr_init(&body, content_length);
+        uhttp_read_body(conn, &body, content_length);
+    } else {
+        // Delimited by the connection close
+        vstr_init(&body, UHTTP_RBUF_LEN);
+        while (uhttp_fill(conn)) {
+            vstr_add_strn(&body, (const char*)conn->rbuf + conn->rpos, conn->rlen - conn->rpos);
+            conn->rpos = conn->rlen;
+        }
+        close = true;
+    }
+    vstr_clear(&line);
+
+    *keep_alive = !close;
+    mp_obj_t tuple[3] = {
+        MP_OBJ_NEW_SMALL_INT(status),
+        headers,
+        mp_obj_new_bytes_from_vstr(&body),
+    };
+    return mp_obj_new_tuple(3, tuple);
+}
+
+// ---------
+// Functions
+// ---------
+
+STATIC const char *uhttp_header_str(mp_obj_t obj) {
+    // A header name or value: a line break would end the header and let the
+    // rest of the string through as headers or a request of its own
+    size_t len;
+    const char *str = mp_obj_str_get_data(obj, &len);
+    if (memchr(str, '\r', len) || memchr(str, '\n', len)) {
+        mp_raise_ValueError("Line break in an HTTP header");
+    }
+    return str;
+}
+
+STATIC bool uhttp_idempotent(const char *method) {
+    // Methods that may be repeated: the server ends up in the same state
+    // whether it saw the first attempt or not (RFC 7231, 4.2.2)
+    static const char *const methods[] = { "GET", "HEAD", "PUT", "DELETE", "OPTIONS", "TRACE" };
+    for (size_t i = 0; i < MP_ARRAY_SIZE(methods); i++) {
+        if (!strcmp(method, methods[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+STATIC void uhttp_parse_url(const char *url, char *host, uint16_t *port, const char **path) {
+    if (strncmp(url, "http://", 7)) {
+        mp_raise_ValueError("Only http:// URLs are supported");
+    }
+    url += 7;
+    size_t host_len = strcspn(url, ":/");
+    if (host_len == 0 || host_len >= UHTTP_HOST_MAX_LEN) {
+        mp_raise_ValueError("Invalid host");
+    }
+    memcpy(host, url, host_len);
+    host[host_len] = 0;
+    url += host_len;
+
+    *port = 80;
+    if (*url == ':') {
+        int p = atoi(url + 1);
+        if (p <= 0 || p > 0xFFFF) {
+            mp_raise_ValueError("Invalid port");
+        }
+        *port = p;
+        url += strcspn(url, "/");
+    }
+    *path = *url ? url : "/";
+}
+
+STATIC mp_obj_t uhttp_request(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    // ========================================
+    // Performs an HTTP/1.1 request re-using
+    // pooled keep-alive connections.
+    // Args:
+    //     method (str): request method;
+    //     url (str): http:// URL;
+    //     data (str, bytes): request body;
+    //     headers (dict): extra headers;
+    // Returns:
+    //     A tuple with the status code, response
+    //     headers (lowercase names) and the body.
+    // ========================================
+    enum { ARG_method, ARG_url, ARG_data, ARG_headers };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_method, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_url, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_data, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_headers, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    const char *method = mp_obj_str_get_str(args[ARG_method].u_obj);
+    char host[UHTTP_HOST_MAX_LEN];
+    uint16_t port;
+    const char *path;
+    uhttp_parse_url(mp_obj_str_get_str(args[ARG_url].u_obj), host, &port, &path);
+
+    mp_buffer_info_t data = { .buf = NULL, .len = 0 };
+    if (args[ARG_data].u_obj != mp_const_none) {
+        mp_get_buffer_raise(args[ARG_data].u_obj, &data, MP_BUFFER_READ);
+    }
+
+    // Request line and headers are sent in one write
+    vstr_t request;
+    vstr_init(&request, 128);
+    vstr_printf(&request, "%s %s HTTP/1.1\r\nHost: %s", method, path, host);
+    if (port != 80) {
+        vstr_printf(&request, ":%u", port);
+    }
+    vstr_add_str(&request, "\r\nConnection: keep-alive\r\n");
+    if (args[ARG_data].u_obj != mp_const_none) {
+        vstr_printf(&request, "Content-Length: %u\r\n", (unsigned int)data.len);
+    }
+    if (args[ARG_headers].u_obj != mp_const_none) {
+        mp_map_t *map = mp_obj_dict_get_map(args[ARG_headers].u_obj);
+        for (size_t i = 0; i < map->alloc; i++) {
+            if (mp_map_slot_is_filled(map, i)) {
+                vstr_printf(&request, "%s: %s\r\n",
+                    uhttp_header_str(map->table[i].key),
+                    uhttp_header_str(map->table[i].value));
+            }
+        }
+    }
+    vstr_add_str(&request, "\r\n");
+
+    bool head = !strcmp(method, "HEAD");
+    bool idempotent = uhttp_idempotent(method);
+    uhttp_requests++;
+    for (;;) {
+        uhttp_conn_t *conn = uhttp_pool_take(host, port);
+        if (conn == NULL) {
+            conn = uhttp_conn_open(host, port);
+        }
+
+        bool keep_alive = false;
+        bool sent = false;
+        mp_obj_t result;
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            result = uhttp_exchange(conn, head, &request, &data, &keep_alive, &sent);
+            nlr_pop();
+        } else {
+            uhttp_conn_close(conn);
+            nlr_jump(nlr.ret_val);
+        }
+
+        if (result == MP_OBJ_NULL) {
+            // Stale pooled connection: try again with another one unless a
+            // request that is not safe to repeat may have reached the server
+            uhttp_conn_close(conn);
+            if (conn->reused && (idempotent || !sent)) {
+                uhttp_evicted++;
+                continue;
+            }
+            mp_raise_OSError(MP_ECONNRESET);
+        }
+
+        if (keep_alive) {
+            uhttp_pool_put(conn);
+        } else {
+            uhttp_conn_close(conn);
+        }
+        vstr_clear(&request);
+        return result;
+    }
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(uhttp_request_obj, 2, uhttp_request);
+
+STATIC mp_obj_t uhttp_close(void) {
+    // ========================================
+    // Closes all pooled connections.
+    // ========================================
+    for (int i = 0; i < MICROPY_PY_UHTTP_POOL_SIZE; i++) {
+        if (POOL[i] != NULL) {
+            uhttp_conn_close(POOL[i]);
+            POOL[i] = NULL;
+        }
+    }
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(uhttp_close_obj, uhttp_close);
+
+STATIC mp_obj_t uhttp_stats(void) {
+    // ========================================
+    // Retrieves connection pool statistics.
+    // Returns:
+    //     The number of requests, requests served
+    //     over re-used connections, evicted
+    //     connections and idle pooled connections.
+    // ========================================
+    int idle = 0;
+    for (int i = 0; i < MICROPY_PY_UHTTP_POOL_SIZE; i++) {
+        if (POOL[i] != NULL) idle++;
+    }
+    mp_obj_t tuple[4] = {
+        mp_obj_new_int_from_uint(uhttp_requests),
+        mp_obj_new_int_from_uint(uhttp_reused),
+        mp_obj_new_int_from_uint(uhttp_evicted),
+        mp_obj_new_int(idle),
+    };
+    return mp_obj_new_tuple(4, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(uhttp_stats_obj, uhttp_stats);
+
+STATIC const mp_map_elem_t mp_module_uhttp_globals_table[] = {
+    { MP_OBJ_NEW_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR_uhttp) },
+
+    { MP_OBJ_NEW_QSTR(MP_QSTR_request), (mp_obj_t)&uhttp_request_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_close), (mp_obj_t)&uhttp_close_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_stats), (mp_obj_t)&uhttp_stats_obj },
+};
+
+STATIC MP_DEFINE_CONST_DICT(mp_module_uhttp_globals, mp_module_uhttp_globals_table);
+
+const mp_obj_module_t uhttp_module = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&mp_module_uhttp_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR_uhttp, uhttp_module);
+MP_REGISTER_ROOT_POINTER(void *uhttp_pool[MICROPY_PY_UHTTP_POOL_SIZE]);
@@ -0,0 +1,39 @@
+# Decodes GPS tracks compressed by gps.track_encode. Runs on any
+# MicroPython port as well as CPython.
+
+VERSION = 1
+FIELDS = 9
+
+
+def _varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            break
+    return (value >> 1) ^ -(value & 1), pos
+
+
+def decode(data):
+    """Yields (time, latitude, longitude, altitude, speed, course, hdop,
+    satellites, flags) tuples, the same as ustruct.unpack of records."""
+    if not data:
+        return
+    if data[0] != VERSION:
+        raise ValueError("unsupported track version")
+    values = [0] * FIELDS
+    pos = 1
+    while pos < len(data):
+        delta, pos = _varint(data, pos)
+        values[0] += delta
+        mask = data[pos]
+        pos += 1
+        for i in range(1, FIELDS):
+            if mask & (1 << (i - 1)):
+                delta, pos = _varint(data, pos)
+                values[i] += delta
+        yield tuple(values)
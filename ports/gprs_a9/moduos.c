@@ -340,7 +340,7 @@ mp_obj_t moduos_internal_flash_stat(mp_obj_t path_in) {
     int32_t size = 0;
     Dir_t* folder = NULL;
     mp_int_t mode = 0;
-    int32_t fd = NULL;
+    int32_t fd = -1;
 
     if ((folder = API_FS_OpenDir(path))) {
         API_FS_CloseDir(folder);
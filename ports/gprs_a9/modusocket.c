@@ -38,7 +38,9 @@
 #include "py/objexcept.h"
 #include "py/mperrno.h"
 #include "py/stream.h"
+#include "py/mphal.h"
 #include "shared/netutils/netutils.h"
+#include "extmod/moduselect.h"
 
 #include "api_network.h"
 #include "ram_pointers.h"
@@ -46,6 +48,14 @@
 #include "stdio.h"
 
 #define SOCKET_POLL_US (100000)
+#define SOCKET_TIMEOUT_FOREVER (UINT32_MAX)
+#define SOCKET_LISTEN_BACKLOG (2)
+#define SOCKET_IOV_MAX (8)
+#define SOCKET_SELECT_FOREIGN_MS (10)
+
+#define DNS_CACHE_SIZE (8)
+#define DNS_CACHE_HOST_MAX_LEN (64)
+#define DNS_CACHE_DEFAULT_TTL_MS (300000)
 
 uint8_t num_sockets_open = 0;
 
@@ -65,6 +75,15 @@ static inline void check_for_exceptions(void) {
 // Classes
 // -------
 
+typedef struct _socket_stats_t {
+    uint32_t bytes_sent;
+    uint32_t bytes_received;
+    uint32_t packets_sent;
+    uint32_t packets_received;
+    uint32_t retries;
+    uint32_t timeouts;
+} socket_stats_t;
+
 typedef struct _socket_obj_t {
     mp_obj_base_t base;
     int fd;
@@ -72,26 +91,166 @@ typedef struct _socket_obj_t {
     uint8_t type;
     uint8_t proto;
     bool peer_closed;
-    unsigned int retries;
+    uint32_t timeout;  // ms, SOCKET_TIMEOUT_FOREVER if blocking
+    socket_stats_t stats;
 } socket_obj_t;
 
+// Totals over all sockets, including closed ones
+STATIC socket_stats_t socket_stats_total;
+
+static inline void _socket_count_sent(socket_obj_t *sock, int n) {
+    sock->stats.bytes_sent += n;
+    sock->stats.packets_sent++;
+    socket_stats_total.bytes_sent += n;
+    socket_stats_total.packets_sent++;
+}
+
+static inline void _socket_count_received(socket_obj_t *sock, int n) {
+    sock->stats.bytes_received += n;
+    sock->stats.packets_received++;
+    socket_stats_total.bytes_received += n;
+    socket_stats_total.packets_received++;
+}
+
+#define SOCKET_STATS_N (6)
+
+STATIC void _socket_stats_items(const socket_stats_t *stats, mp_obj_t *items) {
+    items[0] = mp_obj_new_int_from_uint(stats->bytes_sent);
+    items[1] = mp_obj_new_int_from_uint(stats->bytes_received);
+    items[2] = mp_obj_new_int_from_uint(stats->packets_sent);
+    items[3] = mp_obj_new_int_from_uint(stats->packets_received);
+    items[4] = mp_obj_new_int_from_uint(stats->retries);
+    items[5] = mp_obj_new_int_from_uint(stats->timeouts);
+}
+
 void _socket_settimeout(socket_obj_t *sock, uint64_t timeout_ms) {
-    // Rather than waiting for the entire timeout specified, we wait sock->retries times
-    // for SOCKET_POLL_US each, checking for a MicroPython interrupt between timeouts.
-    // with SOCKET_POLL_MS == 100ms, sock->retries allows for timeouts up to 13 years.
-    // if timeout_ms == UINT64_MAX, wait forever.
-    sock->retries = (timeout_ms == UINT64_MAX) ? UINT_MAX : timeout_ms * 1000 / SOCKET_POLL_US;
-
-    struct timeval timeout = {
-        .tv_sec = 0,
-        .tv_usec = timeout_ms ? SOCKET_POLL_US : 0
-    };
-    LWIP_SETSOCKOPT(sock->fd, SOL_SOCKET, SO_SNDTIMEO, (const void *)&timeout, sizeof(timeout));
-    LWIP_SETSOCKOPT(sock->fd, SOL_SOCKET, SO_RCVTIMEO, (const void *)&timeout, sizeof(timeout));
-    LWIP_FCNTL(sock->fd, F_SETFL, timeout_ms ? 0 : O_NONBLOCK);
+    // Waits are measured against mp_hal_ticks_ms(), which wraps around: timeouts
+    // longer than ~24 days (and timeout_ms == UINT64_MAX) wait forever.
+    sock->timeout = (timeout_ms > INT32_MAX) ? SOCKET_TIMEOUT_FOREVER : timeout_ms;
+
+    // lwIP calls never block: waiting is done by _socket_wait
+    LWIP_FCNTL(sock->fd, F_SETFL, O_NONBLOCK);
+}
+
+static int _socket_wait(socket_obj_t *sock, bool write, uint32_t start) {
+    // Waits until the socket becomes readable (writable), sock->timeout ms
+    // since start elapse or SOCKET_POLL_US pass, whichever comes first, so
+    // that MicroPython interrupts are checked in between. lwIP wakes select()
+    // from the netconn event callback, so a waiting send/recv is resumed as
+    // soon as data or buffer space arrives rather than at the next poll
+    // boundary.
+    // Returns >0 if the operation should be retried, 0 if the timeout is
+    // exhausted and <0 on lwIP errors (errno is set).
+    uint32_t wait_us = SOCKET_POLL_US;
+    if (sock->timeout != SOCKET_TIMEOUT_FOREVER) {
+        uint32_t elapsed = mp_hal_ticks_ms() - start;
+        if (elapsed >= sock->timeout) {
+            if (sock->timeout) {
+                sock->stats.timeouts++;
+                socket_stats_total.timeouts++;
+            }
+            return 0;
+        }
+        uint32_t left = sock->timeout - elapsed;
+        if (left < SOCKET_POLL_US / 1000) {
+            wait_us = left * 1000;
+        }
+    }
+    sock->stats.retries++;
+    socket_stats_total.retries++;
+
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(sock->fd, &fds);
+    fd_set efds;
+    FD_ZERO(&efds);
+    FD_SET(sock->fd, &efds);
+    struct timeval timeout = { .tv_sec = 0, .tv_usec = wait_us };
+
+    MP_THREAD_GIL_EXIT();
+    int r = LWIP_SELECT(sock->fd + 1, write ? NULL : &fds, write ? &fds : NULL, &efds, &timeout);
+    MP_THREAD_GIL_ENTER();
+
+    if (r < 0) {
+        return r;
+    }
+    check_for_exceptions();
+    return 1;
+}
+
+// ---------
+// DNS cache
+// ---------
+
+// DNS_GetHostByName2 does not report record TTLs: entries expire after
+// dns_cache_ttl ms instead and the whole cache is flushed when the PDP
+// context goes down.
+typedef struct _dns_cache_entry_t {
+    char host[DNS_CACHE_HOST_MAX_LEN];
+    char address[16];
+    uint32_t expires;
+} dns_cache_entry_t;
+
+STATIC dns_cache_entry_t dns_cache[DNS_CACHE_SIZE];
+STATIC uint32_t dns_cache_ttl = DNS_CACHE_DEFAULT_TTL_MS;
+STATIC uint32_t dns_cache_hits = 0;
+STATIC uint32_t dns_cache_misses = 0;
+
+STATIC bool dns_cache_valid(dns_cache_entry_t *entry, uint32_t now) {
+    return entry->host[0] && (int32_t)(entry->expires - now) > 0;
+}
+
+STATIC bool dns_cache_lookup(const char *host, char *address) {
+    bool found = false;
+    uint32_t now = mp_hal_ticks_ms();
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    for (int i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (dns_cache_valid(dns_cache + i, now) && !strcmp(dns_cache[i].host, host)) {
+            memcpy(address, dns_cache[i].address, sizeof(dns_cache[i].address));
+            found = true;
+            break;
+        }
+    }
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+    return found;
+}
+
+STATIC void dns_cache_store(const char *host, const char *address) {
+    size_t len = strlen(host);
+    if (!dns_cache_ttl || len >= DNS_CACHE_HOST_MAX_LEN) {
+        return;
+    }
+    uint32_t now = mp_hal_ticks_ms();
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    // Replace an expired entry or the one expiring first
+    dns_cache_entry_t *slot = dns_cache;
+    for (int i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (!dns_cache_valid(dns_cache + i, now)) {
+            slot = dns_cache + i;
+            break;
+        }
+        if ((int32_t)(dns_cache[i].expires - slot->expires) < 0) {
+            slot = dns_cache + i;
+        }
+    }
+    memcpy(slot->host, host, len + 1);
+    memcpy(slot->address, address, sizeof(slot->address));
+    slot->address[sizeof(slot->address) - 1] = 0;
+    slot->expires = now + dns_cache_ttl;
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+}
+
+void modusocket_dns_flush(void) {
+    // Called from the SDK event task on PDP deactivation
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    for (int i = 0; i < DNS_CACHE_SIZE; i++) {
+        dns_cache[i].host[0] = 0;
+    }
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
 }
 
 static int _socket_getaddrinfo2(const mp_obj_t host, const mp_obj_t port, struct sockaddr_in *resp) {
+    // Returns a positive value on success
 
     const char *host_str = mp_obj_str_get_str(host);
     const int port_int = mp_obj_get_int(port);
@@ -101,20 +260,30 @@ static int _socket_getaddrinfo2(const mp_obj_t host, const mp_obj_t port, struct
         host_str = "0.0.0.0";
     }
 
-    char address[16];
-    if (DNS_GetHostByName2((uint8_t*)host_str, (uint8_t*)address) != 0) {
-        return -1;
-    }
-
     memset(resp, 0, sizeof(*resp));
     resp->sin_family = AF_INET;
     resp->sin_port = LWIP_HTONS(port_int);
 
-    MP_THREAD_GIL_EXIT();
-    int res = LWIP_IP4ADDR_ATON(address, (ip4_addr_t*)&resp->sin_addr);
-    MP_THREAD_GIL_ENTER();
+    // Literal addresses (as passed by uasyncio after getaddrinfo) skip DNS
+    if (LWIP_IP4ADDR_ATON(host_str, (ip4_addr_t*)&resp->sin_addr)) {
+        return 1;
+    }
 
-    return res;
+    char address[16];
+    if (dns_cache_lookup(host_str, address)) {
+        dns_cache_hits ++;
+    } else {
+        dns_cache_misses ++;
+        MP_THREAD_GIL_EXIT();
+        int r = DNS_GetHostByName2((uint8_t*)host_str, (uint8_t*)address);
+        MP_THREAD_GIL_ENTER();
+        if (r != 0) {
+            return -1;
+        }
+        dns_cache_store(host_str, address);
+    }
+
+    return LWIP_IP4ADDR_ATON(address, (ip4_addr_t*)&resp->sin_addr);
 }
 
 int _socket_getaddrinfo(const mp_obj_t addrtuple, struct sockaddr_in *resp) {
@@ -140,6 +309,7 @@ mp_obj_t socket_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw,
     socket_obj_t *self = m_new_obj_with_finaliser(socket_obj_t);
     self->base.type = type;
     self->peer_closed = false;
+    memset(&self->stats, 0, sizeof(self->stats));
 
     switch (args[ARG_af].u_int) {
         case AF_INET:
@@ -193,7 +363,18 @@ STATIC mp_obj_t socket_bind(mp_obj_t self_in, mp_obj_t address) {
     // Args:
     //     address (tuple): address to bind to;
     // ========================================
-    mp_raise_NotImplementedError("Server capabilities are not implemented yet");
+    socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    struct sockaddr_in res;
+    if (_socket_getaddrinfo(address, &res) <= 0) {
+        mp_raise_ValueError("Failed to resolve the address to bind to");
+        return mp_const_none;
+    }
+
+    int r = LWIP_BIND(self->fd, (struct sockaddr*)&res, sizeof(struct sockaddr_in));
+    if (r < 0) {
+        exception_from_errno(errno);
+    }
     return mp_const_none;
 }
 
@@ -206,7 +387,18 @@ STATIC mp_obj_t socket_listen(size_t n_args, const mp_obj_t *args) {
     //     backlog (int): the number of unaccepted connections
     //     that the system will allow before refusing new connections.
     // ========================================
-    mp_raise_NotImplementedError("Server capabilities are not implemented yet");
+    socket_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    int backlog = SOCKET_LISTEN_BACKLOG;
+    if (n_args == 2) {
+        backlog = mp_obj_get_int(args[1]);
+        if (backlog < 0) backlog = 0;
+    }
+
+    int r = LWIP_LISTEN(self->fd, backlog);
+    if (r < 0) {
+        exception_from_errno(errno);
+    }
     return mp_const_none;
 }
 
@@ -215,9 +407,50 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_listen_obj, 1, 2, &socket_list
 STATIC mp_obj_t socket_accept(mp_obj_t self_in) {
     // ========================================
     // Accepts the connection.
+    // Returns:
+    //     A new socket and the address of the
+    //     remote peer.
     // ========================================
-    mp_raise_NotImplementedError("Server capabilities are not implemented yet");
-    return mp_const_none;
+    socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Allocate first: the accepted fd would leak if this raised
+    socket_obj_t *sock = m_new_obj_with_finaliser(socket_obj_t);
+    sock->base.type = self->base.type;
+    sock->fd = -1;
+    sock->domain = self->domain;
+    sock->type = self->type;
+    sock->proto = self->proto;
+    sock->peer_closed = false;
+    memset(&sock->stats, 0, sizeof(sock->stats));
+
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    uint32_t start = mp_hal_ticks_ms();
+    for (;;) {
+        int fd = LWIP_ACCEPT(self->fd, (struct sockaddr*)&addr, &addr_len);
+        if (fd >= 0) {
+            sock->fd = fd;
+            break;
+        }
+        if (errno != EWOULDBLOCK) {
+            exception_from_errno(errno);
+        }
+        int w = _socket_wait(self, false, start);
+        if (w < 0) {
+            exception_from_errno(errno);
+        }
+        if (w == 0) {
+            mp_raise_OSError(self->timeout == 0 ? MP_EWOULDBLOCK : MP_ETIMEDOUT);
+        }
+    }
+    num_sockets_open ++;
+    _socket_settimeout(sock, UINT64_MAX);
+
+    mp_obj_t tuple[2] = {
+        MP_OBJ_FROM_PTR(sock),
+        netutils_format_inet_addr((uint8_t*)&addr.sin_addr, LWIP_NTOHS(addr.sin_port), NETUTILS_BIG),
+    };
+    return mp_obj_new_tuple(2, tuple);
 }
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(socket_accept_obj, &socket_accept);
@@ -231,14 +464,31 @@ STATIC mp_obj_t socket_connect(mp_obj_t self_in, mp_obj_t ipv4) {
     socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
 
     struct sockaddr_in res;
-    _socket_getaddrinfo(ipv4, &res);
-
-    MP_THREAD_GIL_EXIT();
-    int r = LWIP_CONNECT(self->fd, (struct sockaddr*)&res, sizeof(struct sockaddr_in));
-    MP_THREAD_GIL_ENTER();
+    if (_socket_getaddrinfo(ipv4, &res) <= 0) {
+        mp_raise_ValueError("Failed to resolve the address to connect to");
+        return mp_const_none;
+    }
 
-    if (r < 0) {
-        exception_from_errno(errno);
+    // The socket is non-blocking in lwIP: with a zero timeout EINPROGRESS is
+    // raised right away and completion (or failure) is reported through
+    // MP_STREAM_POLL_WR (MP_STREAM_POLL_ERR) in socket_stream_ioctl.
+    uint32_t start = mp_hal_ticks_ms();
+    for (;;) {
+        int r = LWIP_CONNECT(self->fd, (struct sockaddr*)&res, sizeof(struct sockaddr_in));
+        if (r == 0 || (r < 0 && errno == EISCONN)) {
+            break;
+        }
+        if (errno != EINPROGRESS && errno != EALREADY) {
+            exception_from_errno(errno);
+        }
+        int w = _socket_wait(self, true, start);
+        if (w < 0) {
+            exception_from_errno(errno);
+        }
+        if (w == 0) {
+            if (self->timeout == 0) exception_from_errno(EINPROGRESS);
+            mp_raise_OSError(MP_ETIMEDOUT);
+        }
     }
 
     return mp_const_none;
@@ -248,17 +498,50 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_connect_obj, &socket_connect);
 
 int _socket_send(socket_obj_t *sock, const char *data, size_t datalen) {
     int sentlen = 0;
-    for (int i=0; i<=sock->retries && sentlen < datalen; i++) {
-
-        MP_THREAD_GIL_EXIT();
+    uint32_t start = mp_hal_ticks_ms();
+    while (sentlen < datalen) {
         int r = LWIP_WRITE(sock->fd, data + sentlen, datalen - sentlen);
-        MP_THREAD_GIL_ENTER();
+        if (r > 0) {
+            _socket_count_sent(sock, r);
+            sentlen += r;
+            continue;
+        }
+        if (r < 0 && errno != EWOULDBLOCK) exception_from_errno(errno);
+        int w = _socket_wait(sock, true, start);
+        if (w < 0) exception_from_errno(errno);
+        if (w == 0) break;
+    }
+    if (sentlen == 0) mp_raise_OSError(sock->timeout == 0 ? MP_EWOULDBLOCK : MP_ETIMEDOUT);
+    return sentlen;
+}
 
+int _socket_sendv(socket_obj_t *sock, struct iovec *iov, int iovcnt) {
+    // Sends all buffers in a single lwIP writev call per attempt
+    int sentlen = 0;
+    uint32_t start = mp_hal_ticks_ms();
+    while (iovcnt > 0) {
+        int r = LWIP_WRITEV(sock->fd, iov, iovcnt);
+        if (r > 0) {
+            _socket_count_sent(sock, r);
+            sentlen += r;
+            // Skip over what was sent
+            while (iovcnt > 0 && (size_t)r >= iov->iov_len) {
+                r -= iov->iov_len;
+                iov++;
+                iovcnt--;
+            }
+            if (iovcnt > 0) {
+                iov->iov_base = (uint8_t*)iov->iov_base + r;
+                iov->iov_len -= r;
+            }
+            continue;
+        }
         if (r < 0 && errno != EWOULDBLOCK) exception_from_errno(errno);
-        if (r > 0) sentlen += r;
-        check_for_exceptions();
+        int w = _socket_wait(sock, true, start);
+        if (w < 0) exception_from_errno(errno);
+        if (w == 0) break;
     }
-    if (sentlen == 0) mp_raise_OSError(MP_ETIMEDOUT);
+    if (sentlen == 0 && iovcnt > 0) mp_raise_OSError(sock->timeout == 0 ? MP_EWOULDBLOCK : MP_ETIMEDOUT);
     return sentlen;
 }
 
@@ -296,9 +579,44 @@ STATIC mp_obj_t socket_sendall(mp_obj_t self_in, mp_obj_t bytes) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_sendall_obj, &socket_sendall);
 
-// XXX this can end up waiting a very long time if the content is dribbled in one character
-// at a time, as the timeout resets each time a recvfrom succeeds ... this is probably not
-// good behaviour.
+// Vectored writes are a socket method only: mp_stream_p_t has a single
+// buffer write and extending it would touch py/stream and every port, so
+// stream users (uasyncio, ussl, write()) still send one buffer at a time.
+STATIC mp_obj_t socket_sendmsg(mp_obj_t self_in, mp_obj_t buffers) {
+    // ========================================
+    // Sends several buffers without joining them.
+    // Args:
+    //     buffers (list, tuple): buffers to send
+    //     in order;
+    // Returns:
+    //     The number of bytes sent.
+    // ========================================
+    socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    size_t len;
+    mp_obj_t *items;
+    mp_obj_get_array(buffers, &len, &items);
+    if (len > SOCKET_IOV_MAX) {
+        mp_raise_ValueError("Too many buffers");
+        return mp_const_none;
+    }
+
+    struct iovec iov[SOCKET_IOV_MAX];
+    int iovcnt = 0;
+    for (size_t i = 0; i < len; i++) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(items[i], &bufinfo, MP_BUFFER_READ);
+        if (bufinfo.len == 0) continue;
+        iov[iovcnt].iov_base = bufinfo.buf;
+        iov[iovcnt].iov_len = bufinfo.len;
+        iovcnt++;
+    }
+
+    return mp_obj_new_int(_socket_sendv(self, iov, iovcnt));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_sendmsg_obj, &socket_sendmsg);
+
 STATIC mp_uint_t _socket_read_data(mp_obj_t self_in, void *buf, size_t size,
     struct sockaddr *from, socklen_t *from_len, int *errcode) {
     socket_obj_t *sock = MP_OBJ_TO_PTR(self_in);
@@ -311,29 +629,18 @@ STATIC mp_uint_t _socket_read_data(mp_obj_t self_in, void *buf, size_t size,
         return 0;
     }
 
-    // XXX Would be nicer to use RTC to handle timeouts
-    for (int i = 0; i <= sock->retries; ++i) {
-        // Poll the socket to see if it has waiting data and only release the GIL if it doesn't.
-        // This ensures higher performance in the case of many small reads, eg for readline.
-        bool release_gil;
-        {
-            fd_set rfds;
-            FD_ZERO(&rfds);
-            FD_SET(sock->fd, &rfds);
-            struct timeval timeout = { .tv_sec = 0, .tv_usec = 0 };
-            int r = LWIP_SELECT(sock->fd + 1, &rfds, NULL, NULL, &timeout);
-            release_gil = r != 1;
-        }
-        if (release_gil) {
-            MP_THREAD_GIL_EXIT();
-        }
+    uint32_t start = mp_hal_ticks_ms();
+    for (;;) {
+        // The socket is non-blocking: data already received is returned at
+        // once and only an empty socket waits in _socket_wait, which keeps
+        // many small reads (eg readline) cheap.
         int r = LWIP_RECVFROM(sock->fd, buf, size, 0, from, from_len);
-        if (release_gil) {
-            MP_THREAD_GIL_ENTER();
-        }
         if (r == 0) {
             sock->peer_closed = true;
         }
+        if (r > 0) {
+            _socket_count_received(sock, r);
+        }
         if (r >= 0) {
             return r;
         }
@@ -341,10 +648,17 @@ STATIC mp_uint_t _socket_read_data(mp_obj_t self_in, void *buf, size_t size,
             *errcode = errno;
             return MP_STREAM_ERROR;
         }
-        check_for_exceptions();
+        int w = _socket_wait(sock, false, start);
+        if (w < 0) {
+            *errcode = errno;
+            return MP_STREAM_ERROR;
+        }
+        if (w == 0) {
+            break;
+        }
     }
 
-    *errcode = sock->retries == 0 ? MP_EWOULDBLOCK : MP_ETIMEDOUT;
+    *errcode = sock->timeout == 0 ? MP_EWOULDBLOCK : MP_ETIMEDOUT;
     return MP_STREAM_ERROR;
 }
 
@@ -360,7 +674,36 @@ mp_obj_t _socket_recvfrom(mp_obj_t self_in, mp_obj_t len_in, struct sockaddr *fr
     }
 
     vstr.len = r;
-    return mp_obj_new_str_from_vstr(&vstr);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+
+mp_obj_t _socket_recvfrom_into(size_t n_args, const mp_obj_t *args, struct sockaddr *from, socklen_t *from_len) {
+    // Reads into a caller-supplied buffer: args are (self, buf[, nbytes])
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+
+    size_t len = bufinfo.len;
+    if (n_args == 3) {
+        mp_int_t nbytes = mp_obj_get_int(args[2]);
+        if (nbytes < 0) {
+            mp_raise_ValueError("negative buffersize in recv_into");
+            return mp_const_none;
+        }
+        if ((size_t)nbytes > len) {
+            mp_raise_ValueError("buffer too small for requested bytes");
+            return mp_const_none;
+        }
+        if (nbytes > 0) {
+            len = nbytes;
+        }
+    }
+
+    int errcode;
+    mp_uint_t r = _socket_read_data(args[0], bufinfo.buf, len, from, from_len, &errcode);
+    if (r == MP_STREAM_ERROR) {
+        exception_from_errno(errcode);
+    }
+    return MP_OBJ_NEW_SMALL_INT(r);
 }
 
 STATIC mp_obj_t socket_recv(mp_obj_t self_in, mp_obj_t bufsize) {
@@ -374,6 +717,21 @@ STATIC mp_obj_t socket_recv(mp_obj_t self_in, mp_obj_t bufsize) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_recv_obj, &socket_recv);
 
+STATIC mp_obj_t socket_recv_into(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Receives bytes into a buffer.
+    // Args:
+    //     buf (bytearray, memoryview): output buffer;
+    //     nbytes (int): the maximal number of bytes
+    //     to receive (defaults to the buffer size);
+    // Returns:
+    //     The number of bytes received.
+    // ========================================
+    return _socket_recvfrom_into(n_args, args, NULL, NULL);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recv_into_obj, 2, 3, &socket_recv_into);
+
 STATIC mp_obj_t socket_sendto(mp_obj_t self_in, mp_obj_t bytes, mp_obj_t address) {
     // ========================================
     // Connects and sends bytes.
@@ -394,17 +752,21 @@ STATIC mp_obj_t socket_sendto(mp_obj_t self_in, mp_obj_t bytes, mp_obj_t address
     to.sin_port = LWIP_HTONS(netutils_parse_inet_addr(address, (uint8_t*)&to.sin_addr, NETUTILS_BIG));
 
     // send the data
-    for (int i=0; i<=self->retries; i++) {
-        MP_THREAD_GIL_EXIT();
+    uint32_t start = mp_hal_ticks_ms();
+    for (;;) {
         int ret = LWIP_SENDTO(self->fd, bufinfo.buf, bufinfo.len, 0, (struct sockaddr*)&to, sizeof(to));
-        MP_THREAD_GIL_ENTER();
-        if (ret > 0) return mp_obj_new_int_from_uint(ret);
+        if (ret > 0) {
+            _socket_count_sent(self, ret);
+            return mp_obj_new_int_from_uint(ret);
+        }
         if (ret == -1 && errno != EWOULDBLOCK) {
             exception_from_errno(errno);
         }
-        check_for_exceptions();
+        int w = _socket_wait(self, true, start);
+        if (w < 0) exception_from_errno(errno);
+        if (w == 0) break;
     }
-    mp_raise_OSError(MP_ETIMEDOUT); 
+    mp_raise_OSError(self->timeout == 0 ? MP_EWOULDBLOCK : MP_ETIMEDOUT);
     return mp_const_none;
 }
 
@@ -431,6 +793,44 @@ STATIC mp_obj_t socket_recvfrom(mp_obj_t self_in, mp_obj_t bufsize) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_recvfrom_obj, &socket_recvfrom);
 
+STATIC mp_obj_t socket_recvfrom_into(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Receives bytes into a buffer.
+    // Args:
+    //     buf (bytearray, memoryview): output buffer;
+    //     nbytes (int): the maximal number of bytes
+    //     to receive (defaults to the buffer size);
+    // Returns:
+    //     The number of bytes received and the
+    //     source address.
+    // ========================================
+    struct sockaddr from;
+    socklen_t fromlen = sizeof(from);
+
+    mp_obj_t tuple[2];
+    tuple[0] = _socket_recvfrom_into(n_args, args, &from, &fromlen);
+
+    uint8_t *ip = (uint8_t*)&((struct sockaddr_in*)&from)->sin_addr;
+    mp_uint_t port = LWIP_NTOHS(((struct sockaddr_in*)&from)->sin_port);
+    tuple[1] = netutils_format_inet_addr(ip, port, NETUTILS_BIG);
+
+    return mp_obj_new_tuple(2, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recvfrom_into_obj, 2, 3, &socket_recvfrom_into);
+
+STATIC bool _socket_opt_supported(int level, int opt) {
+    // Integer-valued options passed through to lwIP as-is
+    switch (level) {
+        case SOL_SOCKET:
+            return opt == SO_REUSEADDR || opt == SO_KEEPALIVE || opt == SO_SNDBUF || opt == SO_RCVBUF;
+        case IPPROTO_TCP:
+            return opt == TCP_NODELAY || opt == TCP_KEEPIDLE || opt == TCP_KEEPINTVL || opt == TCP_KEEPCNT;
+        default:
+            return false;
+    }
+}
+
 STATIC mp_obj_t socket_setsockopt(size_t n_args, const mp_obj_t *args) {
     // ========================================
     // Sets socket options.
@@ -442,21 +842,16 @@ STATIC mp_obj_t socket_setsockopt(size_t n_args, const mp_obj_t *args) {
     (void)n_args; // always 4
     socket_obj_t *self = MP_OBJ_TO_PTR(args[0]);
 
+    int level = mp_obj_get_int(args[1]);
     int opt = mp_obj_get_int(args[2]);
 
-    switch (opt) {
-        // level: SOL_SOCKET
-        case SO_REUSEADDR: {
-            int val = mp_obj_get_int(args[3]);
-            int ret = LWIP_SETSOCKOPT(self->fd, SOL_SOCKET, opt, &val, sizeof(int));
-            if (ret != 0) {
-                exception_from_errno(errno);
-            }
-            break;
-        }
+    if (!_socket_opt_supported(level, opt)) {
+        mp_raise_OSError(MP_EOPNOTSUPP);
+    }
 
-        default:
-            mp_printf(&mp_plat_print, "Warning: lwip.setsockopt() option not implemented\n");
+    int val = mp_obj_get_int(args[3]);
+    if (LWIP_SETSOCKOPT(self->fd, level, opt, &val, sizeof(int)) != 0) {
+        exception_from_errno(errno);
     }
 
     return mp_const_none;
@@ -464,6 +859,35 @@ STATIC mp_obj_t socket_setsockopt(size_t n_args, const mp_obj_t *args) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_setsockopt_obj, 4, 4, &socket_setsockopt);
 
+STATIC mp_obj_t socket_getsockopt(mp_obj_t self_in, mp_obj_t level_in, mp_obj_t opt_in) {
+    // ========================================
+    // Retrieves socket options.
+    // Args:
+    //     level (int): option level;
+    //     optname (int): option to retrieve;
+    // Returns:
+    //     The option value.
+    // ========================================
+    socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    int level = mp_obj_get_int(level_in);
+    int opt = mp_obj_get_int(opt_in);
+
+    if (!_socket_opt_supported(level, opt)) {
+        mp_raise_OSError(MP_EOPNOTSUPP);
+    }
+
+    int val = 0;
+    socklen_t len = sizeof(val);
+    if (LWIP_GETSOCKOPT(self->fd, level, opt, &val, &len) != 0) {
+        exception_from_errno(errno);
+    }
+
+    return mp_obj_new_int(val);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(socket_getsockopt_obj, socket_getsockopt);
+
 STATIC mp_obj_t socket_settimeout(mp_obj_t self_in, mp_obj_t value) {
     // ========================================
     // Sets the timeout for socket operations.
@@ -498,6 +922,21 @@ STATIC mp_obj_t socket_setblocking(mp_obj_t self_in, mp_obj_t flag) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_setblocking_obj, &socket_setblocking);
 
+STATIC mp_obj_t socket_stats(mp_obj_t self_in) {
+    // ========================================
+    // Retrieves traffic statistics of this socket.
+    // Returns:
+    //     Bytes sent and received, packets sent
+    //     and received, wait retries and timeouts.
+    // ========================================
+    socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t tuple[SOCKET_STATS_N];
+    _socket_stats_items(&self->stats, tuple);
+    return mp_obj_new_tuple(SOCKET_STATS_N, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(socket_stats_obj, &socket_stats);
+
 STATIC mp_obj_t socket_makefile(size_t n_args, const mp_obj_t *args) {
     // ========================================
     // Returns a file object associated with the socket.
@@ -523,15 +962,19 @@ STATIC mp_uint_t socket_stream_write(mp_obj_t self_in, const void *buf, mp_uint_
     // Stream: write.
     // ========================================
     socket_obj_t *sock = self_in;
-    for (int i=0; i<=sock->retries; i++) {
-        MP_THREAD_GIL_EXIT();
+    uint32_t start = mp_hal_ticks_ms();
+    for (;;) {
         int r = LWIP_WRITE(sock->fd, buf, size);
-        MP_THREAD_GIL_ENTER();
-        if (r > 0) return r;
+        if (r > 0) {
+            _socket_count_sent(sock, r);
+            return r;
+        }
         if (r < 0 && errno != EWOULDBLOCK) { *errcode = errno; return MP_STREAM_ERROR; }
-        check_for_exceptions();
+        int w = _socket_wait(sock, true, start);
+        if (w < 0) { *errcode = errno; return MP_STREAM_ERROR; }
+        if (w == 0) break;
     }
-    *errcode = sock->retries == 0 ? MP_EWOULDBLOCK : MP_ETIMEDOUT;
+    *errcode = sock->timeout == 0 ? MP_EWOULDBLOCK : MP_ETIMEDOUT;
     return MP_STREAM_ERROR;
 }
 
@@ -541,13 +984,17 @@ STATIC mp_uint_t socket_stream_ioctl(mp_obj_t self_in, mp_uint_t request, uintpt
     // ========================================
     socket_obj_t * socket = self_in;
     if (request == MP_STREAM_POLL) {
+        if (socket->fd < 0) {
+            return MP_STREAM_POLL_NVAL;
+        }
         fd_set rfds; FD_ZERO(&rfds);
         fd_set wfds; FD_ZERO(&wfds);
         fd_set efds; FD_ZERO(&efds);
         struct timeval timeout = { .tv_sec = 0, .tv_usec = 0 };
         if (arg & MP_STREAM_POLL_RD) FD_SET(socket->fd, &rfds);
         if (arg & MP_STREAM_POLL_WR) FD_SET(socket->fd, &wfds);
-        if (arg & MP_STREAM_POLL_HUP) FD_SET(socket->fd, &efds);
+        // Errors (eg a failed non-blocking connect) are always reported
+        FD_SET(socket->fd, &efds);
 
         int r = LWIP_SELECT((socket->fd)+1, &rfds, &wfds, &efds, &timeout);
         if (r < 0) {
@@ -558,7 +1005,7 @@ STATIC mp_uint_t socket_stream_ioctl(mp_obj_t self_in, mp_uint_t request, uintpt
         mp_uint_t ret = 0;
         if (FD_ISSET(socket->fd, &rfds)) ret |= MP_STREAM_POLL_RD;
         if (FD_ISSET(socket->fd, &wfds)) ret |= MP_STREAM_POLL_WR;
-        if (FD_ISSET(socket->fd, &efds)) ret |= MP_STREAM_POLL_HUP;
+        if (FD_ISSET(socket->fd, &efds)) ret |= MP_STREAM_POLL_ERR | (arg & MP_STREAM_POLL_HUP);
         return ret;
     } else if (request == MP_STREAM_CLOSE) {
         if (socket->fd >= 0) {
@@ -585,12 +1032,17 @@ STATIC const mp_rom_map_elem_t socket_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_connect), MP_ROM_PTR(&socket_connect_obj) },
     { MP_ROM_QSTR(MP_QSTR_send), MP_ROM_PTR(&socket_send_obj) },
     { MP_ROM_QSTR(MP_QSTR_sendall), MP_ROM_PTR(&socket_sendall_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sendmsg), MP_ROM_PTR(&socket_sendmsg_obj) },
     { MP_ROM_QSTR(MP_QSTR_recv), MP_ROM_PTR(&socket_recv_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recv_into), MP_ROM_PTR(&socket_recv_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_sendto), MP_ROM_PTR(&socket_sendto_obj) },
     { MP_ROM_QSTR(MP_QSTR_recvfrom), MP_ROM_PTR(&socket_recvfrom_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recvfrom_into), MP_ROM_PTR(&socket_recvfrom_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_setsockopt), MP_ROM_PTR(&socket_setsockopt_obj) },
+    { MP_ROM_QSTR(MP_QSTR_getsockopt), MP_ROM_PTR(&socket_getsockopt_obj) },
     { MP_ROM_QSTR(MP_QSTR_settimeout), MP_ROM_PTR(&socket_settimeout_obj) },
     { MP_ROM_QSTR(MP_QSTR_setblocking), MP_ROM_PTR(&socket_setblocking_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&socket_stats_obj) },
     { MP_ROM_QSTR(MP_QSTR_makefile), MP_ROM_PTR(&socket_makefile_obj) },
 
     { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&mp_stream_read_obj) },
@@ -608,7 +1060,7 @@ STATIC const mp_stream_p_t socket_stream_p = {
 };
 
 
-STATIC MP_DEFINE_CONST_OBJ_TYPE(
+MP_DEFINE_CONST_OBJ_TYPE(
     socket_type,
     MP_QSTR_socket,
     MP_TYPE_FLAG_NONE,
@@ -618,6 +1070,61 @@ STATIC MP_DEFINE_CONST_OBJ_TYPE(
 );
 
 
+void mp_uselect_port_wait(mp_map_t *poll_map, mp_uint_t timeout) {
+    // Waits for all sockets registered with uselect in one lwIP select
+    // instead of one zero-timeout select per socket and poll iteration.
+    // Other objects (UART, stdio) can only be polled, so the wait is
+    // capped at SOCKET_SELECT_FOREIGN_MS for them; SOCKET_POLL_US caps it
+    // anyway to keep checking for MicroPython interrupts. Without sockets the
+    // task sleeps for as long instead.
+    fd_set rfds; FD_ZERO(&rfds);
+    fd_set wfds; FD_ZERO(&wfds);
+    fd_set efds; FD_ZERO(&efds);
+    int maxfd = -1;
+    bool foreign = false;
+
+    for (size_t i = 0; i < poll_map->alloc; i++) {
+        if (!mp_map_slot_is_filled(poll_map, i)) {
+            continue;
+        }
+        poll_obj_t *poll_obj = MP_OBJ_TO_PTR(poll_map->table[i].value);
+        if (!poll_obj->flags) {
+            continue;
+        }
+        if (mp_obj_get_type(poll_obj->obj) != &socket_type) {
+            foreign = true;
+            continue;
+        }
+        socket_obj_t *sock = MP_OBJ_TO_PTR(poll_obj->obj);
+        if (sock->fd < 0) {
+            // closed sockets are reported by the ioctl right away
+            return;
+        }
+        if (poll_obj->flags & MP_STREAM_POLL_RD) FD_SET(sock->fd, &rfds);
+        if (poll_obj->flags & MP_STREAM_POLL_WR) FD_SET(sock->fd, &wfds);
+        FD_SET(sock->fd, &efds);
+        if (sock->fd > maxfd) maxfd = sock->fd;
+    }
+
+    mp_uint_t limit = foreign ? SOCKET_SELECT_FOREIGN_MS : SOCKET_POLL_US / 1000;
+    if (timeout > limit) {
+        timeout = limit;
+    }
+
+    if (maxfd < 0) {
+        // Nothing to select on: sleep rather than spin, running scheduled
+        // callbacks meanwhile
+        mp_hal_delay_ms(timeout);
+        return;
+    }
+
+    struct timeval tv = { .tv_sec = timeout / 1000, .tv_usec = (timeout % 1000) * 1000 };
+
+    MP_THREAD_GIL_EXIT();
+    LWIP_SELECT(maxfd + 1, &rfds, &wfds, &efds, &tv);
+    MP_THREAD_GIL_ENTER();
+}
+
 // -------
 // Methods
 // -------
@@ -667,13 +1174,9 @@ STATIC mp_obj_t getaddrinfo(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
     mp_obj_t host = args[ARG_host].u_obj;
     mp_obj_t port = mp_obj_new_int(args[ARG_port].u_int);
 
-    int af;
     switch (args[ARG_af].u_int) {
         case 0:
-            af = AF_INET;
-            break;
         case AF_INET:
-            af = AF_INET;
             break;
         case AF_INET6:
             mp_raise_ValueError("TODO argument #3: af=AF_INET6 is not implemented");
@@ -790,6 +1293,85 @@ STATIC mp_obj_t modusocket_get_num_open(void) {
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(modusocket_get_num_open_obj, modusocket_get_num_open);
 
+STATIC mp_obj_t modusocket_stats(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Retrieves traffic statistics of all sockets
+    // since boot or the last reset.
+    // Args:
+    //     reset (bool): resets the totals after
+    //     reading them;
+    // Returns:
+    //     Bytes sent and received, packets sent
+    //     and received, wait retries, timeouts and
+    //     the number of sockets open.
+    // ========================================
+    mp_obj_t tuple[SOCKET_STATS_N + 1];
+    _socket_stats_items(&socket_stats_total, tuple);
+    tuple[SOCKET_STATS_N] = mp_obj_new_int(num_sockets_open);
+    if (n_args == 1 && mp_obj_is_true(args[0])) {
+        memset(&socket_stats_total, 0, sizeof(socket_stats_total));
+    }
+    return mp_obj_new_tuple(SOCKET_STATS_N + 1, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modusocket_stats_obj, 0, 1, modusocket_stats);
+
+STATIC mp_obj_t modusocket_dns_cache_flush(void) {
+    // ========================================
+    // Drops all cached DNS records.
+    // ========================================
+    modusocket_dns_flush();
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modusocket_dns_cache_flush_obj, modusocket_dns_cache_flush);
+
+STATIC mp_obj_t modusocket_dns_cache_ttl(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Retrieves and sets the lifetime of cached
+    // DNS records.
+    // Args:
+    //     ttl (int): lifetime in ms; zero disables
+    //     the cache;
+    // Returns:
+    //     The lifetime in ms.
+    // ========================================
+    if (n_args == 1) {
+        mp_int_t ttl = mp_obj_get_int(args[0]);
+        if (ttl < 0) {
+            mp_raise_ValueError("The lifetime should be non-negative");
+            return mp_const_none;
+        }
+        dns_cache_ttl = ttl;
+        if (!ttl) modusocket_dns_flush();
+    }
+    return mp_obj_new_int_from_uint(dns_cache_ttl);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modusocket_dns_cache_ttl_obj, 0, 1, modusocket_dns_cache_ttl);
+
+STATIC mp_obj_t modusocket_dns_cache_stats(void) {
+    // ========================================
+    // Retrieves DNS cache statistics.
+    // Returns:
+    //     Cache hits, misses and the number of
+    //     live records.
+    // ========================================
+    int n = 0;
+    uint32_t now = mp_hal_ticks_ms();
+    for (int i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (dns_cache_valid(dns_cache + i, now)) n++;
+    }
+    mp_obj_t tuple[3] = {
+        mp_obj_new_int_from_uint(dns_cache_hits),
+        mp_obj_new_int_from_uint(dns_cache_misses),
+        mp_obj_new_int(n),
+    };
+    return mp_obj_new_tuple(3, tuple);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modusocket_dns_cache_stats_obj, modusocket_dns_cache_stats);
+
 STATIC const mp_map_elem_t mp_module_usocket_globals_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR_usocket) },
 
@@ -801,6 +1383,10 @@ STATIC const mp_map_elem_t mp_module_usocket_globals_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_inet_pton), (mp_obj_t)&modusocket_inet_pton_obj },
 
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_num_open), (mp_obj_t)&modusocket_get_num_open_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_stats), (mp_obj_t)&modusocket_stats_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_dns_cache_flush), (mp_obj_t)&modusocket_dns_cache_flush_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_dns_cache_ttl), (mp_obj_t)&modusocket_dns_cache_ttl_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_dns_cache_stats), (mp_obj_t)&modusocket_dns_cache_stats_obj },
 
     { MP_ROM_QSTR(MP_QSTR_AF_INET), MP_ROM_INT(AF_INET) },
     { MP_ROM_QSTR(MP_QSTR_AF_INET6), MP_ROM_INT(AF_INET6) },
@@ -810,6 +1396,16 @@ STATIC const mp_map_elem_t mp_module_usocket_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_IPPROTO_TCP), MP_ROM_INT(IPPROTO_TCP) },
     { MP_ROM_QSTR(MP_QSTR_IPPROTO_UDP), MP_ROM_INT(IPPROTO_UDP) },
     { MP_ROM_QSTR(MP_QSTR_IPPROTO_IP), MP_ROM_INT(IPPROTO_IP) },
+
+    { MP_ROM_QSTR(MP_QSTR_SOL_SOCKET), MP_ROM_INT(SOL_SOCKET) },
+    { MP_ROM_QSTR(MP_QSTR_SO_REUSEADDR), MP_ROM_INT(SO_REUSEADDR) },
+    { MP_ROM_QSTR(MP_QSTR_SO_KEEPALIVE), MP_ROM_INT(SO_KEEPALIVE) },
+    { MP_ROM_QSTR(MP_QSTR_SO_SNDBUF), MP_ROM_INT(SO_SNDBUF) },
+    { MP_ROM_QSTR(MP_QSTR_SO_RCVBUF), MP_ROM_INT(SO_RCVBUF) },
+    { MP_ROM_QSTR(MP_QSTR_TCP_NODELAY), MP_ROM_INT(TCP_NODELAY) },
+    { MP_ROM_QSTR(MP_QSTR_TCP_KEEPIDLE), MP_ROM_INT(TCP_KEEPIDLE) },
+    { MP_ROM_QSTR(MP_QSTR_TCP_KEEPINTVL), MP_ROM_INT(TCP_KEEPINTVL) },
+    { MP_ROM_QSTR(MP_QSTR_TCP_KEEPCNT), MP_ROM_INT(TCP_KEEPCNT) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_usocket_globals, mp_module_usocket_globals_table);
@@ -30,6 +30,8 @@
 #include "sdk_init.h"
 #include "api_inc_socket.h"
 
+#include "py/obj.h"
+
 #define LWIP_ACCEPT               CSDK_FUNC(lwip_accept)
 #define LWIP_BIND                 CSDK_FUNC(lwip_bind)
 #define LWIP_SHUTDOWN             CSDK_FUNC(lwip_shutdown)
@@ -70,3 +72,6 @@
 #define LWIP_NTOHS(x) PP_NTOHS(x)
 #define LWIP_NTOHL(x) PP_NTOHL(x)
 
+extern const mp_obj_type_t socket_type;
+
+void modusocket_dns_flush(void);
@@ -38,8 +38,10 @@
 // Python internal features
 #define MICROPY_PY_SYS_EXC_INFO             (1)
 #define MICROPY_ENABLE_COMPILER             (1)
-#define MICROPY_REPL_EVENT_DRIVEN           (0)
+#define MICROPY_REPL_EVENT_DRIVEN           (1)
 #define MICROPY_ENABLE_GC                   (1)
+#define MICROPY_GC_SPLIT_HEAP               (1)
+#define MICROPY_GC_SPLIT_HEAP_AUTO          (1)
 #define MICROPY_LONGINT_IMPL                (MICROPY_LONGINT_IMPL_MPZ)
 #define MICROPY_FLOAT_IMPL                  (MICROPY_FLOAT_IMPL_DOUBLE)
 #define MICROPY_MODULE_FROZEN_MPY           (1)
@@ -67,7 +69,19 @@
 #define MICROPY_SCHEDULER_DEPTH             (8)
 #define MICROPY_COMP_CONST                  (1)
 #define MICROPY_BEGIN_ATOMIC_SECTION()      SYS_EnterCriticalSection()
+#if MICROPY_REPL_EVENT_DRIVEN
+// Wake-ups flagged inside the section are posted once it is left
+#define MICROPY_END_ATOMIC_SECTION(state) \
+    do { \
+        extern volatile uint8_t mp_hal_wake_pending; \
+        extern void mp_hal_wake_scheduled(void); \
+        SYS_ExitCriticalSection(state); \
+        if (mp_hal_wake_pending) \
+            mp_hal_wake_scheduled(); \
+    } while (0)
+#else
 #define MICROPY_END_ATOMIC_SECTION(state)   SYS_ExitCriticalSection(state)
+#endif
 
 // MCU definition
 #define MP_ENDIANNESS_LITTLE                (1)
@@ -131,6 +145,10 @@
 #define MICROPY_PY_SYS_STDFILES             (1)
 #define MICROPY_PY_UERRNO                   (1)
 #define MICROPY_PY_USELECT                  (1)
+#define MICROPY_PY_USELECT_PORT_WAIT        (1)
+#define MICROPY_PY_UHTTP_POOL_SIZE          (4)
+#define MICROPY_PY_CELLULAR_EVENT_QUEUE     (32)
+#define MICROPY_PY_CELLULAR_SIGNAL_HISTORY  (64)
 #define MICROPY_PY_UTIME_MP_HAL             (1)
 #define MICROPY_PY_THREAD                   (0)
 #define MICROPY_PY_THREAD_GIL               (0)
@@ -206,10 +224,18 @@
 // different targets may be defined in different ways - either as int
 // or as long. This requires different printf formatting specifiers
 // to print such value. So, we avoid int32_t and use int directly.
+#if MICROPY_GPRS_A9_SIM
+// The host simulation (see sim/) is built for 64-bit Linux
+#define UINT_FMT "%lu"
+#define INT_FMT "%ld"
+typedef long mp_int_t; // must be pointer size
+typedef unsigned long mp_uint_t; // must be pointer size
+#else
 #define UINT_FMT "%u"
 #define INT_FMT "%d"
 typedef int32_t  mp_int_t; // must be pointer size
 typedef uint32_t mp_uint_t; // must be pointer size
+#endif
 
 typedef long mp_off_t;
 
@@ -240,6 +266,30 @@ typedef long mp_off_t;
     } while (0);
 #endif
 
+#if MICROPY_GPRS_A9_SIM
+// The simulated SDK task preempts the interpreter only at these points
+#define MICROPY_VM_HOOK_COUNT (64)
+#define MICROPY_VM_HOOK_INIT static uint vm_hook_divisor = MICROPY_VM_HOOK_COUNT;
+#define MICROPY_VM_HOOK_POLL if (--vm_hook_divisor == 0) { \
+        vm_hook_divisor = MICROPY_VM_HOOK_COUNT; \
+        extern void sim_os_preempt(void); \
+        sim_os_preempt(); \
+    }
+#define MICROPY_VM_HOOK_LOOP MICROPY_VM_HOOK_POLL
+#define MICROPY_VM_HOOK_RETURN MICROPY_VM_HOOK_POLL
+#endif
+
+#if MICROPY_REPL_EVENT_DRIVEN
+// Wakes up the MicroPython task idling in the event-driven REPL. The hook
+// runs in the atomic section of the scheduler: it only flags the wake-up,
+// which MICROPY_END_ATOMIC_SECTION posts
+#define MICROPY_SCHED_HOOK_SCHEDULED \
+    do { \
+        extern volatile uint8_t mp_hal_wake_pending; \
+        mp_hal_wake_pending = 1; \
+    } while (0)
+#endif
+
 #endif
 
 #if MICROPY_DEBUG_VERBOSE
@@ -84,15 +84,15 @@ void mp_hal_stdout_tx_strn_cooked(const char *str, uint32_t len) {
     }
 }
 
-uint32_t mp_hal_ticks_ms(void) {
+mp_uint_t mp_hal_ticks_ms(void) {
     return (uint32_t)(clock() / CLOCKS_PER_MSEC);
 }
 
-uint32_t mp_hal_ticks_us(void) {
+mp_uint_t mp_hal_ticks_us(void) {
     return (uint32_t)(clock() / CLOCKS_PER_MSEC * 1000);
 }
 
-void mp_hal_delay_ms(uint32_t ms) {
+void mp_hal_delay_ms(mp_uint_t ms) {
     uint32_t start = clock();
     while (clock() - start < ms * CLOCKS_PER_MSEC) {
         OS_Sleep(1);
@@ -100,7 +100,7 @@ void mp_hal_delay_ms(uint32_t ms) {
     }
 }
 
-void mp_hal_delay_us(uint32_t us) {
+void mp_hal_delay_us(mp_uint_t us) {
     uint32_t start = clock();
     while ((clock() - start) * 1000 < us * CLOCKS_PER_MSEC) {
         MICROPY_EVENT_POLL_HOOK
@@ -44,13 +44,14 @@ extern int uart_attached_to_dupterm[UART_NPORTS];
 
 void mp_hal_set_interrupt_char(int c);
 void mp_hal_pyrepl_uart_init();
+void mp_hal_wake_stdin(void);
 
-uint32_t mp_hal_ticks_ms(void);
-uint32_t mp_hal_ticks_us(void);
-void mp_hal_delay_ms(uint32_t ms);
-void mp_hal_delay_us(uint32_t us);
+mp_uint_t mp_hal_ticks_ms(void);
+mp_uint_t mp_hal_ticks_us(void);
+void mp_hal_delay_ms(mp_uint_t ms);
+void mp_hal_delay_us(mp_uint_t us);
 void mp_hal_delay_us_fast(uint32_t us);
-__attribute__((always_inline)) static inline uint32_t mp_hal_ticks_cpu(void) {
+__attribute__((always_inline)) static inline mp_uint_t mp_hal_ticks_cpu(void) {
   return clock();
 }
 
@@ -26,6 +26,13 @@
  * THE SOFTWARE.
  */
 
+#if MICROPY_GPRS_A9_SIM
+// The host simulation uses the errno of the host C library (the lwIP errno
+// values included by the port are the same as on Linux)
+extern int *__errno_location(void);
+#define errno (*__errno_location())
+#else
 // This file is a fucking shame and it may work only with a particular SDK version
 #define errno (*((volatile int *) 0x820a0cb0))
+#endif
 
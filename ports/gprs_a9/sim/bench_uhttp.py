@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+#
+# This file is part of the MicroPython project, http://micropython.org/
+#
+# The MIT License (MIT)
+
+# Requests per second of uhttp against a local HTTP server, with the
+# connection pool and with a new connection for every request:
+#
+#   make -C sim && sim/bench_uhttp.py [-n REQUESTS] [--size BYTES]
+#
+# The server runs in this process and answers every request with a body of
+# --size bytes over HTTP/1.1 keep-alive.
+
+import argparse
+import http.server
+import os
+import sys
+import threading
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "../../../tools"))
+import pyboard
+
+SCRIPT = """
+import uhttp, utime
+def run(url, n, pooled):
+    uhttp.close()
+    t = utime.ticks_ms()
+    for i in range(n):
+        status, headers, body = uhttp.request("GET", url)
+        assert status == 200 and len(body) == {size}
+        if not pooled:
+            uhttp.close()
+    return n * 1000 / max(1, utime.ticks_diff(utime.ticks_ms(), t))
+url = "http://127.0.0.1:{port}/"
+run(url, 10, True)
+fresh = run(url, {n}, False)
+pooled = run(url, {n}, True)
+print("new connection: %.0f requests/s" % fresh)
+print("pooled: %.0f requests/s (x%.1f)" % (pooled, pooled / fresh))
+print("stats:", uhttp.stats())
+"""
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    # one write per response: no Nagle delay between headers and body
+    wbufsize = -1
+    body = b""
+
+    def do_GET(self):
+        self.send_response(200)
+        self.send_header("Content-Length", str(len(self.body)))
+        self.end_headers()
+        self.wfile.write(self.body)
+
+    def log_message(self, *args):
+        pass
+
+
+def main():
+    cmd_parser = argparse.ArgumentParser(description=__doc__)
+    cmd_parser.add_argument("-n", type=int, default=200, help="requests per run")
+    cmd_parser.add_argument("--size", type=int, default=256, help="response body size")
+    cmd_parser.add_argument(
+        "--firmware", default=os.path.join(HERE, "build/firmware.elf"), help="simulation binary"
+    )
+    args = cmd_parser.parse_args()
+
+    Handler.body = b"x" * args.size
+    server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+
+    board = pyboard.Pyboard("exec:" + args.firmware)
+    try:
+        board.enter_raw_repl()
+        script = SCRIPT.format(port=server.server_address[1], n=args.n, size=args.size)
+        board.exec_(script, data_consumer=pyboard.stdout_write_bytes)
+        board.exit_raw_repl()
+    finally:
+        board.close()
+        server.shutdown()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,11 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_CALL_H
+#define __API_CALL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+bool CALL_Dial(const char *number);
+bool CALL_HangUp(void);
+
+#endif
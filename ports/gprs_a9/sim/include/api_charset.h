@@ -0,0 +1,10 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_CHARSET_H
+#define __API_CHARSET_H
+
+typedef enum {
+    CHARSET_CP936 = 0,
+    CHARSET_UTF_8,
+} Charset_t;
+
+#endif
@@ -0,0 +1,11 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_DEBUG_H
+#define __API_DEBUG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void Trace(uint16_t level, const char *fmt, ...);
+void Assert(bool condition, const char *msg);
+
+#endif
@@ -0,0 +1,56 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_EVENT_H
+#define __API_EVENT_H
+
+#include <stdint.h>
+
+#include "api_hal_pm.h"
+
+typedef enum {
+    API_EVENT_ID_POWER_ON = 0,
+    API_EVENT_ID_SYSTEM_READY,
+    API_EVENT_ID_NO_SIMCARD,
+    API_EVENT_ID_SIMCARD_DROP,
+    API_EVENT_ID_NETWORK_REGISTERED_HOME,
+    API_EVENT_ID_NETWORK_REGISTERED_ROAMING,
+    API_EVENT_ID_NETWORK_REGISTER_SEARCHING,
+    API_EVENT_ID_NETWORK_REGISTER_DENIED,
+    API_EVENT_ID_NETWORK_REGISTER_NO,
+    API_EVENT_ID_NETWORK_DEREGISTER,
+    API_EVENT_ID_NETWORK_DETACHED,
+    API_EVENT_ID_NETWORK_ATTACH_FAILED,
+    API_EVENT_ID_NETWORK_ATTACHED,
+    API_EVENT_ID_NETWORK_DEACTIVED,
+    API_EVENT_ID_NETWORK_ACTIVATE_FAILED,
+    API_EVENT_ID_NETWORK_ACTIVATED,
+    API_EVENT_ID_NETWORK_GOT_TIME,
+    API_EVENT_ID_NETWORK_CELL_INFO,
+    API_EVENT_ID_NETWORK_AVAILABEL_OPERATOR,
+    API_EVENT_ID_SIGNAL_QUALITY,
+    API_EVENT_ID_SMS_SENT,
+    API_EVENT_ID_SMS_RECEIVED,
+    API_EVENT_ID_SMS_ERROR,
+    API_EVENT_ID_SMS_LIST_MESSAGE,
+    API_EVENT_ID_UART_RECEIVED,
+    API_EVENT_ID_GPS_UART_RECEIVED,
+    API_EVENT_ID_CALL_INCOMING,
+    API_EVENT_ID_CALL_HANGUP,
+    API_EVENT_ID_CALL_ANSWER,
+    API_EVENT_ID_CALL_DIAL,
+    API_EVENT_ID_USSD_SEND_SUCCESS,
+    API_EVENT_ID_USSD_SEND_FAIL,
+    API_EVENT_ID_USSD_IND,
+    API_EVENT_ID_KEY_DOWN,
+    API_EVENT_ID_KEY_UP,
+    API_EVENT_ID_MAX
+} API_Event_ID_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t param1;
+    uint32_t param2;
+    uint8_t* pParam1;
+    uint8_t* pParam2;
+} API_Event_t;
+
+#endif
@@ -0,0 +1,54 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_FS_H
+#define __API_FS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FS_O_RDONLY     0x0000
+#define FS_O_WRONLY     0x0001
+#define FS_O_RDWR       0x0002
+#define FS_O_ACCMODE    0x0003
+#define FS_O_CREAT      0x0100
+#define FS_O_EXCL       0x0200
+#define FS_O_TRUNC      0x1000
+#define FS_O_APPEND     0x2000
+
+#define FS_SEEK_SET     0
+#define FS_SEEK_CUR     1
+#define FS_SEEK_END     2
+
+#define FS_FILE_NAME_MAX_LEN 255
+
+typedef struct {
+    int32_t d_ino;
+    uint8_t d_type;
+    char d_name[FS_FILE_NAME_MAX_LEN + 1];
+} Dirent_t;
+
+typedef struct _Dir_t Dir_t;
+
+typedef struct {
+    uint64_t totalSize;
+    uint64_t usedSize;
+} API_FS_INFO;
+
+int32_t API_FS_Open(const char *fileName, uint32_t operationFlag, uint32_t mode);
+int32_t API_FS_Close(int32_t fd);
+int32_t API_FS_Read(int32_t fd, uint8_t *pBuffer, uint32_t length);
+int32_t API_FS_Write(int32_t fd, uint8_t *pBuffer, uint32_t length);
+int64_t API_FS_Seek(int32_t fd, int64_t offset, uint8_t origin);
+int32_t API_FS_Flush(int32_t fd);
+int32_t API_FS_GetFileSize(int32_t fd);
+int32_t API_FS_Delete(const char *fileName);
+int32_t API_FS_Rename(const char *oldName, const char *newName);
+int32_t API_FS_Mkdir(const char *dirName, uint32_t mode);
+int32_t API_FS_Rmdir(const char *dirName);
+int32_t API_FS_ChangeDir(const char *dirName);
+int32_t API_FS_GetCurDir(uint32_t size, char *curDir);
+int32_t API_FS_GetFSInfo(const char *path, API_FS_INFO *fsInfo);
+Dir_t* API_FS_OpenDir(const char *name);
+const Dirent_t* API_FS_ReadDir(Dir_t *pDir);
+int32_t API_FS_CloseDir(Dir_t *pDir);
+
+#endif
@@ -0,0 +1,7 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_GPS_H
+#define __API_GPS_H
+
+#include "gps.h"
+
+#endif
@@ -0,0 +1,35 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_HAL_ADC_H
+#define __API_HAL_ADC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    ADC_CHANNEL_0 = 0,
+    ADC_CHANNEL_1,
+    ADC_CHANNEL_MAX
+} ADC_Channel_t;
+
+typedef enum {
+    ADC_SAMPLE_PERIOD_122US = 0,
+    ADC_SAMPLE_PERIOD_1MS,
+    ADC_SAMPLE_PERIOD_10MS,
+    ADC_SAMPLE_PERIOD_100MS,
+    ADC_SAMPLE_PERIOD_250MS,
+    ADC_SAMPLE_PERIOD_500MS,
+    ADC_SAMPLE_PERIOD_1S,
+    ADC_SAMPLE_PERIOD_2S,
+    ADC_SAMPLE_PERIOD_MAX
+} ADC_Sample_Period_t;
+
+typedef struct {
+    ADC_Channel_t channel;
+    ADC_Sample_Period_t samplePeriod;
+} ADC_Config_t;
+
+void ADC_Init(ADC_Config_t config);
+bool ADC_Read(ADC_Channel_t channel, uint16_t *value, uint16_t *mV);
+void ADC_Close(ADC_Channel_t channel);
+
+#endif
@@ -0,0 +1,16 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_HAL_FLASH_H
+#define __API_HAL_FLASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// The simulated flash is a host memory block
+extern uint8_t sim_flash[];
+#define HAL_SPI_FLASH_UNCACHE_ADDRESS(offset) (sim_flash + (offset))
+
+bool hal_SpiFlashWrite(uint32_t flashAddress, const uint8_t *buffer, uint32_t byteSize);
+bool hal_SpiFlashErase(uint32_t flashAddress, uint32_t size);
+uint32_t hal_SpiFlashGetSize(void);
+
+#endif
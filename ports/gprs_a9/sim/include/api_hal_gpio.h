@@ -0,0 +1,42 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_HAL_GPIO_H
+#define __API_HAL_GPIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    GPIO_PIN0 = 0, GPIO_PIN1, GPIO_PIN2, GPIO_PIN3, GPIO_PIN4, GPIO_PIN5, GPIO_PIN6,
+    GPIO_PIN7, GPIO_PIN8, GPIO_PIN9, GPIO_PIN10, GPIO_PIN11, GPIO_PIN12, GPIO_PIN13,
+    GPIO_PIN14, GPIO_PIN15, GPIO_PIN16, GPIO_PIN17, GPIO_PIN18, GPIO_PIN19, GPIO_PIN20,
+    GPIO_PIN21, GPIO_PIN22, GPIO_PIN23, GPIO_PIN24, GPIO_PIN25, GPIO_PIN26, GPIO_PIN27,
+    GPIO_PIN28, GPIO_PIN29, GPIO_PIN30, GPIO_PIN31, GPIO_PIN32, GPIO_PIN33, GPIO_PIN34,
+    GPIO_PIN_MAX
+} GPIO_PIN;
+
+typedef enum {
+    GPIO_MODE_INPUT = 0,
+    GPIO_MODE_INPUT_INT,
+    GPIO_MODE_OUTPUT,
+    GPIO_MODE_MAX
+} GPIO_MODE;
+
+typedef enum {
+    GPIO_LEVEL_LOW = 0,
+    GPIO_LEVEL_HIGH,
+    GPIO_LEVEL_UNSET
+} GPIO_LEVEL;
+
+typedef struct {
+    GPIO_PIN pin;
+    GPIO_MODE mode;
+    GPIO_LEVEL defaultLevel;
+} GPIO_config_t;
+
+bool GPIO_Init(GPIO_config_t config);
+bool GPIO_Close(GPIO_PIN pin);
+bool GPIO_Set(GPIO_PIN pin, GPIO_LEVEL level);
+bool GPIO_Get(GPIO_PIN pin, GPIO_LEVEL *level);
+bool GPIO_ChangeMode(GPIO_PIN pin, GPIO_MODE mode);
+
+#endif
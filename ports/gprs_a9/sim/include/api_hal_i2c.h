@@ -0,0 +1,42 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_HAL_I2C_H
+#define __API_HAL_I2C_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define I2C_DEFAULT_TIME_OUT 10
+
+typedef enum {
+    I2C1 = 1,
+    I2C2 = 2,
+    I2C3 = 3,
+} I2C_ID_t;
+
+typedef enum {
+    I2C_FREQ_100K = 100,
+    I2C_FREQ_400K = 400,
+} I2C_FREQ_t;
+
+typedef enum {
+    I2C_ERROR_NONE = 0,
+    I2C_ERROR_RESOURCE_RESET,
+    I2C_ERROR_RESOURCE_BUSY,
+    I2C_ERROR_RESOURCE_TIMEOUT,
+    I2C_ERROR_RESOURCE_NOT_ENABLED,
+    I2C_ERROR_BAD_PARAMETER,
+    I2C_ERROR_COMMUNICATION_FAILED,
+} I2C_Error_t;
+
+typedef struct {
+    I2C_FREQ_t freq;
+} I2C_Config_t;
+
+bool I2C_Init(I2C_ID_t i2c, I2C_Config_t config);
+I2C_Error_t I2C_Transmit(I2C_ID_t i2c, uint16_t slaveAddr, uint8_t *pData, uint16_t length, uint32_t timeOut);
+I2C_Error_t I2C_Receive(I2C_ID_t i2c, uint16_t slaveAddr, uint8_t *pData, uint16_t length, uint32_t timeOut);
+I2C_Error_t I2C_WriteMem(I2C_ID_t i2c, uint16_t slaveAddr, uint32_t memAddr, uint8_t memSize, uint8_t *pData, uint16_t length, uint32_t timeOut);
+I2C_Error_t I2C_ReadMem(I2C_ID_t i2c, uint16_t slaveAddr, uint32_t memAddr, uint8_t memSize, uint8_t *pData, uint16_t length, uint32_t timeOut);
+bool I2C_Close(I2C_ID_t i2c);
+
+#endif
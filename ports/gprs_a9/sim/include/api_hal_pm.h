@@ -0,0 +1,51 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_HAL_PM_H
+#define __API_HAL_PM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    PM_SYS_FREQ_32K = 32768,
+    PM_SYS_FREQ_13M = 13000000,
+    PM_SYS_FREQ_26M = 26000000,
+    PM_SYS_FREQ_39M = 39000000,
+    PM_SYS_FREQ_52M = 52000000,
+    PM_SYS_FREQ_78M = 78000000,
+    PM_SYS_FREQ_89M = 89142857,
+    PM_SYS_FREQ_104M = 104000000,
+    PM_SYS_FREQ_113M = 113454545,
+    PM_SYS_FREQ_125M = 124800000,
+    PM_SYS_FREQ_139M = 138666666,
+    PM_SYS_FREQ_156M = 156000000,
+    PM_SYS_FREQ_178M = 178285714,
+    PM_SYS_FREQ_208M = 208000000,
+    PM_SYS_FREQ_250M = 249600000,
+    PM_SYS_FREQ_312M = 312000000,
+} PM_Sys_Freq_t;
+
+typedef enum {
+    POWER_TYPE_VPAD = 0,
+    POWER_TYPE_MMC,
+    POWER_TYPE_LCD,
+    POWER_TYPE_CAM,
+    POWER_TYPE_MAX
+} Power_Type_t;
+
+typedef enum {
+    POWER_ON_CAUSE_KEY = 0,
+    POWER_ON_CAUSE_CHARGE,
+    POWER_ON_CAUSE_ALARM,
+    POWER_ON_CAUSE_EXCEPTION,
+    POWER_ON_CAUSE_RESET,
+    POWER_ON_CAUSE_MAX
+} Power_On_Cause_t;
+
+void PM_SetSysMinFreq(PM_Sys_Freq_t freq);
+bool PM_PowerEnable(Power_Type_t type, bool isOn);
+void PM_Restart(void);
+void PM_ShutDown(void);
+bool PM_SleepMode(bool enable);
+uint16_t PM_Voltage(uint8_t *percent);
+
+#endif
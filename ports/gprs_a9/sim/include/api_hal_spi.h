@@ -0,0 +1,8 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_HAL_SPI_H
+#define __API_HAL_SPI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#endif
@@ -0,0 +1,75 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_HAL_UART_H
+#define __API_HAL_UART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    UART1 = 1,
+    UART2 = 2,
+    UART_PORT_MAX
+} UART_Port_t;
+
+typedef enum {
+    UART_BAUD_RATE_1200 = 1200,
+    UART_BAUD_RATE_2400 = 2400,
+    UART_BAUD_RATE_4800 = 4800,
+    UART_BAUD_RATE_9600 = 9600,
+    UART_BAUD_RATE_14400 = 14400,
+    UART_BAUD_RATE_19200 = 19200,
+    UART_BAUD_RATE_28800 = 28800,
+    UART_BAUD_RATE_33600 = 33600,
+    UART_BAUD_RATE_38400 = 38400,
+    UART_BAUD_RATE_57600 = 57600,
+    UART_BAUD_RATE_115200 = 115200,
+    UART_BAUD_RATE_230400 = 230400,
+    UART_BAUD_RATE_460800 = 460800,
+    UART_BAUD_RATE_921600 = 921600,
+    UART_BAUD_RATE_1300000 = 1300000,
+    UART_BAUD_RATE_1625000 = 1625000,
+    UART_BAUD_RATE_2166700 = 2166700,
+    UART_BAUD_RATE_3250000 = 3250000,
+} UART_Baud_Rate_t;
+
+typedef enum {
+    UART_DATA_BITS_7 = 7,
+    UART_DATA_BITS_8 = 8,
+} UART_Data_Bits_t;
+
+typedef enum {
+    UART_STOP_BITS_1 = 1,
+    UART_STOP_BITS_2 = 2,
+} UART_Stop_Bits_t;
+
+typedef enum {
+    UART_PARITY_NONE = 0,
+    UART_PARITY_ODD,
+    UART_PARITY_EVEN,
+    UART_PARITY_SPACE,
+    UART_PARITY_MARK,
+} UART_Parity_t;
+
+typedef struct {
+    UART_Port_t port;
+    uint32_t length;
+    uint8_t* buf;
+} UART_Callback_Param_t;
+
+typedef void (*UART_Callback_t)(UART_Callback_Param_t param);
+
+typedef struct {
+    UART_Baud_Rate_t baudRate;
+    UART_Data_Bits_t dataBits;
+    UART_Stop_Bits_t stopBits;
+    UART_Parity_t parity;
+    UART_Callback_t rxCallback;
+    bool useEvent;
+} UART_Config_t;
+
+bool UART_Init(UART_Port_t uartN, UART_Config_t config);
+uint32_t UART_Write(UART_Port_t uartN, uint8_t* data, uint32_t length);
+uint32_t UART_Read(UART_Port_t uartN, uint8_t* data, uint32_t length, uint32_t timeOutMs);
+bool UART_Close(UART_Port_t uartN);
+
+#endif
@@ -0,0 +1,14 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_HAL_WATCHDOG_H
+#define __API_HAL_WATCHDOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WATCHDOG_SECOND_TO_TICK(s) ((s) * 16384)
+
+bool WatchDog_Open(uint32_t ticks);
+void WatchDog_Close(void);
+void WatchDog_KeepAlive(void);
+
+#endif
@@ -0,0 +1,51 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_INC_NETWORK_H
+#define __API_INC_NETWORK_H
+
+#include <stdint.h>
+
+typedef enum {
+    NETWORK_FREQ_BAND_GSM_900P = 1 << 0,
+    NETWORK_FREQ_BAND_GSM_900E = 1 << 1,
+    NETWORK_FREQ_BAND_GSM_850 = 1 << 2,
+    NETWORK_FREQ_BAND_DCS_1800 = 1 << 3,
+    NETWORK_FREQ_BAND_PCS_1900 = 1 << 4,
+} Network_Freq_Band_t;
+
+typedef enum {
+    NETWORK_REGISTER_MODE_MANUAL = 0,
+    NETWORK_REGISTER_MODE_AUTO = 1,
+    NETWORK_REGISTER_MODE_MANUAL_AUTO = 4,
+} Network_Register_Mode_t;
+
+typedef struct {
+    char apn[40];
+    char userName[20];
+    char userPasswd[20];
+} Network_PDP_Context_t;
+
+typedef struct {
+    uint8_t sMcc[3];
+    uint8_t sMnc[3];
+    uint16_t sLac;
+    uint32_t sCellID;
+    uint8_t iBsic;
+    uint8_t iRxLev;
+    uint8_t iRxLevSub;
+    uint16_t nArfcn;
+    uint16_t nTSM_Timing;
+} Network_Location_t;
+
+typedef enum {
+    NETWORK_OPERATOR_STATUS_UNKNOWN = 0,
+    NETWORK_OPERATOR_STATUS_AVAILABLE,
+    NETWORK_OPERATOR_STATUS_CURRENT,
+    NETWORK_OPERATOR_STATUS_DISABLE,
+} Network_Operator_Status_t;
+
+typedef struct {
+    uint8_t operatorId[6];
+    Network_Operator_Status_t status;
+} Network_Operator_Info_t;
+
+#endif
@@ -0,0 +1,118 @@
+// Host simulation: stand-in for the CSDK header of the same name
+//
+// Structures and constants follow lwIP; sim_lwip.c translates them to the
+// host socket API. Socket descriptors are host descriptors, so fd_set and
+// select() are the host ones.
+#ifndef __API_INC_SOCKET_H
+#define __API_INC_SOCKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/select.h>
+#include <sys/uio.h>
+
+#ifndef __socklen_t_defined
+typedef __socklen_t socklen_t;
+#define __socklen_t_defined
+#endif
+
+typedef uint8_t sa_family_t;
+typedef uint16_t in_port_t;
+typedef uint32_t in_addr_t;
+
+typedef struct ip4_addr {
+    uint32_t addr;
+} ip4_addr_t;
+
+struct in_addr {
+    in_addr_t s_addr;
+};
+
+struct sockaddr {
+    uint8_t sa_len;
+    sa_family_t sa_family;
+    char sa_data[14];
+};
+
+struct sockaddr_in {
+    uint8_t sin_len;
+    sa_family_t sin_family;
+    in_port_t sin_port;
+    struct in_addr sin_addr;
+    char sin_zero[8];
+};
+
+#define AF_UNSPEC       0
+#define AF_INET         2
+#define AF_INET6        10
+#define PF_INET         AF_INET
+#define PF_INET6        AF_INET6
+
+#define SOCK_STREAM     1
+#define SOCK_DGRAM      2
+#define SOCK_RAW        3
+
+#define IPPROTO_IP      0
+#define IPPROTO_ICMP    1
+#define IPPROTO_TCP     6
+#define IPPROTO_UDP     17
+
+#define SOL_SOCKET      0xfff
+#define SO_REUSEADDR    0x0004
+#define SO_KEEPALIVE    0x0008
+#define SO_BROADCAST    0x0020
+#define SO_SNDBUF       0x1001
+#define SO_RCVBUF       0x1002
+#define SO_ERROR        0x1007
+
+#define TCP_NODELAY     0x01
+#define TCP_KEEPALIVE   0x02
+#define TCP_KEEPIDLE    0x03
+#define TCP_KEEPINTVL   0x04
+#define TCP_KEEPCNT     0x05
+
+#define MSG_PEEK        0x01
+#define MSG_WAITALL     0x02
+#define MSG_OOB         0x04
+#define MSG_DONTWAIT    0x08
+#define MSG_MORE        0x10
+
+#define SHUT_RD         0
+#define SHUT_WR         1
+#define SHUT_RDWR       2
+
+#define F_GETFL         3
+#define F_SETFL         4
+#define O_NONBLOCK      1
+
+#define PP_HTONS(x) ((uint16_t)((((x) & 0x00ffUL) << 8) | (((x) & 0xff00UL) >> 8)))
+#define PP_NTOHS(x) PP_HTONS(x)
+#define PP_HTONL(x) ((((x) & 0x000000ffUL) << 24) | \
+                     (((x) & 0x0000ff00UL) <<  8) | \
+                     (((x) & 0x00ff0000UL) >>  8) | \
+                     (((x) & 0xff000000UL) >> 24))
+#define PP_NTOHL(x) PP_HTONL(x)
+
+int lwip_socket(int domain, int type, int protocol);
+int lwip_bind(int s, const struct sockaddr *name, socklen_t namelen);
+int lwip_listen(int s, int backlog);
+int lwip_accept(int s, struct sockaddr *addr, socklen_t *addrlen);
+int lwip_connect(int s, const struct sockaddr *name, socklen_t namelen);
+int lwip_close(int s);
+int lwip_getsockopt(int s, int level, int optname, void *optval, socklen_t *optlen);
+int lwip_setsockopt(int s, int level, int optname, const void *optval, socklen_t optlen);
+int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen);
+int lwip_write(int s, const void *dataptr, size_t size);
+int lwip_writev(int s, const struct iovec *iov, int iovcnt);
+int lwip_sendto(int s, const void *dataptr, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
+int lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, struct timeval *timeout);
+int lwip_fcntl(int s, int cmd, int val);
+
+int ip4addr_aton(const char *cp, ip4_addr_t *addr);
+char *ip4addr_ntoa_r(const ip4_addr_t *addr, char *buf, int buflen);
+
+// Resolves hostname into a dotted quad in ip; returns zero on success
+int DNS_GetHostByName2(uint8_t *hostname, uint8_t *ip);
+
+#endif
@@ -0,0 +1,10 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_INFO_H
+#define __API_INFO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+bool INFO_GetIMEI(uint8_t *imei);
+
+#endif
@@ -0,0 +1,27 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_NETWORK_H
+#define __API_NETWORK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "api_inc_network.h"
+
+bool Network_StartAttach(void);
+bool Network_StartDetach(void);
+bool Network_StartActive(Network_PDP_Context_t context);
+bool Network_StartDeactive(uint8_t contextID);
+bool Network_GetAttachStatus(uint8_t *status);
+bool Network_GetActiveStatus(uint8_t *status);
+bool Network_SetFrequencyBand(uint8_t band);
+bool Network_SetFlightMode(bool enable);
+bool Network_GetFlightMode(bool *isFlightMode);
+bool Network_GetAvailableOperatorReq(void);
+bool Network_GetOperatorNameById(uint8_t *operatorId, uint8_t **operatorName);
+bool Network_GetCurrentOperator(uint8_t operatorId[6], Network_Register_Mode_t *mode);
+bool Network_Register(uint8_t *operatorId, Network_Register_Mode_t mode);
+bool Network_DeRegister(void);
+bool Network_GetCellInfoRequst(void);
+bool Network_GetIp(char *ip, int len);
+
+#endif
@@ -0,0 +1,51 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_OS_H
+#define __API_OS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef void* HANDLE;
+
+#define OS_TIME_OUT_NO_WAIT         0
+#define OS_TIME_OUT_WAIT_FOREVER    0xFFFFFFFF
+
+#define OS_EVENT_PRI_NORMAL         0
+#define OS_EVENT_PRI_URGENT         1
+
+typedef void (*PTASK_FUNC_T)(void *pParameter);
+typedef void (*OS_CALLBACK_FUNC_T)(void *param);
+
+typedef struct {
+    uintptr_t stackTop;     // lowest address of the stack
+    uint32_t stackSize;     // in 32-bit words
+    uint8_t priority;
+    uint32_t usedSize;
+} OS_Task_Info_t;
+
+HANDLE OS_CreateTask(PTASK_FUNC_T pTaskEntry, void *pParameter, void *pStackAddr,
+    uint16_t nStackSize, uint8_t nPriority, uint16_t nCreationFlags, uint16_t nTimeSlice,
+    const char *pTaskName);
+bool OS_GetTaskInfo(HANDLE pHTask, OS_Task_Info_t *pTaskInfo);
+void OS_SetUserMainHandle(HANDLE *appMainHandle);
+
+bool OS_WaitEvent(HANDLE pHTask, void **pEvent, uint32_t nTimeOut);
+bool OS_SendEvent(HANDLE pHTask, void *pEvent, uint32_t nTimeOut, uint16_t nOption);
+
+void *OS_Malloc(uint32_t nSize);
+void *OS_Realloc(void *ptr, uint32_t nSize);
+bool OS_Free(void *pMemBlock);
+
+bool OS_Sleep(uint32_t nMillisecondes);
+bool OS_SleepUs(uint32_t us);
+
+bool OS_StartCallbackTimer(HANDLE hTask, uint32_t ms, OS_CALLBACK_FUNC_T callback, void *param);
+bool OS_StopCallbackTimer(HANDLE hTask, OS_CALLBACK_FUNC_T callback, void *param);
+
+HANDLE OS_CreateSemaphore(uint32_t nInitCount);
+bool OS_DeleteSemaphore(HANDLE semaphore);
+bool OS_WaitForSemaphore(HANDLE semaphore, uint32_t nTimeOut);
+void OS_ReleaseSemaphore(HANDLE semaphore);
+
+#endif
@@ -0,0 +1,16 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_SIM_H
+#define __API_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    SIM0 = 0,
+    SIM1,
+} SIM_ID_t;
+
+bool SIM_GetICCID(uint8_t *iccid);
+bool SIM_GetIMSI(uint8_t *imsi);
+
+#endif
@@ -0,0 +1,80 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_SMS_H
+#define __API_SMS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "api_sim.h"
+#include "api_charset.h"
+
+#define SMS_PHONE_NUMBER_MAX_LEN 21
+
+typedef enum {
+    SMS_FORMAT_PDU = 0,
+    SMS_FORMAT_TEXT = 1,
+} SMS_Format_t;
+
+typedef enum {
+    SMS_STORAGE_FLASH = 1,
+    SMS_STORAGE_SIM_CARD = 2,
+} SMS_Storage_t;
+
+typedef enum {
+    SMS_STATUS_UNREAD = 1 << 0,
+    SMS_STATUS_READ = 1 << 1,
+    SMS_STATUS_UNSENT = 1 << 2,
+    SMS_STATUS_SENT_NOT_SR_REQ = 1 << 3,
+    SMS_STATUS_ALL = 0x7F,
+} SMS_Status_t;
+
+typedef enum {
+    SMS_ENCODE_TYPE_ASCII = 0,
+    SMS_ENCODE_TYPE_UNICODE,
+} SMS_Encode_Type_t;
+
+typedef enum {
+    SMS_NUMBER_TYPE_UNKNOWN = 129,
+    SMS_NUMBER_TYPE_INTERNATIONAL = 145,
+    SMS_NUMBER_TYPE_NATIONAL = 161,
+} SMS_Number_Type_t;
+
+typedef struct {
+    uint8_t fo;
+    uint8_t vp;
+    uint8_t pid;
+    uint8_t dcs;
+} SMS_Parameter_t;
+
+typedef struct {
+    uint16_t used;
+    uint16_t total;
+    uint16_t unReadRecords;
+    uint16_t readRecords;
+    uint16_t sentRecords;
+    uint16_t unsentRecords;
+    uint16_t unknownRecords;
+    SMS_Storage_t storageId;
+} SMS_Storage_Info_t;
+
+typedef struct {
+    uint16_t index;
+    SMS_Status_t status;
+    SMS_Number_Type_t phoneNumberType;
+    uint8_t phoneNumber[SMS_PHONE_NUMBER_MAX_LEN + 1]; // the first character is a quote
+    uint8_t time[8];
+    uint8_t *data;
+    uint16_t dataLen;
+} SMS_Message_Info_t;
+
+bool SMS_SetFormat(SMS_Format_t format, SIM_ID_t simID);
+bool SMS_SetParameter(SMS_Parameter_t *smsParameter, SIM_ID_t simID);
+bool SMS_SetNewMessageStorage(SMS_Storage_t storage);
+bool SMS_SendMessage(const char *phoneNumber, const uint8_t *message, uint16_t length, SIM_ID_t simID);
+bool SMS_ListMessageRequst(SMS_Status_t smsStatus, SMS_Storage_t storage);
+bool SMS_DeleteMessage(uint8_t index, SMS_Status_t status, SMS_Storage_t storage);
+bool SMS_GetStorageInfo(SMS_Storage_Info_t *storageInfo, SMS_Storage_t storage);
+bool SMS_LocalLanguage2Unicode(uint8_t *localIn, uint16_t localInLen, Charset_t localLanguage, uint8_t **unicodeOut, uint32_t *unicodeOutLen);
+bool SMS_Unicode2LocalLanguage(uint8_t *unicodeIn, uint16_t unicodeLen, Charset_t localLanguage, uint8_t **localOut, uint32_t *localOutLen);
+
+#endif
@@ -0,0 +1,21 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_SS_H
+#define __API_SS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint8_t *usdString;
+    uint8_t usdStringSize;
+    uint8_t option;
+    uint8_t dcs;
+} USSD_Type_t;
+
+// Returns zero once the request is queued
+uint32_t SS_SendUSSD(USSD_Type_t usdType);
+
+uint16_t GSM_8BitTo7Bit(const uint8_t *in, uint8_t *out, uint16_t inLen);
+uint16_t GSM_7BitTo8Bit(const uint8_t *in, uint8_t *out, uint16_t inLen);
+
+#endif
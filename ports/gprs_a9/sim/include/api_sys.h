@@ -0,0 +1,11 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __API_SYS_H
+#define __API_SYS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+uint32_t SYS_EnterCriticalSection(void);
+void SYS_ExitCriticalSection(uint32_t state);
+
+#endif
@@ -0,0 +1,18 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __BUFFER_H
+#define __BUFFER_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t *buffer;
+    uint32_t size;
+    uint32_t readIndex;
+    uint32_t length;
+} Buffer_t;
+
+void Buffer_Init(Buffer_t *buffer, uint8_t *data, uint32_t size);
+int32_t Buffer_Puts(Buffer_t *buffer, const void *data, uint32_t length);
+int32_t Buffer_Gets(Buffer_t *buffer, void *data, uint32_t length);
+
+#endif
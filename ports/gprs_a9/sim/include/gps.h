@@ -0,0 +1,16 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __GPS_H
+#define __GPS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gps_parse.h"
+
+void GPS_Init(void);
+bool GPS_Open(void *config);
+bool GPS_Close(void);
+bool GPS_IsOpen(void);
+bool GPS_GetVersion(char *version, uint16_t len);
+
+#endif
@@ -0,0 +1,27 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __GPS_PARSE_H
+#define __GPS_PARSE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "minmea.h"
+
+#define GPS_PARSE_MAX_GSA_NUMBER 3
+#define GPS_PARSE_MAX_GSV_NUMBER 20
+
+typedef struct {
+    struct minmea_sentence_rmc rmc;
+    struct minmea_sentence_gsa gsa[GPS_PARSE_MAX_GSA_NUMBER];
+    struct minmea_sentence_gga gga;
+    struct minmea_sentence_gll gll;
+    struct minmea_sentence_gst gst;
+    struct minmea_sentence_gsv gsv[GPS_PARSE_MAX_GSV_NUMBER];
+    struct minmea_sentence_vtg vtg;
+    struct minmea_sentence_zda zda;
+} GPS_Info_t;
+
+GPS_Info_t* Gps_GetInfo(void);
+bool GPS_Update(uint8_t *data, uint32_t length);
+
+#endif
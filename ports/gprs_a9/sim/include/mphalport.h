@@ -0,0 +1,3 @@
+// py/mphal.h includes <mphalport.h>; the port directory is only searched
+// for "quoted" includes
+#include "../../mphalport.h"
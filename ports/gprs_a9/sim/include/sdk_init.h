@@ -0,0 +1,17 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __SDK_INIT_H
+#define __SDK_INIT_H
+
+// Every CSDK header brings in the C library and the debug API, and the port
+// modules rely on that; the Makefile includes this header in every unit
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "api_debug.h"
+
+// On the module CSDK functions are called through a table of pointers
+#define CSDK_FUNC(name) name
+
+#endif
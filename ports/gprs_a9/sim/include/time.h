@@ -0,0 +1,33 @@
+// Host simulation: stand-in for the CSDK header of the same name
+#ifndef __SIM_TIME_H
+#define __SIM_TIME_H
+
+#include_next <time.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// The module clock ticks at 16384 Hz
+uint32_t sim_clock(void);
+#undef CLOCKS_PER_SEC
+#define CLOCKS_PER_SEC (16384)
+#define CLOCKS_PER_MSEC (16.384)
+#define clock() sim_clock()
+
+typedef struct {
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t timeZone;
+    uint8_t timeZoneMinutes;
+} RTC_Time_t;
+
+uint32_t TIME_GetTime(void);
+bool TIME_GetRtcTime(RTC_Time_t *time);
+bool TIME_SetRtcTime(RTC_Time_t *time);
+void TIME_SetIsAutoUpdateRtcTime(bool autoUpdate);
+
+#endif
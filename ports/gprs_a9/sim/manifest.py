@@ -0,0 +1,3 @@
+# The port modules; micropython-lib packages of the board manifest are left out
+freeze("$(PORT_DIR)/../modules")
+include("$(MPY_DIR)/extmod/uasyncio")
@@ -0,0 +1,487 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// The `_sim` module: scripts the simulated SDK from Python. Tests inject
+// SDK events, feed UARTs and the GPS, fill the SIM card and look at what
+// the port sent to the modem.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/objstr.h"
+#include "py/mperrno.h"
+
+#include "sim.h"
+#include "sim_network.h"
+#include "api_event.h"
+#include "api_hal_uart.h"
+#include "api_hal_gpio.h"
+#include "api_hal_adc.h"
+
+extern uint8_t sim_gpio_mode[GPIO_PIN_MAX];
+extern uint8_t sim_gpio_level[GPIO_PIN_MAX];
+extern uint16_t sim_adc_mv[ADC_CHANNEL_MAX];
+
+STATIC const void *modsim_buffer(mp_obj_t obj, size_t *len) {
+    // None, str or a buffer
+    if (obj == mp_const_none) {
+        *len = 0;
+        return NULL;
+    }
+    if (mp_obj_is_str(obj)) {
+        return mp_obj_str_get_data(obj, len);
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(obj, &bufinfo, MP_BUFFER_READ);
+    *len = bufinfo.len;
+    return bufinfo.buf;
+}
+
+STATIC mp_obj_t modsim_event(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    // ========================================
+    // Sends an SDK event to the main task.
+    // Args:
+    //     id (int): API_EVENT_ID_*;
+    //     param1, param2 (int): parameters;
+    //     p1, p2 (bytes, str): pParam1 and pParam2;
+    //     delay (int): in ms;
+    // ========================================
+    enum { ARG_id, ARG_param1, ARG_param2, ARG_p1, ARG_p2, ARG_delay };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_id, MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_param1, MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_param2, MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_p1, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_p2, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_delay, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    size_t p1_len, p2_len;
+    const void *p1 = modsim_buffer(args[ARG_p1].u_obj, &p1_len);
+    const void *p2 = modsim_buffer(args[ARG_p2].u_obj, &p2_len);
+    API_Event_t *event = sim_event_new(args[ARG_id].u_int, args[ARG_param1].u_int, args[ARG_param2].u_int, p1, p1_len, p2, p2_len);
+    return mp_obj_new_bool(event && sim_event_send(event, args[ARG_delay].u_int));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(modsim_event_obj, 1, modsim_event);
+
+STATIC UART_Port_t modsim_uart_port(mp_obj_t id) {
+    // the ids of machine.UART
+    mp_int_t i = mp_obj_get_int(id);
+    if (i != 0 && i != 1) {
+        mp_raise_ValueError("invalid UART id");
+    }
+    return i + UART1;
+}
+
+STATIC mp_obj_t modsim_uart_rx(mp_obj_t id, mp_obj_t data) {
+    // ========================================
+    // Delivers data to a UART receiver.
+    // ========================================
+    UART_Port_t port = modsim_uart_port(id);
+    size_t len;
+    const void *buf = modsim_buffer(data, &len);
+    sim_uart_rx(port, buf, len);
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(modsim_uart_rx_obj, modsim_uart_rx);
+
+STATIC mp_obj_t modsim_uart_tx(mp_obj_t id) {
+    // ========================================
+    // Takes the data transmitted by UART(1).
+    // ========================================
+    UART_Port_t port = modsim_uart_port(id);
+    vstr_t vstr;
+    vstr_init(&vstr, 64);
+    uint8_t buf[64];
+    size_t n;
+    while ((n = sim_uart_tx_take(port, buf, sizeof(buf)))) {
+        vstr_add_strn(&vstr, (char*)buf, n);
+    }
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modsim_uart_tx_obj, modsim_uart_tx);
+
+STATIC mp_obj_t modsim_gps(mp_obj_t nmea) {
+    // ========================================
+    // Feeds NMEA sentences to the GPS.
+    // Returns:
+    //     False if the GPS is off.
+    // ========================================
+    size_t len;
+    const void *buf = modsim_buffer(nmea, &len);
+    return mp_obj_new_bool(sim_gps_feed(buf, len));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modsim_gps_obj, modsim_gps);
+
+STATIC void modsim_digits(mp_int_t value, uint8_t *dest) {
+    dest[0] = value / 100 % 10;
+    dest[1] = value / 10 % 10;
+    dest[2] = value % 10;
+}
+
+STATIC mp_obj_t modsim_cells(mp_obj_t cells_in) {
+    // ========================================
+    // Sets the stations reported by the modem.
+    // Args:
+    //     cells (list): tuples (mcc, mnc, lac,
+    //     cell_id, bsic, rx_lev, rx_lev_sub,
+    //     arfcn), the serving cell first;
+    // ========================================
+    size_t n;
+    mp_obj_t *items;
+    mp_obj_get_array(cells_in, &n, &items);
+    if (n > SIM_CELLS_MAX) {
+        mp_raise_ValueError("too many cells");
+    }
+    Network_Location_t cells[SIM_CELLS_MAX];
+    memset(cells, 0, sizeof(cells));
+    for (size_t i = 0; i < n; i++) {
+        mp_obj_t *fields;
+        mp_obj_get_array_fixed_n(items[i], 8, &fields);
+        modsim_digits(mp_obj_get_int(fields[0]), cells[i].sMcc);
+        modsim_digits(mp_obj_get_int(fields[1]), cells[i].sMnc);
+        cells[i].sLac = mp_obj_get_int(fields[2]);
+        cells[i].sCellID = mp_obj_get_int_truncated(fields[3]);
+        cells[i].iBsic = mp_obj_get_int(fields[4]);
+        cells[i].iRxLev = mp_obj_get_int(fields[5]);
+        cells[i].iRxLevSub = mp_obj_get_int(fields[6]);
+        cells[i].nArfcn = mp_obj_get_int(fields[7]);
+    }
+    memcpy(sim_cells, cells, sizeof(cells));
+    sim_cells_n = n;
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modsim_cells_obj, modsim_cells);
+
+STATIC mp_obj_t modsim_sms_store(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Puts a message on the SIM card.
+    // Args:
+    //     index (int): storage index;
+    //     status (int): SMS_STATUS_*;
+    //     number (str): the sender;
+    //     text (str, bytes): listed in text mode;
+    //     pdu (str): hex PDU listed in PDU mode;
+    // ========================================
+    mp_int_t index = mp_obj_get_int(args[0]);
+    sim_sms_t *sms = NULL;
+    for (int i = 0; i < SIM_SMS_MAX; i++) {
+        if (sim_sms[i].used && sim_sms[i].index == index) {
+            sms = sim_sms + i;
+            break;
+        }
+        if (!sms && !sim_sms[i].used) {
+            sms = sim_sms + i;
+        }
+    }
+    if (!sms) {
+        mp_raise_OSError(MP_ENOSPC);
+    }
+    size_t number_len, text_len, pdu_len;
+    const char *number = mp_obj_str_get_data(args[2], &number_len);
+    const void *text = modsim_buffer(n_args > 3 ? args[3] : mp_const_none, &text_len);
+    const void *pdu = modsim_buffer(n_args > 4 ? args[4] : mp_const_none, &pdu_len);
+    if (number_len >= sizeof(sms->number) || text_len > SIM_SMS_DATA_MAX || pdu_len > SIM_SMS_DATA_MAX) {
+        mp_raise_ValueError("too long");
+    }
+    memset(sms, 0, sizeof(*sms));
+    sms->used = true;
+    sms->index = index;
+    sms->status = mp_obj_get_int(args[1]);
+    sms->number_type = number[0] == '+' ? SMS_NUMBER_TYPE_INTERNATIONAL : SMS_NUMBER_TYPE_UNKNOWN;
+    memcpy(sms->number, number, number_len);
+    memcpy(sms->text, text, text_len);
+    sms->text_len = text_len;
+    memcpy(sms->pdu, pdu, pdu_len);
+    sms->pdu_len = pdu_len;
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modsim_sms_store_obj, 3, 5, modsim_sms_store);
+
+STATIC mp_obj_t modsim_sms_clear(void) {
+    // ========================================
+    // Empties the SIM card.
+    // ========================================
+    memset(sim_sms, 0, sizeof(sim_sms));
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modsim_sms_clear_obj, modsim_sms_clear);
+
+STATIC mp_obj_t modsim_sms_sent(void) {
+    // ========================================
+    // Takes the messages sent so far.
+    // Returns:
+    //     A list of (number, data, pdu) tuples.
+    // ========================================
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    size_t first = sim_sms_sent_n > SIM_SMS_SENT_MAX ? sim_sms_sent_n - SIM_SMS_SENT_MAX : 0;
+    for (size_t i = first; i < sim_sms_sent_n; i++) {
+        sim_sms_sent_t *sent = sim_sms_sent + i % SIM_SMS_SENT_MAX;
+        mp_obj_t tuple[3] = {
+            mp_obj_new_str(sent->number, strlen(sent->number)),
+            mp_obj_new_bytes(sent->data, sent->len),
+            mp_obj_new_bool(sent->pdu),
+        };
+        mp_obj_list_append(list, mp_obj_new_tuple(3, tuple));
+    }
+    for (size_t i = 0; i < SIM_SMS_SENT_MAX; i++) {
+        free(sim_sms_sent[i].data);
+        sim_sms_sent[i].data = NULL;
+    }
+    sim_sms_sent_n = 0;
+    return list;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modsim_sms_sent_obj, modsim_sms_sent);
+
+STATIC mp_obj_t modsim_network(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    // ========================================
+    // Sets up the modem.
+    // Args:
+    //     delay (int): response time in ms;
+    //     fail (int): NET_* requests that fail;
+    //     mute (int): NET_* requests that are
+    //     never answered;
+    // ========================================
+    enum { ARG_delay, ARG_fail, ARG_mute };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_delay, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = -1} },
+        { MP_QSTR_fail, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = -1} },
+        { MP_QSTR_mute, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = -1} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+    if (args[ARG_delay].u_int >= 0) {
+        sim_network_delay = args[ARG_delay].u_int;
+    }
+    if (args[ARG_fail].u_int >= 0) {
+        sim_network_fail = args[ARG_fail].u_int;
+    }
+    if (args[ARG_mute].u_int >= 0) {
+        sim_network_mute = args[ARG_mute].u_int;
+    }
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(modsim_network_obj, 0, modsim_network);
+
+STATIC mp_obj_t modsim_network_lost(void) {
+    // ========================================
+    // Drops the GPRS context and attachment.
+    // ========================================
+    sim_network_lost();
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modsim_network_lost_obj, modsim_network_lost);
+
+STATIC mp_obj_t modsim_http_serve(mp_obj_t port_in, mp_obj_t replies_in) {
+    // ========================================
+    // Serves HTTP on a loopback port.
+    // Args:
+    //     port (int): the port to listen on;
+    //     replies (list): one per request: bytes,
+    //     None to drop the connection instead or
+    //     (bytes, close) to drop it after them;
+    // ========================================
+    size_t n;
+    mp_obj_t *items;
+    mp_obj_get_array(replies_in, &n, &items);
+    sim_http_reply_t *replies = m_new(sim_http_reply_t, n);
+    for (size_t i = 0; i < n; i++) {
+        mp_obj_t reply = items[i];
+        replies[i].close = false;
+        if (mp_obj_is_type(reply, &mp_type_tuple)) {
+            mp_obj_t *pair;
+            mp_obj_get_array_fixed_n(reply, 2, &pair);
+            reply = pair[0];
+            replies[i].close = mp_obj_is_true(pair[1]);
+        }
+        replies[i].data = (uint8_t*)modsim_buffer(reply, &replies[i].len);
+    }
+    bool ok = sim_http_serve(mp_obj_get_int(port_in), replies, n);
+    m_del(sim_http_reply_t, replies, n);
+    if (!ok) {
+        mp_raise_OSError(MP_EADDRINUSE);
+    }
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(modsim_http_serve_obj, modsim_http_serve);
+
+STATIC mp_obj_t modsim_http_requests(void) {
+    // ========================================
+    // Takes the requests served so far.
+    // Returns:
+    //     A list of bytes.
+    // ========================================
+    uint8_t *requests[16];
+    size_t lens[16];
+    size_t n = sim_http_take(requests, lens, MP_ARRAY_SIZE(requests));
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    for (size_t i = 0; i < n; i++) {
+        mp_obj_list_append(list, mp_obj_new_bytes(requests[i], lens[i]));
+        free(requests[i]);
+    }
+    return list;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modsim_http_requests_obj, modsim_http_requests);
+
+STATIC mp_obj_t modsim_ussd(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Sets the USSD reply.
+    // Returns:
+    //     The last USSD request.
+    // ========================================
+    if (n_args == 1) {
+        size_t len;
+        const char *reply = mp_obj_str_get_data(args[0], &len);
+        if (len >= SIM_USSD_MAX) {
+            mp_raise_ValueError("too long");
+        }
+        memcpy(sim_ussd_reply, reply, len);
+        sim_ussd_reply[len] = 0;
+    }
+    return mp_obj_new_str(sim_ussd_sent, strlen(sim_ussd_sent));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modsim_ussd_obj, 0, 1, modsim_ussd);
+
+STATIC mp_obj_t modsim_call(void) {
+    // ========================================
+    // The number being called or None.
+    // ========================================
+    if (!sim_call_number[0]) {
+        return mp_const_none;
+    }
+    return mp_obj_new_str(sim_call_number, strlen(sim_call_number));
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modsim_call_obj, modsim_call);
+
+STATIC mp_obj_t modsim_pin(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Drives an input or reads an output.
+    // ========================================
+    mp_int_t pin = mp_obj_get_int(args[0]);
+    if (pin < 0 || pin >= GPIO_PIN_MAX) {
+        mp_raise_ValueError("invalid pin");
+    }
+    if (n_args == 2) {
+        sim_gpio_level[pin] = mp_obj_is_true(args[1]);
+        return mp_const_none;
+    }
+    return MP_OBJ_NEW_SMALL_INT(sim_gpio_level[pin]);
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modsim_pin_obj, 1, 2, modsim_pin);
+
+STATIC mp_obj_t modsim_adc(mp_obj_t channel_in, mp_obj_t mv_in) {
+    // ========================================
+    // Sets the voltage (mV) on an ADC channel.
+    // ========================================
+    mp_int_t channel = mp_obj_get_int(channel_in);
+    if (channel < 0 || channel >= ADC_CHANNEL_MAX) {
+        mp_raise_ValueError("invalid channel");
+    }
+    sim_adc_mv[channel] = mp_obj_get_int(mv_in);
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(modsim_adc_obj, modsim_adc);
+
+STATIC mp_obj_t modsim_exit(size_t n_args, const mp_obj_t *args) {
+    // ========================================
+    // Terminates the simulation.
+    // ========================================
+    exit(n_args ? mp_obj_get_int(args[0]) : 0);
+    return mp_const_none;
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modsim_exit_obj, 0, 1, modsim_exit);
+
+STATIC const mp_rom_map_elem_t modsim_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR__sim) },
+
+    { MP_ROM_QSTR(MP_QSTR_event), MP_ROM_PTR(&modsim_event_obj) },
+    { MP_ROM_QSTR(MP_QSTR_uart_rx), MP_ROM_PTR(&modsim_uart_rx_obj) },
+    { MP_ROM_QSTR(MP_QSTR_uart_tx), MP_ROM_PTR(&modsim_uart_tx_obj) },
+    { MP_ROM_QSTR(MP_QSTR_gps), MP_ROM_PTR(&modsim_gps_obj) },
+    { MP_ROM_QSTR(MP_QSTR_cells), MP_ROM_PTR(&modsim_cells_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sms_store), MP_ROM_PTR(&modsim_sms_store_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sms_clear), MP_ROM_PTR(&modsim_sms_clear_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sms_sent), MP_ROM_PTR(&modsim_sms_sent_obj) },
+    { MP_ROM_QSTR(MP_QSTR_network), MP_ROM_PTR(&modsim_network_obj) },
+    { MP_ROM_QSTR(MP_QSTR_network_lost), MP_ROM_PTR(&modsim_network_lost_obj) },
+    { MP_ROM_QSTR(MP_QSTR_http_serve), MP_ROM_PTR(&modsim_http_serve_obj) },
+    { MP_ROM_QSTR(MP_QSTR_http_requests), MP_ROM_PTR(&modsim_http_requests_obj) },
+    { MP_ROM_QSTR(MP_QSTR_ussd), MP_ROM_PTR(&modsim_ussd_obj) },
+    { MP_ROM_QSTR(MP_QSTR_call), MP_ROM_PTR(&modsim_call_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pin), MP_ROM_PTR(&modsim_pin_obj) },
+    { MP_ROM_QSTR(MP_QSTR_adc), MP_ROM_PTR(&modsim_adc_obj) },
+    { MP_ROM_QSTR(MP_QSTR_exit), MP_ROM_PTR(&modsim_exit_obj) },
+
+    { MP_ROM_QSTR(MP_QSTR_NET_ATTACH), MP_ROM_INT(SIM_NET_ATTACH) },
+    { MP_ROM_QSTR(MP_QSTR_NET_ACTIVATE), MP_ROM_INT(SIM_NET_ACTIVATE) },
+    { MP_ROM_QSTR(MP_QSTR_NET_REGISTER), MP_ROM_INT(SIM_NET_REGISTER) },
+    { MP_ROM_QSTR(MP_QSTR_NET_SMS), MP_ROM_INT(SIM_NET_SMS) },
+    { MP_ROM_QSTR(MP_QSTR_NET_SMS_LIST), MP_ROM_INT(SIM_NET_SMS_LIST) },
+    { MP_ROM_QSTR(MP_QSTR_NET_USSD), MP_ROM_INT(SIM_NET_USSD) },
+    { MP_ROM_QSTR(MP_QSTR_NET_SCAN), MP_ROM_INT(SIM_NET_SCAN) },
+    { MP_ROM_QSTR(MP_QSTR_NET_CELLS), MP_ROM_INT(SIM_NET_CELLS) },
+
+    { MP_ROM_QSTR(MP_QSTR_EVENT_NO_SIMCARD), MP_ROM_INT(API_EVENT_ID_NO_SIMCARD) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_REGISTERED_HOME), MP_ROM_INT(API_EVENT_ID_NETWORK_REGISTERED_HOME) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_REGISTER_SEARCHING), MP_ROM_INT(API_EVENT_ID_NETWORK_REGISTER_SEARCHING) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_DEREGISTER), MP_ROM_INT(API_EVENT_ID_NETWORK_DEREGISTER) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_DETACHED), MP_ROM_INT(API_EVENT_ID_NETWORK_DETACHED) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_DEACTIVATED), MP_ROM_INT(API_EVENT_ID_NETWORK_DEACTIVED) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_SIGNAL_QUALITY), MP_ROM_INT(API_EVENT_ID_SIGNAL_QUALITY) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_SMS_RECEIVED), MP_ROM_INT(API_EVENT_ID_SMS_RECEIVED) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_CALL_INCOMING), MP_ROM_INT(API_EVENT_ID_CALL_INCOMING) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_CALL_HANGUP), MP_ROM_INT(API_EVENT_ID_CALL_HANGUP) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_USSD_IND), MP_ROM_INT(API_EVENT_ID_USSD_IND) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_KEY_DOWN), MP_ROM_INT(API_EVENT_ID_KEY_DOWN) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_KEY_UP), MP_ROM_INT(API_EVENT_ID_KEY_UP) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(modsim_globals, modsim_globals_table);
+
+const mp_obj_module_t sim_module = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&modsim_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR__sim, sim_module);
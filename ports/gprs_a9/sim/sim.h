@@ -0,0 +1,102 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MICROPY_INCLUDED_GPRS_A9_SIM_H
+#define MICROPY_INCLUDED_GPRS_A9_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "api_os.h"
+#include "api_event.h"
+
+// Simulated OS (sim_os.c)
+// -----------------------
+// Tasks are host threads of which only one runs at a time: the one with the
+// highest priority (the lowest number) that is not blocked. A running task
+// is preempted by a more urgent one at OS calls, at the end of critical
+// sections and every few bytecodes (MICROPY_VM_HOOK_POLL).
+
+typedef void (*sim_call_t)(void *arg);
+
+void sim_os_init(void);
+void sim_os_run(void) __attribute__((noreturn));
+void sim_os_preempt(void);
+uint64_t sim_now_us(void);
+
+// Wrap blocking host calls (select, connect, DNS) so that other tasks run
+void sim_os_block_begin(void);
+void sim_os_block_end(void);
+
+// Runs fn(arg) after ms milliseconds in the SDK (timer interrupt) context
+bool sim_os_after(uint32_t ms, sim_call_t fn, void *arg);
+void sim_os_cancel(sim_call_t fn, void *arg);
+
+// Runs fn(arg) in the driver task (interrupt context); fn frees arg. Safe
+// to call from host threads.
+bool sim_os_driver_call(sim_call_t fn, void *arg);
+
+// Exit once stdin is closed and the interpreter is idle
+void sim_os_stdin_closed(void);
+
+// Simulated SDK
+// -------------
+
+HANDLE sim_main_task(void);
+
+// SDK events for the main task; the buffers are copied into OS_Malloc'd
+// blocks that the main task frees
+API_Event_t *sim_event_new(uint32_t id, uint32_t param1, uint32_t param2,
+    const void *p1, size_t p1_len, const void *p2, size_t p2_len);
+// Sends the event after ms milliseconds (at once if 0); frees it on failure
+bool sim_event_send(API_Event_t *event, uint32_t ms);
+bool sim_event_post(uint32_t id, uint32_t param1, uint32_t param2,
+    const void *p1, size_t p1_len, const void *p2, size_t p2_len);
+// Posts an event after ms milliseconds
+bool sim_event_post_after(uint32_t ms, uint32_t id, uint32_t param1, uint32_t param2,
+    const void *p1, size_t p1_len, const void *p2, size_t p2_len);
+
+void sim_uart_init(void);
+void sim_uart_rx(int port, const uint8_t *data, size_t len);
+size_t sim_uart_tx_take(int port, uint8_t *buf, size_t len);
+
+void sim_fs_init(const char *root);
+void sim_network_init(void);
+bool sim_gps_feed(const uint8_t *data, size_t len);
+
+// Scripted HTTP server on 127.0.0.1:port (sim_http.c): the i-th request
+// received gets replies[i]; a reply without data drops the connection
+// instead of answering, close drops it after answering
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    bool close;
+} sim_http_reply_t;
+
+bool sim_http_serve(uint16_t port, const sim_http_reply_t *replies, size_t n);
+// Takes up to max requests received so far; free() each of them
+size_t sim_http_take(uint8_t **requests, size_t *lens, size_t max);
+
+#endif // MICROPY_INCLUDED_GPRS_A9_SIM_H
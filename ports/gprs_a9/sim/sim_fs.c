@@ -0,0 +1,225 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Simulated file system: the internal flash is a directory of the host,
+// files are host files and descriptors are host descriptors
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "api_fs.h"
+
+struct _Dir_t {
+    DIR *dir;
+    Dirent_t entry;
+};
+
+static char sim_fs_root[PATH_MAX];
+
+static const char *sim_fs_path(const char *name, char *buf) {
+    // absolute paths start at the root directory
+    if (name[0] != '/') {
+        return name;
+    }
+    snprintf(buf, PATH_MAX, "%s%s", sim_fs_root, name);
+    return buf;
+}
+
+void sim_fs_init(const char *root) {
+    if (!realpath(root, sim_fs_root)) {
+        perror(root);
+        exit(1);
+    }
+    if (strcmp(sim_fs_root, "/") == 0) {
+        sim_fs_root[0] = 0;
+    }
+    if (chdir(root)) {
+        perror(root);
+        exit(1);
+    }
+}
+
+int32_t API_FS_Open(const char *fileName, uint32_t operationFlag, uint32_t mode) {
+    (void)mode;
+    char buf[PATH_MAX];
+    int flags = 0;
+    switch (operationFlag & FS_O_ACCMODE) {
+        case FS_O_WRONLY: flags = O_WRONLY; break;
+        case FS_O_RDWR: flags = O_RDWR; break;
+        default: flags = O_RDONLY; break;
+    }
+    if (operationFlag & FS_O_CREAT) {
+        flags |= O_CREAT;
+    }
+    if (operationFlag & FS_O_EXCL) {
+        flags |= O_EXCL;
+    }
+    if (operationFlag & FS_O_TRUNC) {
+        flags |= O_TRUNC;
+    }
+    if (operationFlag & FS_O_APPEND) {
+        flags |= O_APPEND;
+    }
+    const char *path = sim_fs_path(fileName, buf);
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+        errno = EISDIR;
+        return -1;
+    }
+    return open(path, flags, 0666);
+}
+
+int32_t API_FS_Close(int32_t fd) {
+    return close(fd);
+}
+
+int32_t API_FS_Read(int32_t fd, uint8_t *pBuffer, uint32_t length) {
+    return read(fd, pBuffer, length);
+}
+
+int32_t API_FS_Write(int32_t fd, uint8_t *pBuffer, uint32_t length) {
+    return write(fd, pBuffer, length);
+}
+
+int64_t API_FS_Seek(int32_t fd, int64_t offset, uint8_t origin) {
+    return lseek(fd, offset, origin == FS_SEEK_CUR ? SEEK_CUR : origin == FS_SEEK_END ? SEEK_END : SEEK_SET);
+}
+
+int32_t API_FS_Flush(int32_t fd) {
+    return fsync(fd);
+}
+
+int32_t API_FS_GetFileSize(int32_t fd) {
+    struct stat st;
+    if (fstat(fd, &st)) {
+        return -1;
+    }
+    return st.st_size;
+}
+
+int32_t API_FS_Delete(const char *fileName) {
+    char buf[PATH_MAX];
+    return unlink(sim_fs_path(fileName, buf));
+}
+
+int32_t API_FS_Rename(const char *oldName, const char *newName) {
+    char buf_old[PATH_MAX], buf_new[PATH_MAX];
+    return rename(sim_fs_path(oldName, buf_old), sim_fs_path(newName, buf_new));
+}
+
+int32_t API_FS_Mkdir(const char *dirName, uint32_t mode) {
+    (void)mode;
+    char buf[PATH_MAX];
+    return mkdir(sim_fs_path(dirName, buf), 0777);
+}
+
+int32_t API_FS_Rmdir(const char *dirName) {
+    char buf[PATH_MAX];
+    return rmdir(sim_fs_path(dirName, buf));
+}
+
+int32_t API_FS_ChangeDir(const char *dirName) {
+    char buf[PATH_MAX];
+    return chdir(sim_fs_path(dirName, buf));
+}
+
+int32_t API_FS_GetCurDir(uint32_t size, char *curDir) {
+    char buf[PATH_MAX];
+    if (!getcwd(buf, sizeof(buf))) {
+        return -1;
+    }
+    size_t root = strlen(sim_fs_root);
+    const char *cwd = buf + root;
+    if (strncmp(buf, sim_fs_root, root) || (*cwd && *cwd != '/')) {
+        // left the root: should not happen
+        errno = ENOENT;
+        return -1;
+    }
+    if (!*cwd) {
+        cwd = "/";
+    }
+    if (strlen(cwd) >= size) {
+        errno = ERANGE;
+        return -1;
+    }
+    strcpy(curDir, cwd);
+    return 0;
+}
+
+int32_t API_FS_GetFSInfo(const char *path, API_FS_INFO *fsInfo) {
+    char buf[PATH_MAX];
+    struct statvfs st;
+    if (statvfs(sim_fs_path(path, buf), &st)) {
+        return -1;
+    }
+    fsInfo->totalSize = (uint64_t)st.f_blocks * st.f_frsize;
+    fsInfo->usedSize = (uint64_t)(st.f_blocks - st.f_bfree) * st.f_frsize;
+    return 0;
+}
+
+Dir_t *API_FS_OpenDir(const char *name) {
+    char buf[PATH_MAX];
+    DIR *dir = opendir(sim_fs_path(name, buf));
+    if (!dir) {
+        return NULL;
+    }
+    Dir_t *result = malloc(sizeof(Dir_t));
+    if (!result) {
+        closedir(dir);
+        return NULL;
+    }
+    result->dir = dir;
+    return result;
+}
+
+const Dirent_t *API_FS_ReadDir(Dir_t *pDir) {
+    struct dirent *entry;
+    while ((entry = readdir(pDir->dir))) {
+        if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..")) {
+            break;
+        }
+    }
+    if (!entry) {
+        return NULL;
+    }
+    pDir->entry.d_ino = (int32_t)entry->d_ino;
+    pDir->entry.d_type = entry->d_type == DT_DIR ? 4 : 8;
+    snprintf(pDir->entry.d_name, sizeof(pDir->entry.d_name), "%s", entry->d_name);
+    return &pDir->entry;
+}
+
+int32_t API_FS_CloseDir(Dir_t *pDir) {
+    int ret = closedir(pDir->dir);
+    free(pDir);
+    return ret;
+}
@@ -0,0 +1,48 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Stand-in for gchelper.s: saves the callee-saved registers of x86-64, which
+// may hold heap pointers, and returns the stack pointer
+
+#include <stdint.h>
+
+#include "py/mpconfig.h"
+
+__attribute__((noinline))
+mp_uint_t gc_helper_get_regs_and_sp(mp_uint_t *regs) {
+    mp_uint_t sp;
+    __asm__ volatile (
+        "mov %%rbx, 0(%1)\n"
+        "mov %%rbp, 8(%1)\n"
+        "mov %%r12, 16(%1)\n"
+        "mov %%r13, 24(%1)\n"
+        "mov %%r14, 32(%1)\n"
+        "mov %%r15, 40(%1)\n"
+        "mov %%rsp, %0\n"
+        : "=r" (sp)
+        : "r" (regs)
+        : "memory"
+        );
+    return sp;
+}
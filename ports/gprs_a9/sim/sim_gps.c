@@ -0,0 +1,226 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Simulated GPS: NMEA sentences fed through the `_sim` module arrive as
+// GPS_UART_RECEIVED events and are parsed by GPS_Update as by the SDK.
+// RMC, GGA and GSV sentences are understood.
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "gps.h"
+#include "gps_parse.h"
+
+static GPS_Info_t sim_gps_info;
+static bool sim_gps_open;
+
+GPS_Info_t *Gps_GetInfo(void) {
+    return &sim_gps_info;
+}
+
+void GPS_Init(void) {
+}
+
+bool GPS_Open(void *config) {
+    (void)config;
+    sim_gps_open = true;
+    return true;
+}
+
+bool GPS_Close(void) {
+    sim_gps_open = false;
+    return true;
+}
+
+bool GPS_IsOpen(void) {
+    return sim_gps_open;
+}
+
+bool GPS_GetVersion(char *version, uint16_t len) {
+    if (!sim_gps_open || len == 0) {
+        return false;
+    }
+    strncpy(version, "SIM GPS 1.0", len - 1);
+    version[len - 1] = 0;
+    return true;
+}
+
+bool sim_gps_feed(const uint8_t *data, size_t len) {
+    // the module reports NMEA only while the GPS is on
+    if (!sim_gps_open) {
+        return false;
+    }
+    return sim_event_post(API_EVENT_ID_GPS_UART_RECEIVED, len, 0, data, len, NULL, 0);
+}
+
+// -------
+// Parsing
+// -------
+
+static const char *sim_nmea_field(const char *p, const char *end, int n, size_t *len) {
+    // the n-th comma-separated field after the sentence name
+    for (int i = 0; i <= n; i++) {
+        p = memchr(p, ',', end - p);
+        if (!p) {
+            *len = 0;
+            return end;
+        }
+        p++;
+    }
+    const char *stop = p;
+    while (stop < end && *stop != ',' && *stop != '*') {
+        stop++;
+    }
+    *len = stop - p;
+    return p;
+}
+
+static struct minmea_float sim_nmea_float(const char *s, size_t len) {
+    struct minmea_float f = {0, 0};
+    if (len == 0) {
+        return f;
+    }
+    int sign = 1;
+    size_t i = 0;
+    if (s[0] == '-') {
+        sign = -1;
+        i++;
+    }
+    f.scale = 1;
+    bool point = false;
+    for (; i < len; i++) {
+        if (s[i] == '.') {
+            point = true;
+        } else if (isdigit((unsigned char)s[i])) {
+            f.value = f.value * 10 + (s[i] - '0');
+            if (point) {
+                f.scale *= 10;
+            }
+        }
+    }
+    f.value *= sign;
+    return f;
+}
+
+static int sim_nmea_int(const char *s, size_t len) {
+    int v = 0;
+    for (size_t i = 0; i < len && isdigit((unsigned char)s[i]); i++) {
+        v = v * 10 + (s[i] - '0');
+    }
+    return v;
+}
+
+static struct minmea_float sim_nmea_coord(const char *s, size_t len, const char *hemi, size_t hemi_len) {
+    struct minmea_float f = sim_nmea_float(s, len);
+    if (hemi_len && (*hemi == 'S' || *hemi == 'W')) {
+        f.value = -f.value;
+    }
+    return f;
+}
+
+static struct minmea_time sim_nmea_time(const char *s, size_t len) {
+    struct minmea_time t = {-1, -1, -1, -1};
+    if (len >= 6) {
+        t.hours = sim_nmea_int(s, 2);
+        t.minutes = sim_nmea_int(s + 2, 2);
+        t.seconds = sim_nmea_int(s + 4, 2);
+        t.microseconds = 0;
+        if (len > 7 && s[6] == '.') {
+            struct minmea_float frac = sim_nmea_float(s + 6, len - 6);
+            t.microseconds = frac.scale ? (int)((int64_t)frac.value * 1000000 / frac.scale) : 0;
+        }
+    }
+    return t;
+}
+
+static void sim_nmea_sentence(const char *p, const char *end) {
+    size_t len[12];
+    const char *f[12];
+    for (int i = 0; i < 12; i++) {
+        f[i] = sim_nmea_field(p, end, i, len + i);
+    }
+    if (end - p < 6) {
+        return;
+    }
+    const char *type = p + 2; // after the talker id
+    if (!memcmp(type, "RMC", 3)) {
+        struct minmea_sentence_rmc *rmc = &sim_gps_info.rmc;
+        rmc->time = sim_nmea_time(f[0], len[0]);
+        rmc->valid = len[1] && f[1][0] == 'A';
+        rmc->latitude = sim_nmea_coord(f[2], len[2], f[3], len[3]);
+        rmc->longitude = sim_nmea_coord(f[4], len[4], f[5], len[5]);
+        rmc->speed = sim_nmea_float(f[6], len[6]);
+        rmc->course = sim_nmea_float(f[7], len[7]);
+        if (len[8] >= 6) {
+            rmc->date.day = sim_nmea_int(f[8], 2);
+            rmc->date.month = sim_nmea_int(f[8] + 2, 2);
+            rmc->date.year = sim_nmea_int(f[8] + 4, 2);
+        } else {
+            rmc->date.day = rmc->date.month = rmc->date.year = -1;
+        }
+        rmc->variation = sim_nmea_coord(f[9], len[9], f[10], len[10]);
+    } else if (!memcmp(type, "GGA", 3)) {
+        struct minmea_sentence_gga *gga = &sim_gps_info.gga;
+        gga->time = sim_nmea_time(f[0], len[0]);
+        gga->latitude = sim_nmea_coord(f[1], len[1], f[2], len[2]);
+        gga->longitude = sim_nmea_coord(f[3], len[3], f[4], len[4]);
+        gga->fix_quality = sim_nmea_int(f[5], len[5]);
+        gga->satellites_tracked = sim_nmea_int(f[6], len[6]);
+        gga->hdop = sim_nmea_float(f[7], len[7]);
+        gga->altitude = sim_nmea_float(f[8], len[8]);
+        gga->altitude_units = len[9] ? f[9][0] : 0;
+        gga->height = sim_nmea_float(f[10], len[10]);
+        gga->height_units = len[11] ? f[11][0] : 0;
+    } else if (!memcmp(type, "GSV", 3)) {
+        int msg = sim_nmea_int(f[1], len[1]);
+        if (msg >= 1 && msg <= GPS_PARSE_MAX_GSV_NUMBER) {
+            struct minmea_sentence_gsv *gsv = &sim_gps_info.gsv[msg - 1];
+            gsv->total_msgs = sim_nmea_int(f[0], len[0]);
+            gsv->msg_nr = msg;
+            gsv->total_sats = sim_nmea_int(f[2], len[2]);
+        }
+    }
+}
+
+bool GPS_Update(uint8_t *buffer, uint32_t len) {
+    // parses all complete "$...*hh" sentences in the buffer; checksums are
+    // not verified
+    const char *p = (const char*)buffer;
+    const char *end = p + len;
+    while (p < end) {
+        const char *start = memchr(p, '$', end - p);
+        if (!start) {
+            break;
+        }
+        const char *stop = start + 1;
+        while (stop < end && *stop != '$' && *stop != '\r' && *stop != '\n') {
+            stop++;
+        }
+        sim_nmea_sentence(start + 1, stop);
+        p = stop;
+    }
+    return true;
+}
@@ -0,0 +1,378 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Simulated peripherals: power management, GPIO, I2C, ADC, watchdog, SPI
+// flash, RTC and the debug trace. GPIO inputs, ADC readings and I2C devices
+// are driven from the `_sim` module.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim.h"
+#include "api_debug.h"
+#include "api_hal_pm.h"
+#include "api_hal_gpio.h"
+#include "api_hal_i2c.h"
+#include "api_hal_adc.h"
+#include "api_hal_watchdog.h"
+#include "api_hal_flash.h"
+#include "api_info.h"
+#include "api_sim.h"
+
+#define SIM_FLASH_SIZE      (4 * 1024 * 1024)
+#define SIM_I2C_MEM_SIZE    256
+
+// Debug trace goes to stderr when SIM_TRACE is set in the environment
+static int sim_trace = -1;
+
+void Trace(uint16_t level, const char *fmt, ...) {
+    if (sim_trace < 0) {
+        sim_trace = getenv("SIM_TRACE") != NULL;
+    }
+    if (!sim_trace) {
+        return;
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "[trace %u] ", level);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+void Assert(bool condition, const char *msg) {
+    if (!condition) {
+        fprintf(stderr, "\nassertion failed: %s\n", msg);
+        abort();
+    }
+}
+
+// ---------------
+// Power and reset
+// ---------------
+
+bool sim_sleep_mode;
+
+void PM_SetSysMinFreq(PM_Sys_Freq_t freq) {
+    (void)freq;
+}
+
+bool PM_PowerEnable(Power_Type_t type, bool isOn) {
+    return type < POWER_TYPE_MAX;
+}
+
+void PM_Restart(void) {
+    fflush(stdout);
+    exit(0);
+}
+
+void PM_ShutDown(void) {
+    fflush(stdout);
+    exit(0);
+}
+
+bool PM_SleepMode(bool enable) {
+    sim_sleep_mode = enable;
+    return true;
+}
+
+uint16_t PM_Voltage(uint8_t *percent) {
+    if (percent) {
+        *percent = 100;
+    }
+    return 4200;
+}
+
+// ----
+// GPIO
+// ----
+
+uint8_t sim_gpio_mode[GPIO_PIN_MAX];
+uint8_t sim_gpio_level[GPIO_PIN_MAX];
+
+bool GPIO_Init(GPIO_config_t config) {
+    if (config.pin >= GPIO_PIN_MAX) {
+        return false;
+    }
+    sim_gpio_mode[config.pin] = config.mode;
+    if (config.mode == GPIO_MODE_OUTPUT) {
+        sim_gpio_level[config.pin] = config.defaultLevel == GPIO_LEVEL_HIGH;
+    }
+    return true;
+}
+
+bool GPIO_Close(GPIO_PIN pin) {
+    return pin < GPIO_PIN_MAX;
+}
+
+bool GPIO_Set(GPIO_PIN pin, GPIO_LEVEL level) {
+    if (pin >= GPIO_PIN_MAX) {
+        return false;
+    }
+    sim_gpio_level[pin] = level == GPIO_LEVEL_HIGH;
+    return true;
+}
+
+bool GPIO_Get(GPIO_PIN pin, GPIO_LEVEL *level) {
+    if (pin >= GPIO_PIN_MAX) {
+        return false;
+    }
+    *level = sim_gpio_level[pin] ? GPIO_LEVEL_HIGH : GPIO_LEVEL_LOW;
+    return true;
+}
+
+bool GPIO_ChangeMode(GPIO_PIN pin, GPIO_MODE mode) {
+    if (pin >= GPIO_PIN_MAX) {
+        return false;
+    }
+    sim_gpio_mode[pin] = mode;
+    return true;
+}
+
+// ---
+// I2C
+// ---
+// Every bus has a single memory device answering at any address
+
+static bool sim_i2c_on[3];
+static uint8_t sim_i2c_mem[3][SIM_I2C_MEM_SIZE];
+
+static bool sim_i2c_valid(I2C_ID_t i2c) {
+    return i2c >= I2C1 && i2c <= I2C3;
+}
+
+bool I2C_Init(I2C_ID_t i2c, I2C_Config_t config) {
+    (void)config;
+    if (!sim_i2c_valid(i2c)) {
+        return false;
+    }
+    sim_i2c_on[i2c - 1] = true;
+    return true;
+}
+
+static I2C_Error_t sim_i2c_check(I2C_ID_t i2c) {
+    if (!sim_i2c_valid(i2c)) {
+        return I2C_ERROR_BAD_PARAMETER;
+    }
+    if (!sim_i2c_on[i2c - 1]) {
+        return I2C_ERROR_RESOURCE_NOT_ENABLED;
+    }
+    return I2C_ERROR_NONE;
+}
+
+I2C_Error_t I2C_Transmit(I2C_ID_t i2c, uint16_t slaveAddr, uint8_t *pData, uint16_t length, uint32_t timeOut) {
+    (void)slaveAddr;
+    (void)timeOut;
+    I2C_Error_t error = sim_i2c_check(i2c);
+    if (error == I2C_ERROR_NONE) {
+        memcpy(sim_i2c_mem[i2c - 1], pData, length < SIM_I2C_MEM_SIZE ? length : SIM_I2C_MEM_SIZE);
+    }
+    return error;
+}
+
+I2C_Error_t I2C_Receive(I2C_ID_t i2c, uint16_t slaveAddr, uint8_t *pData, uint16_t length, uint32_t timeOut) {
+    (void)slaveAddr;
+    (void)timeOut;
+    I2C_Error_t error = sim_i2c_check(i2c);
+    if (error == I2C_ERROR_NONE) {
+        for (uint16_t i = 0; i < length; i++) {
+            pData[i] = sim_i2c_mem[i2c - 1][i % SIM_I2C_MEM_SIZE];
+        }
+    }
+    return error;
+}
+
+I2C_Error_t I2C_WriteMem(I2C_ID_t i2c, uint16_t slaveAddr, uint32_t memAddr, uint8_t memSize, uint8_t *pData, uint16_t length, uint32_t timeOut) {
+    (void)slaveAddr;
+    (void)memSize;
+    (void)timeOut;
+    I2C_Error_t error = sim_i2c_check(i2c);
+    if (error == I2C_ERROR_NONE) {
+        for (uint16_t i = 0; i < length; i++) {
+            sim_i2c_mem[i2c - 1][(memAddr + i) % SIM_I2C_MEM_SIZE] = pData[i];
+        }
+    }
+    return error;
+}
+
+I2C_Error_t I2C_ReadMem(I2C_ID_t i2c, uint16_t slaveAddr, uint32_t memAddr, uint8_t memSize, uint8_t *pData, uint16_t length, uint32_t timeOut) {
+    (void)slaveAddr;
+    (void)memSize;
+    (void)timeOut;
+    I2C_Error_t error = sim_i2c_check(i2c);
+    if (error == I2C_ERROR_NONE) {
+        for (uint16_t i = 0; i < length; i++) {
+            pData[i] = sim_i2c_mem[i2c - 1][(memAddr + i) % SIM_I2C_MEM_SIZE];
+        }
+    }
+    return error;
+}
+
+bool I2C_Close(I2C_ID_t i2c) {
+    if (!sim_i2c_valid(i2c)) {
+        return false;
+    }
+    sim_i2c_on[i2c - 1] = false;
+    return true;
+}
+
+// ---
+// ADC
+// ---
+
+uint16_t sim_adc_mv[ADC_CHANNEL_MAX];
+static bool sim_adc_on[ADC_CHANNEL_MAX];
+
+void ADC_Init(ADC_Config_t config) {
+    if (config.channel < ADC_CHANNEL_MAX) {
+        sim_adc_on[config.channel] = true;
+    }
+}
+
+bool ADC_Read(ADC_Channel_t channel, uint16_t *value, uint16_t *mV) {
+    if (channel >= ADC_CHANNEL_MAX || !sim_adc_on[channel]) {
+        return false;
+    }
+    // 10 bits over 0 .. 1.8 V
+    *mV = sim_adc_mv[channel];
+    *value = (uint32_t)sim_adc_mv[channel] * 1023 / 1800;
+    return true;
+}
+
+void ADC_Close(ADC_Channel_t channel) {
+    if (channel < ADC_CHANNEL_MAX) {
+        sim_adc_on[channel] = false;
+    }
+}
+
+// --------
+// Watchdog
+// --------
+
+bool WatchDog_Open(uint32_t ticks) {
+    (void)ticks;
+    return true;
+}
+
+void WatchDog_Close(void) {
+}
+
+void WatchDog_KeepAlive(void) {
+}
+
+// ---------
+// SPI flash
+// ---------
+
+uint8_t sim_flash[SIM_FLASH_SIZE];
+
+bool hal_SpiFlashWrite(uint32_t flashAddress, const uint8_t *buffer, uint32_t byteSize) {
+    if (flashAddress > SIM_FLASH_SIZE || byteSize > SIM_FLASH_SIZE - flashAddress) {
+        return false;
+    }
+    // programming only clears bits
+    for (uint32_t i = 0; i < byteSize; i++) {
+        sim_flash[flashAddress + i] &= buffer[i];
+    }
+    return true;
+}
+
+bool hal_SpiFlashErase(uint32_t flashAddress, uint32_t size) {
+    if (flashAddress > SIM_FLASH_SIZE || size > SIM_FLASH_SIZE - flashAddress) {
+        return false;
+    }
+    memset(sim_flash + flashAddress, 0xff, size);
+    return true;
+}
+
+uint32_t hal_SpiFlashGetSize(void) {
+    return SIM_FLASH_SIZE;
+}
+
+// ---------------------
+// Module and SIM card
+// ---------------------
+
+bool INFO_GetIMEI(uint8_t *imei) {
+    strcpy((char*)imei, "866000000000001");
+    return true;
+}
+
+bool SIM_GetICCID(uint8_t *iccid) {
+    strcpy((char*)iccid, "89860000000000000001");
+    return true;
+}
+
+bool SIM_GetIMSI(uint8_t *imsi) {
+    strcpy((char*)imsi, "460000000000001");
+    return true;
+}
+
+// ---
+// RTC
+// ---
+// The RTC runs at an offset from the host clock
+
+#define SIM_EPOCH_2000 946684800
+
+static int64_t sim_rtc_offset;
+
+uint32_t TIME_GetTime(void) {
+    return (uint32_t)(time(NULL) - SIM_EPOCH_2000 + sim_rtc_offset);
+}
+
+bool TIME_GetRtcTime(RTC_Time_t *t) {
+    time_t now = time(NULL) + sim_rtc_offset;
+    struct tm tm;
+    gmtime_r(&now, &tm);
+    t->year = tm.tm_year + 1900;
+    t->month = tm.tm_mon + 1;
+    t->day = tm.tm_mday;
+    t->hour = tm.tm_hour;
+    t->minute = tm.tm_min;
+    t->second = tm.tm_sec;
+    t->timeZone = 0;
+    t->timeZoneMinutes = 0;
+    return true;
+}
+
+bool TIME_SetRtcTime(RTC_Time_t *t) {
+    struct tm tm = {
+        .tm_year = t->year - 1900,
+        .tm_mon = t->month - 1,
+        .tm_mday = t->day,
+        .tm_hour = t->hour,
+        .tm_min = t->minute,
+        .tm_sec = t->second,
+    };
+    sim_rtc_offset = (int64_t)timegm(&tm) - time(NULL);
+    return true;
+}
+
+void TIME_SetIsAutoUpdateRtcTime(bool autoUpdate) {
+    (void)autoUpdate;
+}
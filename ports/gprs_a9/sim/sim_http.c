@@ -0,0 +1,257 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Scripted HTTP server: a host thread outside the simulated OS answers the
+// requests it receives on a loopback port with canned replies, one per
+// request in order, over any number of keep-alive connections. It goes away
+// once all replies are used or after a pause.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sim.h"
+
+#define SIM_HTTP_CONNS      4
+#define SIM_HTTP_REQUESTS   16
+#define SIM_HTTP_IDLE_S     5
+
+typedef struct {
+    int fd;
+    uint8_t *rx;
+    size_t rx_len;
+} sim_http_conn_t;
+
+typedef struct {
+    int fd;
+    size_t n;
+    sim_http_reply_t *replies;
+} sim_http_server_t;
+
+// Requests received and not taken yet, from any server
+static pthread_mutex_t sim_http_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t *sim_http_requests[SIM_HTTP_REQUESTS];
+static size_t sim_http_request_lens[SIM_HTTP_REQUESTS];
+static size_t sim_http_requests_n;
+
+static void sim_http_log(const uint8_t *data, size_t len) {
+    pthread_mutex_lock(&sim_http_lock);
+    if (sim_http_requests_n < SIM_HTTP_REQUESTS) {
+        uint8_t *copy = malloc(len);
+        if (copy) {
+            memcpy(copy, data, len);
+            sim_http_requests[sim_http_requests_n] = copy;
+            sim_http_request_lens[sim_http_requests_n] = len;
+            sim_http_requests_n++;
+        }
+    }
+    pthread_mutex_unlock(&sim_http_lock);
+}
+
+static size_t sim_http_request_len(const uint8_t *data, size_t len) {
+    // The length of the complete request at data or 0: the head and a body
+    // of Content-Length bytes
+    const uint8_t *end = memmem(data, len, "\r\n\r\n", 4);
+    if (!end) {
+        return 0;
+    }
+    size_t head = end + 4 - data;
+    size_t body = 0;
+    for (const uint8_t *line = data; line < end; ) {
+        const uint8_t *next = memmem(line, end + 2 - line, "\r\n", 2);
+        if (next - line > 15 && !strncasecmp((const char*)line, "content-length:", 15)) {
+            body = strtoul((const char*)line + 15, NULL, 10);
+        }
+        line = next + 2;
+    }
+    return head + body <= len ? head + body : 0;
+}
+
+static void sim_http_close(sim_http_conn_t *conn) {
+    close(conn->fd);
+    free(conn->rx);
+    conn->fd = -1;
+    conn->rx = NULL;
+    conn->rx_len = 0;
+}
+
+static void *sim_http_thread(void *arg) {
+    sim_http_server_t *server = arg;
+    sim_http_conn_t conns[SIM_HTTP_CONNS];
+    for (int i = 0; i < SIM_HTTP_CONNS; i++) {
+        conns[i].fd = -1;
+        conns[i].rx = NULL;
+        conns[i].rx_len = 0;
+    }
+
+    size_t next = 0;
+    while (next < server->n) {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(server->fd, &fds);
+        int maxfd = server->fd;
+        for (int i = 0; i < SIM_HTTP_CONNS; i++) {
+            if (conns[i].fd >= 0) {
+                FD_SET(conns[i].fd, &fds);
+                maxfd = conns[i].fd > maxfd ? conns[i].fd : maxfd;
+            }
+        }
+        struct timeval timeout = {.tv_sec = SIM_HTTP_IDLE_S, .tv_usec = 0};
+        if (select(maxfd + 1, &fds, NULL, NULL, &timeout) <= 0) {
+            break;
+        }
+
+        if (FD_ISSET(server->fd, &fds)) {
+            int fd = accept(server->fd, NULL, NULL);
+            for (int i = 0; fd >= 0 && i < SIM_HTTP_CONNS; i++) {
+                if (conns[i].fd < 0) {
+                    conns[i].fd = fd;
+                    fd = -1;
+                }
+            }
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        for (int i = 0; i < SIM_HTTP_CONNS && next < server->n; i++) {
+            sim_http_conn_t *conn = conns + i;
+            if (conn->fd < 0 || !FD_ISSET(conn->fd, &fds)) {
+                continue;
+            }
+            uint8_t buf[1024];
+            ssize_t r = recv(conn->fd, buf, sizeof(buf), 0);
+            if (r <= 0) {
+                sim_http_close(conn);
+                continue;
+            }
+            uint8_t *rx = realloc(conn->rx, conn->rx_len + r);
+            if (!rx) {
+                sim_http_close(conn);
+                continue;
+            }
+            memcpy(rx + conn->rx_len, buf, r);
+            conn->rx = rx;
+            conn->rx_len += r;
+
+            size_t len = sim_http_request_len(conn->rx, conn->rx_len);
+            if (!len) {
+                continue;
+            }
+            sim_http_log(conn->rx, len);
+            memmove(conn->rx, conn->rx + len, conn->rx_len - len);
+            conn->rx_len -= len;
+
+            sim_http_reply_t *reply = server->replies + next++;
+            if (reply->data) {
+                send(conn->fd, reply->data, reply->len, MSG_NOSIGNAL);
+            }
+            if (!reply->data || reply->close) {
+                sim_http_close(conn);
+            }
+        }
+    }
+
+    for (int i = 0; i < SIM_HTTP_CONNS; i++) {
+        if (conns[i].fd >= 0) {
+            sim_http_close(conns + i);
+        }
+    }
+    close(server->fd);
+    for (size_t i = 0; i < server->n; i++) {
+        free(server->replies[i].data);
+    }
+    free(server->replies);
+    free(server);
+    return NULL;
+}
+
+bool sim_http_serve(uint16_t port, const sim_http_reply_t *replies, size_t n) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) || listen(fd, SIM_HTTP_CONNS)) {
+        close(fd);
+        return false;
+    }
+
+    sim_http_server_t *server = calloc(1, sizeof(*server));
+    sim_http_reply_t *copies = calloc(n ? n : 1, sizeof(*copies));
+    if (!server || !copies) {
+        free(server);
+        free(copies);
+        close(fd);
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        copies[i] = replies[i];
+        if (replies[i].data) {
+            copies[i].data = malloc(replies[i].len ? replies[i].len : 1);
+            if (copies[i].data) {
+                memcpy(copies[i].data, replies[i].data, replies[i].len);
+            }
+        }
+    }
+    server->fd = fd;
+    server->n = n;
+    server->replies = copies;
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, sim_http_thread, server)) {
+        server->n = 0;
+        sim_http_thread(server);
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+size_t sim_http_take(uint8_t **requests, size_t *lens, size_t max) {
+    pthread_mutex_lock(&sim_http_lock);
+    size_t n = sim_http_requests_n < max ? sim_http_requests_n : max;
+    for (size_t i = 0; i < n; i++) {
+        requests[i] = sim_http_requests[i];
+        lens[i] = sim_http_request_lens[i];
+    }
+    for (size_t i = n; i < sim_http_requests_n; i++) {
+        free(sim_http_requests[i]);
+    }
+    sim_http_requests_n = 0;
+    pthread_mutex_unlock(&sim_http_lock);
+    return n;
+}
@@ -0,0 +1,378 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Simulated lwIP: the socket API of the SDK on top of host sockets. The
+// structures and constants of lwIP (api_inc_socket.h) differ from the host
+// ones, so they are redefined here under LWIP_ names and translated. Calls
+// that may block release the CPU to the other tasks.
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "sim.h"
+
+// lwIP definitions
+#define LWIP_SOL_SOCKET     0xfff
+#define LWIP_SO_REUSEADDR   0x0004
+#define LWIP_SO_KEEPALIVE   0x0008
+#define LWIP_SO_BROADCAST   0x0020
+#define LWIP_SO_SNDBUF      0x1001
+#define LWIP_SO_RCVBUF      0x1002
+#define LWIP_SO_ERROR       0x1007
+#define LWIP_SO_TYPE        0x1008
+#define LWIP_TCP_NODELAY    0x01
+#define LWIP_TCP_KEEPALIVE  0x02
+#define LWIP_TCP_KEEPIDLE   0x03
+#define LWIP_TCP_KEEPINTVL  0x04
+#define LWIP_TCP_KEEPCNT    0x05
+#define LWIP_MSG_PEEK       0x01
+#define LWIP_MSG_WAITALL    0x02
+#define LWIP_MSG_OOB        0x04
+#define LWIP_MSG_DONTWAIT   0x08
+#define LWIP_MSG_MORE       0x10
+#define LWIP_F_GETFL        3
+#define LWIP_F_SETFL        4
+#define LWIP_O_NONBLOCK     1
+
+struct lwip_sockaddr_in {
+    uint8_t sin_len;
+    uint8_t sin_family;
+    uint16_t sin_port;
+    uint32_t sin_addr;
+    char sin_zero[8];
+};
+
+typedef struct {
+    uint32_t addr;
+} lwip_ip4_addr_t;
+
+// --------------
+// Translations
+// --------------
+
+static socklen_t sim_lwip_addr_in(const void *name, socklen_t namelen, struct sockaddr_in *host) {
+    const struct lwip_sockaddr_in *in = name;
+    memset(host, 0, sizeof(*host));
+    if (namelen < sizeof(struct lwip_sockaddr_in)) {
+        return 0;
+    }
+    host->sin_family = in->sin_family;
+    host->sin_port = in->sin_port;
+    host->sin_addr.s_addr = in->sin_addr;
+    return sizeof(*host);
+}
+
+static void sim_lwip_addr_out(const struct sockaddr_in *host, void *name, socklen_t *namelen) {
+    if (!name || !namelen) {
+        return;
+    }
+    struct lwip_sockaddr_in out;
+    memset(&out, 0, sizeof(out));
+    out.sin_len = sizeof(out);
+    out.sin_family = host->sin_family;
+    out.sin_port = host->sin_port;
+    out.sin_addr = host->sin_addr.s_addr;
+    socklen_t len = *namelen < sizeof(out) ? *namelen : sizeof(out);
+    memcpy(name, &out, len);
+    *namelen = sizeof(out);
+}
+
+static int sim_lwip_flags(int flags) {
+    int host = MSG_NOSIGNAL;
+    if (flags & LWIP_MSG_PEEK) {
+        host |= MSG_PEEK;
+    }
+    if (flags & LWIP_MSG_WAITALL) {
+        host |= MSG_WAITALL;
+    }
+    if (flags & LWIP_MSG_OOB) {
+        host |= MSG_OOB;
+    }
+    if (flags & LWIP_MSG_DONTWAIT) {
+        host |= MSG_DONTWAIT;
+    }
+    if (flags & LWIP_MSG_MORE) {
+        host |= MSG_MORE;
+    }
+    return host;
+}
+
+static bool sim_lwip_option(int *level, int *optname) {
+    // false if the option is unknown
+    if (*level == LWIP_SOL_SOCKET) {
+        *level = SOL_SOCKET;
+        switch (*optname) {
+            case LWIP_SO_REUSEADDR: *optname = SO_REUSEADDR; return true;
+            case LWIP_SO_KEEPALIVE: *optname = SO_KEEPALIVE; return true;
+            case LWIP_SO_BROADCAST: *optname = SO_BROADCAST; return true;
+            case LWIP_SO_SNDBUF: *optname = SO_SNDBUF; return true;
+            case LWIP_SO_RCVBUF: *optname = SO_RCVBUF; return true;
+            case LWIP_SO_ERROR: *optname = SO_ERROR; return true;
+            case LWIP_SO_TYPE: *optname = SO_TYPE; return true;
+        }
+        return false;
+    }
+    if (*level == IPPROTO_TCP) {
+        switch (*optname) {
+            case LWIP_TCP_NODELAY: *optname = TCP_NODELAY; return true;
+            case LWIP_TCP_KEEPALIVE: *optname = TCP_KEEPIDLE; return true;
+            case LWIP_TCP_KEEPIDLE: *optname = TCP_KEEPIDLE; return true;
+            case LWIP_TCP_KEEPINTVL: *optname = TCP_KEEPINTVL; return true;
+            case LWIP_TCP_KEEPCNT: *optname = TCP_KEEPCNT; return true;
+        }
+        return false;
+    }
+    return *level == IPPROTO_IP;
+}
+
+// -------
+// Sockets
+// -------
+
+int lwip_socket(int domain, int type, int protocol) {
+    // lwIP picks the protocol by the type of stream and datagram sockets
+    return socket(domain, type, type == SOCK_RAW ? protocol : 0);
+}
+
+int lwip_bind(int s, const void *name, socklen_t namelen) {
+    struct sockaddr_in host;
+    if (!sim_lwip_addr_in(name, namelen, &host)) {
+        errno = EINVAL;
+        return -1;
+    }
+    return bind(s, (struct sockaddr*)&host, sizeof(host));
+}
+
+int lwip_listen(int s, int backlog) {
+    return listen(s, backlog);
+}
+
+int lwip_accept(int s, void *addr, socklen_t *addrlen) {
+    struct sockaddr_in host;
+    socklen_t host_len = sizeof(host);
+    sim_os_block_begin();
+    int r = accept(s, (struct sockaddr*)&host, &host_len);
+    int e = errno;
+    sim_os_block_end();
+    if (r >= 0) {
+        sim_lwip_addr_out(&host, addr, addrlen);
+    }
+    errno = e;
+    return r;
+}
+
+int lwip_connect(int s, const void *name, socklen_t namelen) {
+    struct sockaddr_in host;
+    if (!sim_lwip_addr_in(name, namelen, &host)) {
+        errno = EINVAL;
+        return -1;
+    }
+    sim_os_block_begin();
+    int r = connect(s, (struct sockaddr*)&host, sizeof(host));
+    int e = errno;
+    sim_os_block_end();
+    errno = e;
+    return r;
+}
+
+int lwip_close(int s) {
+    return close(s);
+}
+
+int lwip_getsockopt(int s, int level, int optname, void *optval, socklen_t *optlen) {
+    if (!sim_lwip_option(&level, &optname)) {
+        errno = ENOPROTOOPT;
+        return -1;
+    }
+    return getsockopt(s, level, optname, optval, optlen);
+}
+
+int lwip_setsockopt(int s, int level, int optname, const void *optval, socklen_t optlen) {
+    int seconds;
+    if (level == IPPROTO_TCP && optname == LWIP_TCP_KEEPALIVE && optlen == sizeof(int)) {
+        // milliseconds in lwIP
+        seconds = (*(const int*)optval + 999) / 1000;
+        optval = &seconds;
+    }
+    if (!sim_lwip_option(&level, &optname)) {
+        errno = ENOPROTOOPT;
+        return -1;
+    }
+    return setsockopt(s, level, optname, optval, optlen);
+}
+
+int lwip_recvfrom(int s, void *mem, size_t len, int flags, void *from, socklen_t *fromlen) {
+    struct sockaddr_in host;
+    socklen_t host_len = sizeof(host);
+    sim_os_block_begin();
+    int r = recvfrom(s, mem, len, sim_lwip_flags(flags), (struct sockaddr*)&host, &host_len);
+    int e = errno;
+    sim_os_block_end();
+    if (r >= 0 && from && host_len >= sizeof(host)) {
+        sim_lwip_addr_out(&host, from, fromlen);
+    } else if (r >= 0 && fromlen) {
+        *fromlen = 0;
+    }
+    errno = e;
+    return r;
+}
+
+int lwip_write(int s, const void *dataptr, size_t size) {
+    sim_os_block_begin();
+    int r = send(s, dataptr, size, MSG_NOSIGNAL);
+    int e = errno;
+    sim_os_block_end();
+    errno = e;
+    return r;
+}
+
+int lwip_writev(int s, const struct iovec *iov, int iovcnt) {
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = (struct iovec*)iov;
+    msg.msg_iovlen = iovcnt;
+    sim_os_block_begin();
+    int r = sendmsg(s, &msg, MSG_NOSIGNAL);
+    int e = errno;
+    sim_os_block_end();
+    errno = e;
+    return r;
+}
+
+int lwip_sendto(int s, const void *dataptr, size_t size, int flags, const void *to, socklen_t tolen) {
+    struct sockaddr_in host;
+    if (to && !sim_lwip_addr_in(to, tolen, &host)) {
+        errno = EINVAL;
+        return -1;
+    }
+    sim_os_block_begin();
+    int r = sendto(s, dataptr, size, sim_lwip_flags(flags), to ? (struct sockaddr*)&host : NULL, to ? sizeof(host) : 0);
+    int e = errno;
+    sim_os_block_end();
+    errno = e;
+    return r;
+}
+
+int lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, struct timeval *timeout) {
+    bool blocking = !timeout || timeout->tv_sec || timeout->tv_usec;
+    if (blocking) {
+        sim_os_block_begin();
+    }
+    fd_set errors;
+    FD_ZERO(&errors);
+    if (exceptset) {
+        errors = *exceptset;
+    }
+    int r = select(maxfdp1, readset, writeset, exceptset, timeout);
+    int e = errno;
+    if (blocking) {
+        sim_os_block_end();
+    }
+    // lwIP puts sockets with a pending error (eg a refused connect) in the
+    // exception set while host select only reports out-of-band data there
+    for (int fd = 0; r >= 0 && exceptset && fd < maxfdp1; fd++) {
+        if (!FD_ISSET(fd, &errors) || FD_ISSET(fd, exceptset)) {
+            continue;
+        }
+        struct pollfd p = {.fd = fd, .events = 0};
+        if (poll(&p, 1, 0) == 1 && (p.revents & POLLERR)) {
+            FD_SET(fd, exceptset);
+            r++;
+        }
+    }
+    errno = e;
+    return r;
+}
+
+int lwip_fcntl(int s, int cmd, int val) {
+    if (cmd == LWIP_F_GETFL) {
+        int flags = fcntl(s, F_GETFL, 0);
+        if (flags < 0) {
+            return -1;
+        }
+        return flags & O_NONBLOCK ? LWIP_O_NONBLOCK : 0;
+    }
+    if (cmd == LWIP_F_SETFL) {
+        int flags = fcntl(s, F_GETFL, 0);
+        if (flags < 0) {
+            return -1;
+        }
+        flags = val & LWIP_O_NONBLOCK ? flags | O_NONBLOCK : flags & ~O_NONBLOCK;
+        return fcntl(s, F_SETFL, flags);
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+// -------------
+// IP addresses
+// -------------
+
+int ip4addr_aton(const char *cp, lwip_ip4_addr_t *addr) {
+    struct in_addr in;
+    if (!inet_aton(cp, &in)) {
+        return 0;
+    }
+    if (addr) {
+        addr->addr = in.s_addr;
+    }
+    return 1;
+}
+
+char *ip4addr_ntoa_r(const lwip_ip4_addr_t *addr, char *buf, int buflen) {
+    struct in_addr in = {.s_addr = addr->addr};
+    if (!inet_ntop(AF_INET, &in, buf, buflen)) {
+        return NULL;
+    }
+    return buf;
+}
+
+int DNS_GetHostByName2(uint8_t *hostname, uint8_t *ip) {
+    // resolves into a dotted quad of at most 16 chars; 0 on success
+    struct addrinfo hints, *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    sim_os_block_begin();
+    int r = getaddrinfo((const char*)hostname, NULL, &hints, &res);
+    sim_os_block_end();
+    if (r != 0) {
+        return -1;
+    }
+    struct sockaddr_in *in = (struct sockaddr_in*)res->ai_addr;
+    inet_ntop(AF_INET, &in->sin_addr, (char*)ip, 16);
+    freeaddrinfo(res);
+    return 0;
+}
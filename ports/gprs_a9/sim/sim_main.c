@@ -0,0 +1,185 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Host simulation of the gprs_a9 port: starts the SDK side (tasks, UARTs,
+// file system, modem) and hands over to _Main of the port like the module
+// firmware does.
+//
+// Usage: firmware.elf [-r DIR]
+//
+// The internal flash file system is DIR or, by default, a temporary
+// directory removed at exit. The REPL is on stdin and stdout.
+
+#include <ftw.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "api_os.h"
+#include "api_event.h"
+#include "api_hal_flash.h"
+#include "api_hal_pm.h"
+
+extern HANDLE mainTaskHandle;
+void _Main(void);
+
+static char sim_tmp_root[] = "/tmp/gprs_a9_sim.XXXXXX";
+static bool sim_tmp_used;
+
+HANDLE sim_main_task(void) {
+    return mainTaskHandle;
+}
+
+// ------
+// Events
+// ------
+
+static void sim_event_free(API_Event_t *event) {
+    OS_Free(event->pParam1);
+    OS_Free(event->pParam2);
+    OS_Free(event);
+}
+
+static uint8_t *sim_event_copy(const void *src, size_t len) {
+    // NUL-terminated so that strings can be passed as is
+    if (!src) {
+        return NULL;
+    }
+    uint8_t *dest = OS_Malloc(len + 1);
+    if (dest) {
+        memcpy(dest, src, len);
+        dest[len] = 0;
+    }
+    return dest;
+}
+
+API_Event_t *sim_event_new(uint32_t id, uint32_t param1, uint32_t param2,
+    const void *p1, size_t p1_len, const void *p2, size_t p2_len) {
+    API_Event_t *event = OS_Malloc(sizeof(API_Event_t));
+    if (!event) {
+        return NULL;
+    }
+    event->id = id;
+    event->param1 = param1;
+    event->param2 = param2;
+    event->pParam1 = sim_event_copy(p1, p1_len);
+    event->pParam2 = sim_event_copy(p2, p2_len);
+    if ((p1 && !event->pParam1) || (p2 && !event->pParam2)) {
+        sim_event_free(event);
+        return NULL;
+    }
+    return event;
+}
+
+static void sim_event_deliver(void *arg) {
+    API_Event_t *event = arg;
+    if (!mainTaskHandle || !OS_SendEvent(mainTaskHandle, event, OS_TIME_OUT_NO_WAIT, 0)) {
+        sim_event_free(event);
+    }
+}
+
+bool sim_event_send(API_Event_t *event, uint32_t ms) {
+    if (ms == 0) {
+        if (!mainTaskHandle || !OS_SendEvent(mainTaskHandle, event, OS_TIME_OUT_NO_WAIT, 0)) {
+            sim_event_free(event);
+            return false;
+        }
+        return true;
+    }
+    if (!sim_os_after(ms, sim_event_deliver, event)) {
+        sim_event_free(event);
+        return false;
+    }
+    return true;
+}
+
+bool sim_event_post(uint32_t id, uint32_t param1, uint32_t param2,
+    const void *p1, size_t p1_len, const void *p2, size_t p2_len) {
+    API_Event_t *event = sim_event_new(id, param1, param2, p1, p1_len, p2, p2_len);
+    return event && sim_event_send(event, 0);
+}
+
+bool sim_event_post_after(uint32_t ms, uint32_t id, uint32_t param1, uint32_t param2,
+    const void *p1, size_t p1_len, const void *p2, size_t p2_len) {
+    API_Event_t *event = sim_event_new(id, param1, param2, p1, p1_len, p2, p2_len);
+    return event && sim_event_send(event, ms);
+}
+
+// -------
+// Startup
+// -------
+
+static int sim_rm_entry(const char *path, const struct stat *st, int flag, struct FTW *ftw) {
+    (void)st;
+    (void)flag;
+    (void)ftw;
+    return remove(path);
+}
+
+static void sim_rm_tmp_root(void) {
+    if (sim_tmp_used) {
+        nftw(sim_tmp_root, sim_rm_entry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+}
+
+static void sim_usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-r DIR]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *root = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            root = argv[++i];
+        } else {
+            sim_usage(argv[0]);
+        }
+    }
+    if (!root) {
+        if (!mkdtemp(sim_tmp_root)) {
+            perror("mkdtemp");
+            return 1;
+        }
+        sim_tmp_used = true;
+        atexit(sim_rm_tmp_root);
+        root = sim_tmp_root;
+    }
+
+    // sockets report a closed peer with EPIPE
+    signal(SIGPIPE, SIG_IGN);
+    hal_SpiFlashErase(0, hal_SpiFlashGetSize());
+
+    sim_os_init();
+    sim_fs_init(root);
+    _Main();
+    sim_event_post(API_EVENT_ID_POWER_ON, POWER_ON_CAUSE_KEY, 0, NULL, 0, NULL, 0);
+    sim_event_post(API_EVENT_ID_SYSTEM_READY, 0, 0, NULL, 0, NULL, 0);
+    sim_network_init();
+    sim_uart_init();
+    sim_os_run();
+}
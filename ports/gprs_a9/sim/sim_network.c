@@ -0,0 +1,520 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Simulated modem: network registration, GPRS attach and activation, cell
+// info, operators, SMS storage and sending, USSD and calls. Requests are
+// answered with SDK events after `sim_network_delay` ms; the `_sim` module
+// makes them fail or go unanswered and fills the SIM card with messages.
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_network.h"
+#include "api_network.h"
+#include "api_sms.h"
+#include "api_ss.h"
+#include "api_call.h"
+#include "api_charset.h"
+
+uint32_t sim_network_delay = 10;
+uint32_t sim_network_fail;
+uint32_t sim_network_mute;
+
+static bool sim_net_attached;
+static bool sim_net_active;
+static bool sim_net_flight;
+static uint8_t sim_net_operator = 0;
+static Network_Register_Mode_t sim_net_mode = NETWORK_REGISTER_MODE_AUTO;
+
+Network_Location_t sim_cells[SIM_CELLS_MAX] = {
+    {.sMcc = {2, 5, 0}, .sMnc = {0, 0, 1}, .sLac = 7700, .sCellID = 0x1234, .iBsic = 21, .iRxLev = 40, .iRxLevSub = 40, .nArfcn = 50},
+};
+int sim_cells_n = 1;
+
+sim_sms_t sim_sms[SIM_SMS_MAX];
+sim_sms_sent_t sim_sms_sent[SIM_SMS_SENT_MAX];
+size_t sim_sms_sent_n;
+static SMS_Format_t sim_sms_format = SMS_FORMAT_TEXT;
+
+char sim_ussd_reply[SIM_USSD_MAX] = "OK";
+char sim_ussd_sent[SIM_USSD_MAX];
+char sim_call_number[SMS_PHONE_NUMBER_MAX_LEN + 1];
+
+static const struct {
+    uint8_t id[6];
+    const char *name;
+} sim_operators[] = {
+    {{2, 5, 0, 0, 0, 1}, "SIM Mobile"},
+    {{2, 5, 0, 0, 2, 0}, "SIM Other"},
+};
+
+#define SIM_OPERATORS_N (sizeof(sim_operators) / sizeof(sim_operators[0]))
+
+static bool sim_reply(uint32_t what, uint32_t ok_id, uint32_t fail_id, uint32_t param1, uint32_t param2) {
+    // posts the outcome of a request; false if it fails
+    if (sim_network_mute & what) {
+        return !(sim_network_fail & what);
+    }
+    bool ok = !(sim_network_fail & what);
+    sim_event_post_after(sim_network_delay, ok ? ok_id : fail_id, param1, param2, NULL, 0, NULL, 0);
+    return ok;
+}
+
+static void sim_net_attach_done(void *arg) {
+    (void)arg;
+    if (!sim_net_attached && !sim_net_flight) {
+        sim_net_attached = true;
+        sim_event_post(API_EVENT_ID_NETWORK_ATTACHED, 0, 0, NULL, 0, NULL, 0);
+    }
+}
+
+static void sim_net_activate_done(void *arg) {
+    (void)arg;
+    if (!sim_net_attached) {
+        sim_event_post(API_EVENT_ID_NETWORK_ACTIVATE_FAILED, 0, 0, NULL, 0, NULL, 0);
+    } else if (!sim_net_active) {
+        sim_net_active = true;
+        sim_event_post(API_EVENT_ID_NETWORK_ACTIVATED, 0, 0, NULL, 0, NULL, 0);
+    }
+}
+
+void sim_network_init(void) {
+    // the modem registers shortly after the power-on and attaches to GPRS
+    // by itself
+    sim_event_post_after(sim_network_delay, API_EVENT_ID_NETWORK_REGISTERED_HOME, 0, 0, NULL, 0, NULL, 0);
+    sim_event_post_after(sim_network_delay, API_EVENT_ID_SIGNAL_QUALITY, 20, 60, NULL, 0, NULL, 0);
+    sim_os_after(2 * sim_network_delay, sim_net_attach_done, NULL);
+}
+
+// ----
+// GPRS
+// ----
+
+bool Network_StartAttach(void) {
+    if (sim_network_mute & SIM_NET_ATTACH) {
+        return true;
+    }
+    if (sim_network_fail & SIM_NET_ATTACH) {
+        sim_event_post_after(sim_network_delay, API_EVENT_ID_NETWORK_ATTACH_FAILED, 0, 0, NULL, 0, NULL, 0);
+    } else if (sim_net_attached) {
+        sim_event_post_after(sim_network_delay, API_EVENT_ID_NETWORK_ATTACHED, 0, 0, NULL, 0, NULL, 0);
+    } else {
+        sim_os_after(sim_network_delay, sim_net_attach_done, NULL);
+    }
+    return true;
+}
+
+bool Network_StartDetach(void) {
+    sim_net_attached = false;
+    sim_net_active = false;
+    sim_reply(0, API_EVENT_ID_NETWORK_DETACHED, 0, 0, 0);
+    return true;
+}
+
+bool Network_StartActive(Network_PDP_Context_t context) {
+    (void)context;
+    if (sim_network_mute & SIM_NET_ACTIVATE) {
+        return true;
+    }
+    if (sim_network_fail & SIM_NET_ACTIVATE) {
+        sim_event_post_after(sim_network_delay, API_EVENT_ID_NETWORK_ACTIVATE_FAILED, 0, 0, NULL, 0, NULL, 0);
+    } else if (sim_net_active) {
+        sim_event_post_after(sim_network_delay, API_EVENT_ID_NETWORK_ACTIVATED, 0, 0, NULL, 0, NULL, 0);
+    } else {
+        sim_os_after(sim_network_delay, sim_net_activate_done, NULL);
+    }
+    return true;
+}
+
+bool Network_StartDeactive(uint8_t contextID) {
+    (void)contextID;
+    sim_net_active = false;
+    sim_reply(0, API_EVENT_ID_NETWORK_DEACTIVED, 0, 0, 0);
+    return true;
+}
+
+bool Network_GetAttachStatus(uint8_t *status) {
+    *status = sim_net_attached;
+    return true;
+}
+
+bool Network_GetActiveStatus(uint8_t *status) {
+    *status = sim_net_active;
+    return true;
+}
+
+bool Network_GetIp(char *ip, int len) {
+    if (!sim_net_active || len < 10) {
+        return false;
+    }
+    strcpy(ip, "127.0.0.1");
+    return true;
+}
+
+void sim_network_lost(void) {
+    // the network drops the GPRS context
+    if (sim_net_active) {
+        sim_net_active = false;
+        sim_event_post(API_EVENT_ID_NETWORK_DEACTIVED, 0, 0, NULL, 0, NULL, 0);
+    }
+    if (sim_net_attached) {
+        sim_net_attached = false;
+        sim_event_post(API_EVENT_ID_NETWORK_DETACHED, 0, 0, NULL, 0, NULL, 0);
+    }
+}
+
+// ------------
+// Registration
+// ------------
+
+bool Network_SetFrequencyBand(uint8_t band) {
+    return band != 0;
+}
+
+bool Network_SetFlightMode(bool enable) {
+    if (enable == sim_net_flight) {
+        return true;
+    }
+    sim_net_flight = enable;
+    if (enable) {
+        sim_network_lost();
+        sim_reply(0, API_EVENT_ID_NETWORK_DEREGISTER, 0, 0, 0);
+    } else {
+        sim_reply(0, API_EVENT_ID_NETWORK_REGISTERED_HOME, 0, 0, 0);
+        sim_os_after(2 * sim_network_delay, sim_net_attach_done, NULL);
+    }
+    return true;
+}
+
+bool Network_GetFlightMode(bool *isFlightMode) {
+    *isFlightMode = sim_net_flight;
+    return true;
+}
+
+bool Network_GetAvailableOperatorReq(void) {
+    Network_Operator_Info_t list[SIM_OPERATORS_N];
+    for (size_t i = 0; i < SIM_OPERATORS_N; i++) {
+        memcpy(list[i].operatorId, sim_operators[i].id, 6);
+        list[i].status = i == sim_net_operator ? NETWORK_OPERATOR_STATUS_CURRENT : NETWORK_OPERATOR_STATUS_AVAILABLE;
+    }
+    if (!(sim_network_mute & SIM_NET_SCAN)) {
+        sim_event_post_after(sim_network_delay, API_EVENT_ID_NETWORK_AVAILABEL_OPERATOR, SIM_OPERATORS_N, 0,
+            list, sizeof(list), NULL, 0);
+    }
+    return true;
+}
+
+bool Network_GetOperatorNameById(uint8_t *operatorId, uint8_t **operatorName) {
+    for (size_t i = 0; i < SIM_OPERATORS_N; i++) {
+        if (!memcmp(operatorId, sim_operators[i].id, 6)) {
+            *operatorName = (uint8_t*)sim_operators[i].name;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Network_GetCurrentOperator(uint8_t operatorId[6], Network_Register_Mode_t *mode) {
+    memcpy(operatorId, sim_operators[sim_net_operator].id, 6);
+    *mode = sim_net_mode;
+    return true;
+}
+
+bool Network_Register(uint8_t *operatorId, Network_Register_Mode_t mode) {
+    for (size_t i = 0; i < SIM_OPERATORS_N; i++) {
+        if (!memcmp(operatorId, sim_operators[i].id, 6)) {
+            sim_net_operator = i;
+            sim_net_mode = mode;
+            if (sim_reply(SIM_NET_REGISTER, API_EVENT_ID_NETWORK_REGISTERED_HOME, API_EVENT_ID_NETWORK_REGISTER_DENIED, 0, 0)) {
+                sim_os_after(2 * sim_network_delay, sim_net_attach_done, NULL);
+            }
+            return true;
+        }
+    }
+    sim_reply(0, API_EVENT_ID_NETWORK_REGISTER_DENIED, 0, 0, 0);
+    return true;
+}
+
+bool Network_DeRegister(void) {
+    sim_network_lost();
+    sim_reply(0, API_EVENT_ID_NETWORK_DEREGISTER, 0, 0, 0);
+    return true;
+}
+
+bool Network_GetCellInfoRequst(void) {
+    if (!(sim_network_mute & SIM_NET_CELLS)) {
+        sim_event_post_after(sim_network_delay, API_EVENT_ID_NETWORK_CELL_INFO, sim_cells_n, 0,
+            sim_cells, sizeof(Network_Location_t) * sim_cells_n, NULL, 0);
+    }
+    return true;
+}
+
+// ---
+// SMS
+// ---
+
+bool SMS_SetFormat(SMS_Format_t format, SIM_ID_t simID) {
+    (void)simID;
+    sim_sms_format = format;
+    return true;
+}
+
+bool SMS_SetParameter(SMS_Parameter_t *smsParameter, SIM_ID_t simID) {
+    (void)smsParameter;
+    (void)simID;
+    return true;
+}
+
+bool SMS_SetNewMessageStorage(SMS_Storage_t storage) {
+    return storage == SMS_STORAGE_SIM_CARD || storage == SMS_STORAGE_FLASH;
+}
+
+bool SMS_SendMessage(const char *phoneNumber, const uint8_t *message, uint16_t length, SIM_ID_t simID) {
+    (void)simID;
+    sim_sms_sent_t *sent = sim_sms_sent + sim_sms_sent_n % SIM_SMS_SENT_MAX;
+    free(sent->data);
+    sent->data = malloc(length);
+    if (!sent->data) {
+        return false;
+    }
+    memcpy(sent->data, message, length);
+    sent->len = length;
+    sent->pdu = sim_sms_format == SMS_FORMAT_PDU;
+    strncpy(sent->number, phoneNumber ? phoneNumber : "", sizeof(sent->number) - 1);
+    sent->number[sizeof(sent->number) - 1] = 0;
+    sim_sms_sent_n++;
+    sim_reply(SIM_NET_SMS, API_EVENT_ID_SMS_SENT, API_EVENT_ID_SMS_ERROR, 0, 0);
+    return true;
+}
+
+bool SMS_ListMessageRequst(SMS_Status_t smsStatus, SMS_Storage_t storage) {
+    (void)storage;
+    if (sim_network_mute & SIM_NET_SMS_LIST) {
+        return true;
+    }
+    for (int i = 0; i < SIM_SMS_MAX; i++) {
+        sim_sms_t *sms = sim_sms + i;
+        if (!sms->used || !(sms->status & smsStatus)) {
+            continue;
+        }
+        SMS_Message_Info_t info;
+        memset(&info, 0, sizeof(info));
+        info.index = sms->index;
+        info.status = sms->status;
+        info.phoneNumberType = sms->number_type;
+        info.phoneNumber[0] = '"';
+        strncpy((char*)info.phoneNumber + 1, sms->number, SMS_PHONE_NUMBER_MAX_LEN - 1);
+        const uint8_t *data = sim_sms_format == SMS_FORMAT_PDU ? sms->pdu : sms->text;
+        info.dataLen = sim_sms_format == SMS_FORMAT_PDU ? sms->pdu_len : sms->text_len;
+        // freed by the receiver
+        info.data = OS_Malloc(info.dataLen + 1);
+        if (!info.data) {
+            return false;
+        }
+        memcpy(info.data, data, info.dataLen);
+        info.data[info.dataLen] = 0;
+        if (!sim_event_post_after(sim_network_delay, API_EVENT_ID_SMS_LIST_MESSAGE, 0, 0, &info, sizeof(info), NULL, 0)) {
+            OS_Free(info.data);
+        }
+        // "statuses" of listed unread messages turn into read
+        if (sms->status == SMS_STATUS_UNREAD) {
+            sms->status = SMS_STATUS_READ;
+        }
+    }
+    return true;
+}
+
+bool SMS_DeleteMessage(uint8_t index, SMS_Status_t status, SMS_Storage_t storage) {
+    (void)status;
+    (void)storage;
+    for (int i = 0; i < SIM_SMS_MAX; i++) {
+        if (sim_sms[i].used && sim_sms[i].index == index) {
+            sim_sms[i].used = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SMS_GetStorageInfo(SMS_Storage_Info_t *storageInfo, SMS_Storage_t storage) {
+    memset(storageInfo, 0, sizeof(*storageInfo));
+    storageInfo->storageId = storage;
+    storageInfo->total = SIM_SMS_MAX;
+    for (int i = 0; i < SIM_SMS_MAX; i++) {
+        if (sim_sms[i].used) {
+            storageInfo->used++;
+            if (sim_sms[i].status == SMS_STATUS_UNREAD) {
+                storageInfo->unReadRecords++;
+            } else if (sim_sms[i].status == SMS_STATUS_READ) {
+                storageInfo->readRecords++;
+            } else if (sim_sms[i].status == SMS_STATUS_UNSENT) {
+                storageInfo->unsentRecords++;
+            } else {
+                storageInfo->sentRecords++;
+            }
+        }
+    }
+    return true;
+}
+
+bool SMS_LocalLanguage2Unicode(uint8_t *localIn, uint16_t localInLen, Charset_t localLanguage, uint8_t **unicodeOut, uint32_t *unicodeOutLen) {
+    // UTF-8 into UCS-2 (big endian)
+    (void)localLanguage;
+    uint8_t *out = OS_Malloc(localInLen * 2 + 2);
+    if (!out) {
+        return false;
+    }
+    uint32_t n = 0;
+    for (uint16_t i = 0; i < localInLen;) {
+        uint32_t c = localIn[i++];
+        if (c >= 0xe0 && i + 2 <= localInLen) {
+            c = ((c & 0x0f) << 12) | ((localIn[i] & 0x3f) << 6) | (localIn[i + 1] & 0x3f);
+            i += 2;
+        } else if (c >= 0xc0 && i + 1 <= localInLen) {
+            c = ((c & 0x1f) << 6) | (localIn[i] & 0x3f);
+            i += 1;
+        }
+        out[n++] = c >> 8;
+        out[n++] = c;
+    }
+    *unicodeOut = out;
+    *unicodeOutLen = n;
+    return true;
+}
+
+bool SMS_Unicode2LocalLanguage(uint8_t *unicodeIn, uint16_t unicodeLen, Charset_t localLanguage, uint8_t **localOut, uint32_t *localOutLen) {
+    // UCS-2 (big endian) into UTF-8
+    (void)localLanguage;
+    uint8_t *out = OS_Malloc(unicodeLen / 2 * 3 + 1);
+    if (!out) {
+        return false;
+    }
+    uint32_t n = 0;
+    for (uint16_t i = 0; i + 1 < unicodeLen; i += 2) {
+        uint16_t c = (unicodeIn[i] << 8) | unicodeIn[i + 1];
+        if (c < 0x80) {
+            out[n++] = c;
+        } else if (c < 0x800) {
+            out[n++] = 0xc0 | (c >> 6);
+            out[n++] = 0x80 | (c & 0x3f);
+        } else {
+            out[n++] = 0xe0 | (c >> 12);
+            out[n++] = 0x80 | ((c >> 6) & 0x3f);
+            out[n++] = 0x80 | (c & 0x3f);
+        }
+    }
+    out[n] = 0;
+    *localOut = out;
+    *localOutLen = n;
+    return true;
+}
+
+// ----
+// USSD
+// ----
+
+uint16_t GSM_8BitTo7Bit(const uint8_t *in, uint8_t *out, uint16_t inLen) {
+    // packs septets, the first one into the lowest bits
+    uint16_t n = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (uint16_t i = 0; i < inLen; i++) {
+        acc |= (uint32_t)(in[i] & 0x7f) << bits;
+        bits += 7;
+        while (bits >= 8) {
+            out[n++] = acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+    if (bits) {
+        out[n++] = acc;
+    }
+    return n;
+}
+
+uint16_t GSM_7BitTo8Bit(const uint8_t *in, uint8_t *out, uint16_t inLen) {
+    uint16_t n = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (uint16_t i = 0; i < inLen; i++) {
+        acc |= (uint32_t)in[i] << bits;
+        bits += 8;
+        while (bits >= 7) {
+            out[n++] = acc & 0x7f;
+            acc >>= 7;
+            bits -= 7;
+        }
+    }
+    // a zero septet completing the last byte is padding
+    if (n && out[n - 1] == 0 && inLen * 8 % 7 == 0) {
+        n--;
+    }
+    return n;
+}
+
+uint32_t SS_SendUSSD(USSD_Type_t usdType) {
+    uint8_t code[SIM_USSD_MAX];
+    uint16_t len = GSM_7BitTo8Bit(usdType.usdString, code, usdType.usdStringSize < SIM_USSD_MAX * 7 / 8 ? usdType.usdStringSize : SIM_USSD_MAX * 7 / 8);
+    memcpy(sim_ussd_sent, code, len);
+    sim_ussd_sent[len] = 0;
+    if (sim_network_mute & SIM_NET_USSD) {
+        return 0;
+    }
+    if (sim_network_fail & SIM_NET_USSD) {
+        sim_event_post_after(sim_network_delay, API_EVENT_ID_USSD_SEND_FAIL, 0, 0, NULL, 0, NULL, 0);
+        return 0;
+    }
+    // the reply and its packed text go into one block freed by the receiver
+    struct {
+        USSD_Type_t ussd;
+        uint8_t text[SIM_USSD_MAX];
+    } reply;
+    reply.ussd.usdStringSize = GSM_8BitTo7Bit((const uint8_t*)sim_ussd_reply, reply.text, strlen(sim_ussd_reply));
+    reply.ussd.option = 2;
+    reply.ussd.dcs = 0x0f;
+    API_Event_t *event = sim_event_new(API_EVENT_ID_USSD_SEND_SUCCESS, 0, 0, &reply, sizeof(reply), NULL, 0);
+    if (event) {
+        ((USSD_Type_t*)event->pParam1)->usdString = event->pParam1 + offsetof(typeof(reply), text);
+        sim_event_send(event, sim_network_delay);
+    }
+    return 0;
+}
+
+// -----
+// Calls
+// -----
+
+bool CALL_Dial(const char *number) {
+    strncpy(sim_call_number, number, sizeof(sim_call_number) - 1);
+    return true;
+}
+
+bool CALL_HangUp(void) {
+    sim_call_number[0] = 0;
+    sim_reply(0, API_EVENT_ID_CALL_HANGUP, 0, 0, 0);
+    return true;
+}
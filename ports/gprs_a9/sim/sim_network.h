@@ -0,0 +1,87 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MICROPY_INCLUDED_GPRS_A9_SIM_NETWORK_H
+#define MICROPY_INCLUDED_GPRS_A9_SIM_NETWORK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "api_network.h"
+#include "api_sms.h"
+
+// Requests that fail (sim_network_fail) or go unanswered (sim_network_mute)
+#define SIM_NET_ATTACH      (1 << 0)
+#define SIM_NET_ACTIVATE    (1 << 1)
+#define SIM_NET_REGISTER    (1 << 2)
+#define SIM_NET_SMS         (1 << 3)
+#define SIM_NET_SMS_LIST    (1 << 4)
+#define SIM_NET_USSD        (1 << 5)
+#define SIM_NET_SCAN        (1 << 6)
+#define SIM_NET_CELLS       (1 << 7)
+
+#define SIM_CELLS_MAX       8
+#define SIM_SMS_MAX         20
+#define SIM_SMS_DATA_MAX    400
+#define SIM_SMS_SENT_MAX    16
+#define SIM_USSD_MAX        184
+
+typedef struct {
+    bool used;
+    uint8_t index;
+    uint8_t status;
+    uint8_t number_type;
+    char number[SMS_PHONE_NUMBER_MAX_LEN];
+    uint8_t text[SIM_SMS_DATA_MAX];
+    uint16_t text_len;
+    uint8_t pdu[SIM_SMS_DATA_MAX]; // in hex
+    uint16_t pdu_len;
+} sim_sms_t;
+
+typedef struct {
+    char number[SMS_PHONE_NUMBER_MAX_LEN + 1];
+    bool pdu;
+    uint8_t *data;
+    size_t len;
+} sim_sms_sent_t;
+
+extern uint32_t sim_network_delay;
+extern uint32_t sim_network_fail;
+extern uint32_t sim_network_mute;
+
+extern Network_Location_t sim_cells[SIM_CELLS_MAX];
+extern int sim_cells_n;
+
+extern sim_sms_t sim_sms[SIM_SMS_MAX];
+extern sim_sms_sent_t sim_sms_sent[SIM_SMS_SENT_MAX];
+extern size_t sim_sms_sent_n;
+
+extern char sim_ussd_reply[SIM_USSD_MAX];
+extern char sim_ussd_sent[SIM_USSD_MAX];
+extern char sim_call_number[SMS_PHONE_NUMBER_MAX_LEN + 1];
+
+void sim_network_lost(void);
+
+#endif // MICROPY_INCLUDED_GPRS_A9_SIM_NETWORK_H
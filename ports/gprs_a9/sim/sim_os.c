@@ -0,0 +1,766 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Simulated OS: a single-core priority scheduler on top of pthreads
+//
+// Every task is a host thread but only the one in `sim_current` runs; the
+// others wait on their condition variables. The scheduler state is guarded
+// by `sim_lock`, which tasks hold only while inside the OS calls below. The
+// host main thread is the idle loop: it fires timers and sleeps until the
+// next deadline or a wake-up from a host thread (stdin reader, sockets).
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "api_os.h"
+#include "api_sys.h"
+#include "buffer.h"
+
+#define SIM_QUEUE_LEN       64
+#define SIM_STACK_MIN       (256 * 1024)
+// OS_Malloc hands out at most this much at once, like the module where the
+// free memory is fragmented
+#define SIM_MALLOC_MAX      (256 * 1024)
+#define SIM_DRIVER_PRIORITY (-1)
+
+enum {
+    SIM_READY = 0,
+    SIM_WAIT_EVENT,
+    SIM_WAIT_SEM,
+    SIM_WAIT_SLEEP,
+    SIM_WAIT_HOST,
+    SIM_DONE,
+};
+
+typedef struct sim_sem {
+    uint32_t count;
+} sim_sem_t;
+
+typedef struct sim_task {
+    pthread_t thread;
+    pthread_cond_t cond;
+    int prio;
+    int state;
+    uint64_t deadline; // us, 0: none
+    sim_sem_t *sem;
+    uint32_t critical;
+    PTASK_FUNC_T entry;
+    void *param;
+    void *stack;
+    size_t stack_size;
+    const char *name;
+    void *queue[SIM_QUEUE_LEN];
+    unsigned q_head;
+    unsigned q_len;
+    unsigned timers_fired;
+    struct sim_task *next;
+} sim_task_t;
+
+typedef struct sim_timer {
+    sim_task_t *task; // NULL: a call run by the driver task
+    uint64_t deadline;
+    OS_CALLBACK_FUNC_T fn;
+    void *param;
+    bool fired;
+    struct sim_timer *next;
+} sim_timer_t;
+
+typedef struct sim_call {
+    sim_call_t fn;
+    void *arg;
+    struct sim_call *next;
+} sim_call_item_t;
+
+static pthread_mutex_t sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_idle_cond;
+static sim_task_t *sim_tasks;
+static sim_task_t *sim_current;
+static sim_timer_t *sim_timers;
+static sim_call_item_t *sim_calls, **sim_calls_tail = &sim_calls;
+static sim_task_t *sim_driver;
+static bool sim_stdin_eof;
+static struct timespec sim_epoch;
+static __thread sim_task_t *sim_self;
+
+uint64_t sim_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)(ts.tv_sec - sim_epoch.tv_sec) * 1000000 + ts.tv_nsec / 1000 - sim_epoch.tv_nsec / 1000 + 1;
+}
+
+uint32_t sim_clock(void) {
+    return (uint32_t)(sim_now_us() * 16384 / 1000000);
+}
+
+static uint64_t sim_deadline(uint32_t ms) {
+    if (ms == OS_TIME_OUT_WAIT_FOREVER) {
+        return 0;
+    }
+    return sim_now_us() + (uint64_t)ms * 1000;
+}
+
+// ---------
+// Scheduler
+// ---------
+
+static sim_task_t *sim_pick(void) {
+    sim_task_t *best = NULL;
+    for (sim_task_t *t = sim_tasks; t; t = t->next) {
+        if (t->state == SIM_READY && (!best || t->prio < best->prio)) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void sim_dispatch(void) {
+    // hands the CPU over to the most urgent ready task or to the idle loop
+    sim_current = sim_pick();
+    if (sim_current) {
+        pthread_cond_signal(&sim_current->cond);
+    } else {
+        pthread_cond_signal(&sim_idle_cond);
+    }
+}
+
+static void sim_switch(sim_task_t *self) {
+    // called by the running task after changing its state; returns once it
+    // runs again
+    sim_dispatch();
+    while (sim_current != self) {
+        pthread_cond_wait(&self->cond, &sim_lock);
+    }
+}
+
+static void sim_make_ready(sim_task_t *t) {
+    t->state = SIM_READY;
+    t->deadline = 0;
+    if (!sim_self) {
+        pthread_cond_signal(&sim_idle_cond);
+    }
+}
+
+static bool sim_should_yield(sim_task_t *self) {
+    sim_task_t *next = sim_pick();
+    return self && !self->critical && sim_current == self && next && next->prio < self->prio;
+}
+
+static void sim_push_call(sim_call_t fn, void *arg, sim_call_item_t *item) {
+    item->fn = fn;
+    item->arg = arg;
+    item->next = NULL;
+    *sim_calls_tail = item;
+    sim_calls_tail = &item->next;
+    if (sim_driver && sim_driver->state == SIM_WAIT_EVENT) {
+        sim_make_ready(sim_driver);
+    }
+}
+
+static uint64_t sim_tick(void) {
+    // wakes up tasks whose timeouts expired and fires timers; returns the
+    // earliest pending deadline or 0
+    uint64_t now = sim_now_us();
+    uint64_t next = 0;
+    for (sim_task_t *t = sim_tasks; t; t = t->next) {
+        if (t->state != SIM_READY && t->state != SIM_DONE && t->state != SIM_WAIT_HOST && t->deadline) {
+            if (t->deadline <= now) {
+                sim_make_ready(t);
+            } else if (!next || t->deadline < next) {
+                next = t->deadline;
+            }
+        }
+    }
+    for (sim_timer_t **p = &sim_timers; *p;) {
+        sim_timer_t *timer = *p;
+        if (timer->fired) {
+            p = &timer->next;
+            continue;
+        }
+        if (timer->deadline > now) {
+            if (!next || timer->deadline < next) {
+                next = timer->deadline;
+            }
+            p = &timer->next;
+            continue;
+        }
+        if (timer->task) {
+            timer->fired = true;
+            timer->task->timers_fired++;
+            if (timer->task->state == SIM_WAIT_EVENT) {
+                sim_make_ready(timer->task);
+            }
+            p = &timer->next;
+        } else {
+            // the timer becomes a driver call
+            *p = timer->next;
+            sim_push_call(timer->fn, timer->param, (sim_call_item_t*)timer);
+        }
+    }
+    return next;
+}
+
+void sim_os_preempt(void) {
+    // lets a more urgent task run; called from the VM hook and OS calls
+    sim_task_t *self = sim_self;
+    if (!self || self->critical) {
+        return;
+    }
+    pthread_mutex_lock(&sim_lock);
+    sim_tick();
+    if (sim_should_yield(self)) {
+        sim_switch(self);
+    }
+    pthread_mutex_unlock(&sim_lock);
+}
+
+static void sim_block(sim_task_t *self, int state, uint64_t deadline) {
+    // blocks the running task until it is made ready (by an event, a
+    // semaphore or its deadline)
+    self->state = state;
+    self->deadline = deadline;
+    sim_switch(self);
+}
+
+void sim_os_block_begin(void) {
+    sim_task_t *self = sim_self;
+    if (!self) {
+        return;
+    }
+    pthread_mutex_lock(&sim_lock);
+    self->state = SIM_WAIT_HOST;
+    sim_dispatch();
+    pthread_mutex_unlock(&sim_lock);
+}
+
+void sim_os_block_end(void) {
+    sim_task_t *self = sim_self;
+    if (!self) {
+        return;
+    }
+    pthread_mutex_lock(&sim_lock);
+    sim_make_ready(self);
+    pthread_cond_signal(&sim_idle_cond);
+    // wait for the scheduler to pick us: a running task switches at its next
+    // preemption point, the idle loop at once
+    while (sim_current != self) {
+        if (!sim_current) {
+            sim_dispatch();
+            continue;
+        }
+        pthread_cond_wait(&self->cond, &sim_lock);
+    }
+    pthread_mutex_unlock(&sim_lock);
+}
+
+static void *sim_task_main(void *arg) {
+    sim_task_t *self = arg;
+    sim_self = self;
+    pthread_mutex_lock(&sim_lock);
+    while (sim_current != self) {
+        pthread_cond_wait(&self->cond, &sim_lock);
+    }
+    pthread_mutex_unlock(&sim_lock);
+    self->entry(self->param);
+    pthread_mutex_lock(&sim_lock);
+    self->state = SIM_DONE;
+    sim_dispatch();
+    pthread_mutex_unlock(&sim_lock);
+    return NULL;
+}
+
+static sim_task_t *sim_task_new(PTASK_FUNC_T entry, void *param, size_t stack_size, int prio, const char *name) {
+    sim_task_t *t = calloc(1, sizeof(sim_task_t));
+    if (!t) {
+        return NULL;
+    }
+    t->entry = entry;
+    t->param = param;
+    t->prio = prio;
+    t->name = name;
+    // 64-bit frames are larger: give the thread more than asked for
+    t->stack_size = stack_size * 2 < SIM_STACK_MIN ? SIM_STACK_MIN : stack_size * 2;
+    if (posix_memalign(&t->stack, 4096, t->stack_size)) {
+        free(t);
+        return NULL;
+    }
+    pthread_cond_init(&t->cond, NULL);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, t->stack, t->stack_size);
+    pthread_mutex_lock(&sim_lock);
+    t->state = SIM_READY;
+    sim_task_t **p = &sim_tasks;
+    while (*p) {
+        p = &(*p)->next;
+    }
+    *p = t;
+    int err = pthread_create(&t->thread, &attr, sim_task_main, t);
+    pthread_attr_destroy(&attr);
+    if (err) {
+        *p = NULL;
+        pthread_mutex_unlock(&sim_lock);
+        free(t->stack);
+        free(t);
+        return NULL;
+    }
+    if (sim_should_yield(sim_self)) {
+        sim_switch(sim_self);
+    }
+    pthread_mutex_unlock(&sim_lock);
+    return t;
+}
+
+// -----------
+// Driver task
+// -----------
+// Runs rx callbacks and SDK-side work (delayed events) on behalf of host
+// threads and timers, like interrupt handlers on the module.
+
+static void sim_driver_task(void *param) {
+    (void)param;
+    pthread_mutex_lock(&sim_lock);
+    for (;;) {
+        sim_call_item_t *item = sim_calls;
+        if (!item) {
+            sim_block(sim_self, SIM_WAIT_EVENT, 0);
+            continue;
+        }
+        sim_calls = item->next;
+        if (!sim_calls) {
+            sim_calls_tail = &sim_calls;
+        }
+        pthread_mutex_unlock(&sim_lock);
+        sim_call_t fn = item->fn;
+        void *arg = item->arg;
+        free(item);
+        fn(arg);
+        pthread_mutex_lock(&sim_lock);
+    }
+}
+
+bool sim_os_driver_call(sim_call_t fn, void *arg) {
+    // the item is as large as a timer so that timers can be turned into calls
+    sim_call_item_t *item = malloc(sizeof(sim_timer_t));
+    if (!item) {
+        return false;
+    }
+    pthread_mutex_lock(&sim_lock);
+    sim_push_call(fn, arg, item);
+    if (sim_should_yield(sim_self)) {
+        sim_switch(sim_self);
+    }
+    pthread_mutex_unlock(&sim_lock);
+    return true;
+}
+
+static bool sim_timer_start(sim_task_t *task, uint32_t ms, OS_CALLBACK_FUNC_T fn, void *param) {
+    sim_timer_t *timer = malloc(sizeof(sim_timer_t));
+    if (!timer) {
+        return false;
+    }
+    timer->task = task;
+    timer->deadline = sim_now_us() + (uint64_t)ms * 1000;
+    timer->fn = fn;
+    timer->param = param;
+    timer->fired = false;
+    pthread_mutex_lock(&sim_lock);
+    // ordered by deadline so that timers expiring together fire in order
+    sim_timer_t **p = &sim_timers;
+    while (*p && (*p)->deadline <= timer->deadline) {
+        p = &(*p)->next;
+    }
+    timer->next = *p;
+    *p = timer;
+    if (!sim_self) {
+        pthread_cond_signal(&sim_idle_cond);
+    }
+    pthread_mutex_unlock(&sim_lock);
+    return true;
+}
+
+static bool sim_timer_stop(sim_task_t *task, OS_CALLBACK_FUNC_T fn, void *param) {
+    bool found = false;
+    pthread_mutex_lock(&sim_lock);
+    for (sim_timer_t **p = &sim_timers; *p;) {
+        sim_timer_t *timer = *p;
+        if (timer->task == task && timer->fn == fn && timer->param == param) {
+            *p = timer->next;
+            if (timer->fired) {
+                task->timers_fired--;
+            }
+            free(timer);
+            found = true;
+        } else {
+            p = &timer->next;
+        }
+    }
+    pthread_mutex_unlock(&sim_lock);
+    return found;
+}
+
+bool sim_os_after(uint32_t ms, sim_call_t fn, void *arg) {
+    return sim_timer_start(NULL, ms, fn, arg);
+}
+
+void sim_os_cancel(sim_call_t fn, void *arg) {
+    sim_timer_stop(NULL, fn, arg);
+}
+
+// ---------
+// Idle loop
+// ---------
+
+void sim_os_stdin_closed(void) {
+    pthread_mutex_lock(&sim_lock);
+    sim_stdin_eof = true;
+    pthread_cond_signal(&sim_idle_cond);
+    pthread_mutex_unlock(&sim_lock);
+}
+
+static bool sim_quiescent(void) {
+    // nothing left to do: all tasks wait for events that nobody will send
+    if (sim_calls || sim_timers) {
+        return false;
+    }
+    for (sim_task_t *t = sim_tasks; t; t = t->next) {
+        if (t->state != SIM_DONE && (t->state != SIM_WAIT_EVENT || t->deadline || t->q_len || t->timers_fired)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void sim_os_init(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sim_idle_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    clock_gettime(CLOCK_MONOTONIC, &sim_epoch);
+    sim_driver = sim_task_new(sim_driver_task, NULL, 0, SIM_DRIVER_PRIORITY, "driver");
+}
+
+void sim_os_run(void) {
+    pthread_mutex_lock(&sim_lock);
+    for (;;) {
+        if (sim_current) {
+            pthread_cond_wait(&sim_idle_cond, &sim_lock);
+            continue;
+        }
+        uint64_t next = sim_tick();
+        sim_dispatch();
+        if (sim_current) {
+            continue;
+        }
+        if (sim_stdin_eof && sim_quiescent()) {
+            pthread_mutex_unlock(&sim_lock);
+            exit(0);
+        }
+        if (next) {
+            struct timespec ts;
+            uint64_t at = next - 1 + sim_epoch.tv_nsec / 1000;
+            ts.tv_sec = sim_epoch.tv_sec + at / 1000000;
+            ts.tv_nsec = (at % 1000000) * 1000;
+            pthread_cond_timedwait(&sim_idle_cond, &sim_lock, &ts);
+        } else {
+            pthread_cond_wait(&sim_idle_cond, &sim_lock);
+        }
+    }
+}
+
+// ------
+// Tasks
+// ------
+
+HANDLE OS_CreateTask(PTASK_FUNC_T pTaskEntry, void *pParameter, void *pStackAddr,
+    uint16_t nStackSize, uint8_t nPriority, uint16_t nCreationFlags, uint16_t nTimeSlice,
+    const char *pTaskName) {
+    (void)pStackAddr;
+    (void)nCreationFlags;
+    (void)nTimeSlice;
+    return sim_task_new(pTaskEntry, pParameter, (size_t)nStackSize * 4, nPriority, pTaskName);
+}
+
+bool OS_GetTaskInfo(HANDLE pHTask, OS_Task_Info_t *pTaskInfo) {
+    sim_task_t *t = pHTask;
+    if (!t) {
+        return false;
+    }
+    pTaskInfo->stackTop = (uintptr_t)t->stack;
+    pTaskInfo->stackSize = t->stack_size / 4;
+    pTaskInfo->priority = t->prio;
+    pTaskInfo->usedSize = 0;
+    return true;
+}
+
+void OS_SetUserMainHandle(HANDLE *appMainHandle) {
+    (void)appMainHandle;
+}
+
+// ------
+// Events
+// ------
+
+bool OS_WaitEvent(HANDLE pHTask, void **pEvent, uint32_t nTimeOut) {
+    sim_task_t *self = pHTask;
+    uint64_t deadline = sim_deadline(nTimeOut);
+    pthread_mutex_lock(&sim_lock);
+    for (;;) {
+        // callback timers of the task run here, as with the SDK
+        while (self->timers_fired) {
+            sim_timer_t **p = &sim_timers;
+            while (!((*p)->task == self && (*p)->fired)) {
+                p = &(*p)->next;
+            }
+            sim_timer_t *timer = *p;
+            *p = timer->next;
+            self->timers_fired--;
+            pthread_mutex_unlock(&sim_lock);
+            timer->fn(timer->param);
+            free(timer);
+            pthread_mutex_lock(&sim_lock);
+        }
+        if (self->q_len) {
+            *pEvent = self->queue[self->q_head];
+            self->q_head = (self->q_head + 1) % SIM_QUEUE_LEN;
+            self->q_len--;
+            pthread_mutex_unlock(&sim_lock);
+            return true;
+        }
+        if (nTimeOut == OS_TIME_OUT_NO_WAIT || (deadline && sim_now_us() >= deadline)) {
+            pthread_mutex_unlock(&sim_lock);
+            return false;
+        }
+        sim_block(self, SIM_WAIT_EVENT, deadline);
+    }
+}
+
+bool OS_SendEvent(HANDLE pHTask, void *pEvent, uint32_t nTimeOut, uint16_t nOption) {
+    (void)nTimeOut;
+    sim_task_t *t = pHTask;
+    if (!t) {
+        return false;
+    }
+    pthread_mutex_lock(&sim_lock);
+    if (t->q_len == SIM_QUEUE_LEN) {
+        pthread_mutex_unlock(&sim_lock);
+        return false;
+    }
+    if (nOption == OS_EVENT_PRI_URGENT) {
+        t->q_head = (t->q_head + SIM_QUEUE_LEN - 1) % SIM_QUEUE_LEN;
+        t->queue[t->q_head] = pEvent;
+    } else {
+        t->queue[(t->q_head + t->q_len) % SIM_QUEUE_LEN] = pEvent;
+    }
+    t->q_len++;
+    if (t->state == SIM_WAIT_EVENT) {
+        sim_make_ready(t);
+    }
+    if (sim_should_yield(sim_self)) {
+        sim_switch(sim_self);
+    }
+    pthread_mutex_unlock(&sim_lock);
+    return true;
+}
+
+// ------
+// Memory
+// ------
+
+void *OS_Malloc(uint32_t nSize) {
+    if (nSize > SIM_MALLOC_MAX) {
+        return NULL;
+    }
+    return malloc(nSize);
+}
+
+void *OS_Realloc(void *ptr, uint32_t nSize) {
+    if (nSize > SIM_MALLOC_MAX) {
+        return NULL;
+    }
+    return realloc(ptr, nSize);
+}
+
+bool OS_Free(void *pMemBlock) {
+    free(pMemBlock);
+    return true;
+}
+
+// -----
+// Sleep
+// -----
+
+bool OS_Sleep(uint32_t nMillisecondes) {
+    sim_task_t *self = sim_self;
+    if (!self) {
+        usleep(nMillisecondes * 1000);
+        return true;
+    }
+    pthread_mutex_lock(&sim_lock);
+    sim_tick();
+    sim_block(self, SIM_WAIT_SLEEP, sim_now_us() + (uint64_t)nMillisecondes * 1000);
+    pthread_mutex_unlock(&sim_lock);
+    return true;
+}
+
+bool OS_SleepUs(uint32_t us) {
+    // busy wait, like the SDK
+    uint64_t end = sim_now_us() + us;
+    while (sim_now_us() < end) {
+    }
+    sim_os_preempt();
+    return true;
+}
+
+// ------
+// Timers
+// ------
+
+bool OS_StartCallbackTimer(HANDLE hTask, uint32_t ms, OS_CALLBACK_FUNC_T callback, void *param) {
+    if (!hTask) {
+        return false;
+    }
+    return sim_timer_start(hTask, ms, callback, param);
+}
+
+bool OS_StopCallbackTimer(HANDLE hTask, OS_CALLBACK_FUNC_T callback, void *param) {
+    if (!hTask) {
+        return false;
+    }
+    return sim_timer_stop(hTask, callback, param);
+}
+
+// ----------
+// Semaphores
+// ----------
+
+HANDLE OS_CreateSemaphore(uint32_t nInitCount) {
+    sim_sem_t *sem = malloc(sizeof(sim_sem_t));
+    if (sem) {
+        sem->count = nInitCount;
+    }
+    return sem;
+}
+
+bool OS_DeleteSemaphore(HANDLE semaphore) {
+    free(semaphore);
+    return true;
+}
+
+bool OS_WaitForSemaphore(HANDLE semaphore, uint32_t nTimeOut) {
+    sim_sem_t *sem = semaphore;
+    sim_task_t *self = sim_self;
+    uint64_t deadline = sim_deadline(nTimeOut);
+    pthread_mutex_lock(&sim_lock);
+    for (;;) {
+        if (sem->count) {
+            sem->count--;
+            pthread_mutex_unlock(&sim_lock);
+            return true;
+        }
+        if (nTimeOut == OS_TIME_OUT_NO_WAIT || (deadline && sim_now_us() >= deadline)) {
+            pthread_mutex_unlock(&sim_lock);
+            return false;
+        }
+        self->sem = sem;
+        sim_block(self, SIM_WAIT_SEM, deadline);
+        self->sem = NULL;
+    }
+}
+
+void OS_ReleaseSemaphore(HANDLE semaphore) {
+    sim_sem_t *sem = semaphore;
+    pthread_mutex_lock(&sim_lock);
+    sem->count++;
+    for (sim_task_t *t = sim_tasks; t; t = t->next) {
+        if (t->state == SIM_WAIT_SEM && t->sem == sem) {
+            sim_make_ready(t);
+            break;
+        }
+    }
+    if (sim_should_yield(sim_self)) {
+        sim_switch(sim_self);
+    }
+    pthread_mutex_unlock(&sim_lock);
+}
+
+// -----------------
+// Critical sections
+// -----------------
+// Interrupts and task switches are off in critical sections: the running
+// task is not preempted until it leaves the outermost one.
+
+uint32_t SYS_EnterCriticalSection(void) {
+    if (sim_self) {
+        sim_self->critical++;
+    }
+    return 0;
+}
+
+void SYS_ExitCriticalSection(uint32_t state) {
+    (void)state;
+    if (sim_self && sim_self->critical && !--sim_self->critical) {
+        sim_os_preempt();
+    }
+}
+
+// ------------
+// Ring buffers
+// ------------
+
+void Buffer_Init(Buffer_t *buffer, uint8_t *data, uint32_t size) {
+    buffer->buffer = data;
+    buffer->size = size;
+    buffer->readIndex = 0;
+    buffer->length = 0;
+}
+
+int32_t Buffer_Puts(Buffer_t *buffer, const void *data, uint32_t length) {
+    // all or nothing
+    if (length > buffer->size - buffer->length) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        buffer->buffer[(buffer->readIndex + buffer->length++) % buffer->size] = ((const uint8_t *)data)[i];
+    }
+    return length;
+}
+
+int32_t Buffer_Gets(Buffer_t *buffer, void *data, uint32_t length) {
+    if (length > buffer->length) {
+        length = buffer->length;
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        ((uint8_t *)data)[i] = buffer->buffer[buffer->readIndex];
+        buffer->readIndex = (buffer->readIndex + 1) % buffer->size;
+        buffer->length--;
+    }
+    return length;
+}
@@ -0,0 +1,274 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Simulated UARTs: UART1, the REPL, is wired to stdin and stdout of the
+// process; UART2 is wired to buffers of the `_sim` module. Received data is
+// delivered to the rx callbacks from the driver task, as from the interrupt
+// handler on the module.
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "api_hal_uart.h"
+
+#include "py/ringbuf.h"
+
+#define SIM_UART_CHUNK      256
+#define SIM_UART_TX_MAX     (64 * 1024)
+
+// rx ring buffers of uart.c: stdin is paced to the room left in them
+extern ringbuf_t uart_ringbuf[];
+
+typedef struct {
+    bool open;
+    UART_Config_t config;
+    uint8_t *tx;
+    size_t tx_len;
+} sim_uart_t;
+
+typedef struct {
+    int port;
+    size_t len;
+    uint8_t data[];
+} sim_uart_rx_t;
+
+static sim_uart_t sim_uart[UART_PORT_MAX];
+static pthread_mutex_t sim_uart_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct termios sim_uart_termios;
+static bool sim_uart_raw;
+// stdin chunks delivered to the rx callback
+static volatile unsigned sim_uart_stdin_done;
+
+bool UART_Init(UART_Port_t uartN, UART_Config_t config) {
+    if (uartN != UART1 && uartN != UART2) {
+        return false;
+    }
+    sim_uart[uartN].config = config;
+    sim_uart[uartN].open = true;
+    return true;
+}
+
+uint32_t UART_Write(UART_Port_t uartN, uint8_t *data, uint32_t length) {
+    if (uartN == UART1) {
+        size_t done = 0;
+        while (done < length) {
+            ssize_t n = write(STDOUT_FILENO, data + done, length - done);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            done += n;
+        }
+        return length;
+    }
+    if (uartN != UART2) {
+        return 0;
+    }
+    pthread_mutex_lock(&sim_uart_lock);
+    sim_uart_t *uart = sim_uart + uartN;
+    if (uart->tx_len + length > SIM_UART_TX_MAX) {
+        length = SIM_UART_TX_MAX - uart->tx_len;
+    }
+    uint8_t *tx = realloc(uart->tx, uart->tx_len + length + 1);
+    if (tx) {
+        memcpy(tx + uart->tx_len, data, length);
+        uart->tx = tx;
+        uart->tx_len += length;
+    } else {
+        length = 0;
+    }
+    pthread_mutex_unlock(&sim_uart_lock);
+    return length;
+}
+
+uint32_t UART_Read(UART_Port_t uartN, uint8_t *data, uint32_t length, uint32_t timeOutMs) {
+    // data arrives through rx callbacks only
+    (void)uartN;
+    (void)data;
+    (void)length;
+    (void)timeOutMs;
+    return 0;
+}
+
+bool UART_Close(UART_Port_t uartN) {
+    if (uartN != UART1 && uartN != UART2) {
+        return false;
+    }
+    sim_uart[uartN].open = false;
+    return true;
+}
+
+size_t sim_uart_tx_take(int port, uint8_t *buf, size_t len) {
+    // moves up to len transmitted bytes into buf
+    if (port != UART2) {
+        return 0;
+    }
+    pthread_mutex_lock(&sim_uart_lock);
+    sim_uart_t *uart = sim_uart + port;
+    if (len > uart->tx_len) {
+        len = uart->tx_len;
+    }
+    memcpy(buf, uart->tx, len);
+    memmove(uart->tx, uart->tx + len, uart->tx_len - len);
+    uart->tx_len -= len;
+    pthread_mutex_unlock(&sim_uart_lock);
+    return len;
+}
+
+// --
+// rx
+// --
+
+static void sim_uart_rx_call(void *arg) {
+    // driver task: the rx "interrupt"
+    sim_uart_rx_t *rx = arg;
+    sim_uart_t *uart = sim_uart + rx->port;
+    if (uart->open && uart->config.rxCallback) {
+        UART_Callback_Param_t param = {
+            .port = rx->port,
+            .length = rx->len,
+            .buf = rx->data,
+        };
+        uart->config.rxCallback(param);
+    }
+    if (rx->port == UART1) {
+        __atomic_add_fetch(&sim_uart_stdin_done, 1, __ATOMIC_RELEASE);
+    }
+    free(rx);
+}
+
+void sim_uart_rx(int port, const uint8_t *data, size_t len) {
+    if (port != UART1 && port != UART2) {
+        return;
+    }
+    sim_uart_rx_t *rx = malloc(sizeof(sim_uart_rx_t) + len);
+    if (!rx) {
+        return;
+    }
+    rx->port = port;
+    rx->len = len;
+    memcpy(rx->data, data, len);
+    if (!sim_os_driver_call(sim_uart_rx_call, rx)) {
+        free(rx);
+    }
+}
+
+static bool sim_uart_rx_ready(int port) {
+    // nothing is taken before the port is opened
+    return sim_uart[port].open && sim_uart[port].config.rxCallback && uart_ringbuf[port - 1].size;
+}
+
+static size_t sim_uart_rx_room(int port) {
+    ringbuf_t *ringbuf = uart_ringbuf + port - 1;
+    return (ringbuf->iget + ringbuf->size - ringbuf->iput - 1) % ringbuf->size;
+}
+
+static void sim_uart_restore(void) {
+    if (sim_uart_raw) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &sim_uart_termios);
+    }
+}
+
+static void *sim_uart_stdin(void *arg) {
+    // feeds stdin into UART1 no faster than the REPL takes it; an interrupt
+    // char goes through at once, like on the wire
+    (void)arg;
+    uint8_t buf[SIM_UART_CHUNK];
+    uint8_t last = 0;
+    unsigned posted = 0;
+    for (;;) {
+        ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            sim_os_stdin_closed();
+            return NULL;
+        }
+        if (sim_uart_raw && memchr(buf, 0x1c, n)) {
+            // Ctrl-\ quits
+            exit(0);
+        }
+        if (!sim_uart_raw) {
+            // piped scripts end lines as a terminal does; CR LF is kept
+            for (ssize_t i = 0; i < n; i++) {
+                if (buf[i] == '\n' && last != '\r') {
+                    buf[i] = '\r';
+                    last = '\n';
+                } else {
+                    last = buf[i];
+                }
+            }
+        }
+        size_t done = 0;
+        while (done < (size_t)n) {
+            size_t len = n - done;
+            if (!sim_uart_rx_ready(UART1)) {
+                len = 0;
+            } else if (!memchr(buf + done, 0x03, len)) {
+                size_t room = sim_uart_rx_room(UART1);
+                if (len > room) {
+                    len = room;
+                }
+            }
+            if (len == 0) {
+                usleep(1000);
+                continue;
+            }
+            sim_uart_rx(UART1, buf + done, len);
+            done += len;
+            posted++;
+            // the room is measured again once the chunk is in the ring
+            while (__atomic_load_n(&sim_uart_stdin_done, __ATOMIC_ACQUIRE) != posted) {
+                usleep(100);
+            }
+        }
+    }
+}
+
+void sim_uart_init(void) {
+    if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &sim_uart_termios) == 0) {
+        struct termios raw = sim_uart_termios;
+        raw.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON);
+        raw.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0) {
+            sim_uart_raw = true;
+            atexit(sim_uart_restore);
+        }
+    }
+    pthread_t thread;
+    pthread_create(&thread, NULL, sim_uart_stdin, NULL);
+    pthread_detach(thread);
+}
@@ -35,6 +35,7 @@
 #include "py/runtime.h"
 
 #include "api_hal_uart.h"
+#include "api_os.h"
 
 // ------------------------------
 // Hardware UART static variables
@@ -55,8 +56,13 @@ ringbuf_t uart_ringbuf[] = {
     {uart2_ringbuf_array, sizeof(uart2_ringbuf_array), 0, 0},
 };
 
+// Semaphores released by the rx handler to wake up a blocked reader
+static HANDLE uart_rx_sem[UART_NPORTS];
+static volatile uint8_t uart_rx_waiting[UART_NPORTS];
+
 // UART rx interrupt handler
 static void uart_rx_intr_handler(UART_Callback_Param_t param);
+static void uart_frame_rx(uint8_t uart, const uint8_t *src, size_t len);
 
 // UART configurations
 UART_Config_t uart_dev[] = {
@@ -102,34 +108,119 @@ bool uart_close(uint8_t uart) {
     return UART_Close(uart_port[uart]);
 }
 
+static size_t uart_rx_put(ringbuf_t *ringbuf, const uint8_t *src, size_t len) {
+    // Copies as much of src as fits into the ring buffer: at most two memcpy
+    // calls, one up to the end of the array and one from its start. Only the
+    // rx handler moves iput, only the reader moves iget.
+    uint16_t iput = ringbuf->iput;
+    size_t room = (ringbuf->iget + ringbuf->size - iput - 1) % ringbuf->size;
+    if (len > room) {
+        len = room;
+    }
+    size_t head = ringbuf->size - iput;
+    if (head > len) {
+        head = len;
+    }
+    memcpy(ringbuf->buf + iput, src, head);
+    memcpy(ringbuf->buf, src + head, len - head);
+    // publish the data before the index
+    __asm__ volatile ("" ::: "memory");
+    ringbuf->iput = (iput + len) % ringbuf->size;
+    return len;
+}
+
 static void uart_rx_intr_handler(UART_Callback_Param_t param) {
     // handles rx interrupts
-    ringbuf_t *ringbuf = uart_ringbuf + param.port - 1;
-    int* to_dupterm = uart_attached_to_dupterm + param.port - 1;
-    for (uint32_t i=0; i<param.length; i++) {
-        if (param.buf[i] == mp_interrupt_char) {
-            if (*to_dupterm)
-                mp_keyboard_interrupt();
+    uint8_t uart = param.port - 1;
+    ringbuf_t *ringbuf = uart_ringbuf + uart;
+    const uint8_t *src = param.buf;
+    size_t left = param.length;
+    if (uart_frame[uart].mode != UART_FRAME_NONE) {
+        uart_frame_rx(uart, src, left);
+        left = 0;
+    }
+    while (left) {
+        // the interrupt char is only special on the REPL port
+        size_t chunk = left;
+        const uint8_t *stop = NULL;
+        if (uart_attached_to_dupterm[uart] && mp_interrupt_char >= 0) {
+            stop = memchr(src, mp_interrupt_char, left);
+            if (stop) {
+                chunk = stop - src;
+            }
+        }
+        uart_rx_put(ringbuf, src, chunk); // the rest is dropped if full
+        if (stop) {
+            mp_sched_keyboard_interrupt();
+            chunk++;
         }
-        else
-            ringbuf_put(ringbuf, param.buf[i]);
+        src += chunk;
+        left -= chunk;
+    }
+    if (uart_rx_waiting[uart]) {
+        uart_rx_waiting[uart] = 0;
+        OS_ReleaseSemaphore(uart_rx_sem[uart]);
     }
+    #if MICROPY_REPL_EVENT_DRIVEN
+    if (uart_attached_to_dupterm[uart]) {
+        mp_hal_wake_stdin();
+    }
+    #endif
 }
 
 bool uart_rx_wait(uint8_t uart, uint32_t timeout_us) {
-    // waits for rx to become populated
-    uint32_t start = mp_hal_ticks_us();
+    // waits for rx to become populated: sleeps on the semaphore released by
+    // the rx handler and handles pending events in between
+    uint32_t start = mp_hal_ticks_ms();
+    // rounded up: a sub-millisecond wait still waits
+    uint32_t timeout = timeout_us / 1000 + (timeout_us % 1000 != 0);
     ringbuf_t *ringbuf = uart_ringbuf + uart;
+    if (!uart_rx_sem[uart]) {
+        uart_rx_sem[uart] = OS_CreateSemaphore(0);
+    }
     for (;;) {
+        // raise the flag before checking so that a byte arriving in between
+        // releases the semaphore
+        uart_rx_waiting[uart] = 1;
+        __asm__ volatile ("" ::: "memory");
         if (ringbuf->iget != ringbuf->iput) {
+            uart_rx_waiting[uart] = 0;
             return true; // have at least 1 char ready for reading
         }
-        if (mp_hal_ticks_us() - start >= timeout_us) {
+        uint32_t elapsed = mp_hal_ticks_ms() - start;
+        if (elapsed >= timeout) {
+            uart_rx_waiting[uart] = 0;
             return false; // timeout
         }
+        uint32_t slice = timeout - elapsed;
+        if (slice > UART_RX_WAIT_SLICE) {
+            slice = UART_RX_WAIT_SLICE;
+        }
+        OS_WaitForSemaphore(uart_rx_sem[uart], slice);
+        MICROPY_EVENT_POLL_HOOK
     }
 }
 
+size_t uart_rx_read(uint8_t uart, uint8_t *buf, size_t len) {
+    // copies up to len received bytes into buf; returns the number copied
+    ringbuf_t *ringbuf = uart_ringbuf + uart;
+    uint16_t iget = ringbuf->iget;
+    size_t avail = (ringbuf->iput + ringbuf->size - iget) % ringbuf->size;
+    if (len > avail) {
+        len = avail;
+    }
+    size_t head = ringbuf->size - iget;
+    if (head > len) {
+        head = len;
+    }
+    memcpy(buf, ringbuf->buf + iget, head);
+    memcpy(buf + head, ringbuf->buf, len - head);
+    // release the space only after copying
+    __asm__ volatile ("" ::: "memory");
+    ringbuf->iget = (iget + len) % ringbuf->size;
+    return len;
+}
+
 int uart_rx_any(uint8_t uart) {
     // checks if rx is not empty
     ringbuf_t *ringbuf = uart_ringbuf + uart;
@@ -169,48 +260,200 @@ int uart_get_rxbuf_len(uint8_t uart) {
 }
 
 void uart_set_rxbuf(uint8_t uart, uint8_t *buf, int len) {
+    mp_uint_t state = MICROPY_BEGIN_ATOMIC_SECTION();
     uart_ringbuf[uart].buf = buf;
     uart_ringbuf[uart].size = len;
     uart_ringbuf[uart].iget = 0;
     uart_ringbuf[uart].iput = 0;
+    uart_frame_t *frame = uart_frame + uart;
+    frame->started = frame->discard = frame->header = 0;
+    frame->fill = frame->remain = 0;
+    frame->put = frame->get = frame->signalled = 0;
+    MICROPY_END_ATOMIC_SECTION(state);
 }
 
-// Task-based UART interface
-/*
-#include "py/obj.h"
-#include "shared/runtime/pyexec.h"
-
-#if MICROPY_REPL_EVENT_DRIVEN
-void uart_task_handler(os_event_t *evt) {
-    if (pyexec_repl_active) {
-        // TODO: Just returning here isn't exactly right.
-        // What really should be done is something like
-        // enquing delayed event to itself, for another
-        // chance to feed data to REPL. Otherwise, there
-        // can be situation when buffer has bunch of data,
-        // and sits unprocessed, because we consumed all
-        // processing signals like this.
+// ---------------
+// Receive framing
+// ---------------
+// In a framed mode the rx handler assembles frames directly in the ring
+// buffer: payload bytes are written past iput and published together with
+// a length header only once the frame is complete. Readers, polls and waits
+// therefore never see partial frames.
+
+extern HANDLE mainTaskHandle;
+
+uart_frame_t uart_frame[UART_NPORTS];
+
+static void uart_frame_timer(void *param);
+
+static void uart_frame_append(ringbuf_t *ringbuf, uart_frame_t *frame, const uint8_t *src, size_t len) {
+    // stores payload of the frame being assembled; a frame that does not
+    // fit is skipped as a whole
+    frame->started = 1;
+    if (frame->discard || len == 0) {
+        return;
+    }
+    size_t room = (ringbuf->iget + ringbuf->size - ringbuf->iput - 1) % ringbuf->size;
+    if (UART_FRAME_HEADER + frame->fill + len > room) {
+        frame->discard = 1;
         return;
     }
+    uint16_t at = (ringbuf->iput + UART_FRAME_HEADER + frame->fill) % ringbuf->size;
+    size_t head = ringbuf->size - at;
+    if (head > len) {
+        head = len;
+    }
+    memcpy(ringbuf->buf + at, src, head);
+    memcpy(ringbuf->buf, src + head, len - head);
+    frame->fill += len;
+}
+
+static void uart_frame_end(uint8_t uart, bool commit) {
+    // publishes or drops the frame being assembled; empty frames are skipped
+    ringbuf_t *ringbuf = uart_ringbuf + uart;
+    uart_frame_t *frame = uart_frame + uart;
+    if (commit && !frame->discard && frame->fill) {
+        uint16_t iput = ringbuf->iput;
+        ringbuf->buf[iput] = frame->fill >> 8;
+        ringbuf->buf[(iput + 1) % ringbuf->size] = frame->fill & 0xff;
+        frame->put++;
+        // publish the frame before the index
+        __asm__ volatile ("" ::: "memory");
+        ringbuf->iput = (iput + UART_FRAME_HEADER + frame->fill) % ringbuf->size;
+    }
+    frame->started = frame->discard = frame->header = 0;
+    frame->fill = frame->remain = 0;
+}
 
-    int c, ret = 0;
-    while ((c = ringbuf_get(&stdin_ringbuf)) >= 0) {
-        if (c == mp_interrupt_char) {
-            mp_keyboard_interrupt();
+static void uart_frame_rx(uint8_t uart, const uint8_t *src, size_t len) {
+    // splits received data into frames; rx handler only
+    ringbuf_t *ringbuf = uart_ringbuf + uart;
+    uart_frame_t *frame = uart_frame + uart;
+    uint16_t put = frame->put;
+    uint32_t now = mp_hal_ticks_ms();
+    mp_uint_t state = MICROPY_BEGIN_ATOMIC_SECTION();
+    if (frame->gap && frame->started && now - frame->last >= frame->gap) {
+        uart_frame_end(uart, frame->mode == UART_FRAME_IDLE);
+    }
+    frame->last = now;
+    while (len) {
+        size_t chunk = len;
+        if (frame->mode == UART_FRAME_DELIMITER) {
+            const uint8_t *stop = memchr(src, frame->delimiter, len);
+            if (stop) {
+                chunk = stop - src;
+            }
+            uart_frame_append(ringbuf, frame, src, chunk);
+            if (stop) {
+                uart_frame_end(uart, true);
+                chunk++;
+            }
+        } else if (frame->mode == UART_FRAME_LENGTH) {
+            if (frame->header < frame->prefix) {
+                frame->started = 1;
+                frame->remain = (frame->remain << 8) | *src;
+                chunk = 1;
+                if (++frame->header == frame->prefix && frame->remain == 0) {
+                    uart_frame_end(uart, true);
+                }
+            } else {
+                if (chunk > frame->remain) {
+                    chunk = frame->remain;
+                }
+                uart_frame_append(ringbuf, frame, src, chunk);
+                frame->remain -= chunk;
+                if (frame->remain == 0) {
+                    uart_frame_end(uart, true);
+                }
+            }
+        } else {
+            uart_frame_append(ringbuf, frame, src, chunk);
         }
-        ret = pyexec_event_repl_process_char(c);
-        if (ret & PYEXEC_FORCED_EXIT) {
-            break;
+        src += chunk;
+        len -= chunk;
+    }
+    bool pending = frame->gap && frame->started;
+    MICROPY_END_ATOMIC_SECTION(state);
+
+    if (pending) {
+        OS_StopCallbackTimer(mainTaskHandle, uart_frame_timer, (void*)(uintptr_t)uart);
+        OS_StartCallbackTimer(mainTaskHandle, frame->gap, uart_frame_timer, (void*)(uintptr_t)uart);
+    }
+    if (frame->put != put) {
+        uart_frame_event(uart);
+    }
+}
+
+static void uart_frame_timer(void *param) {
+    // ends (idle mode) or drops (other modes) a frame after a silent gap;
+    // runs in the SDK task
+    uint8_t uart = (uintptr_t)param;
+    uart_frame_t *frame = uart_frame + uart;
+    uint16_t put = frame->put;
+    uint32_t wait = 0;
+    mp_uint_t state = MICROPY_BEGIN_ATOMIC_SECTION();
+    if (frame->gap && frame->started) {
+        uint32_t elapsed = mp_hal_ticks_ms() - frame->last;
+        if (elapsed >= frame->gap) {
+            uart_frame_end(uart, frame->mode == UART_FRAME_IDLE);
+        } else {
+            wait = frame->gap - elapsed;
         }
     }
+    MICROPY_END_ATOMIC_SECTION(state);
 
-    if (ret & PYEXEC_FORCED_EXIT) {
-        soft_reset();
+    if (wait) {
+        OS_StartCallbackTimer(mainTaskHandle, wait, uart_frame_timer, param);
+    }
+    if (frame->put != put) {
+        uart_frame_event(uart);
     }
 }
 
-void uart_task_init() {
-    system_os_task(uart_task_handler, UART_TASK_ID, uart_evt_queue, sizeof(uart_evt_queue) / sizeof(*uart_evt_queue));
+void uart_frame_setup(uint8_t uart, uint8_t mode, uint8_t delimiter, uint8_t prefix, uint32_t gap) {
+    // switches framing mode; drops anything received so far
+    OS_StopCallbackTimer(mainTaskHandle, uart_frame_timer, (void*)(uintptr_t)uart);
+    mp_uint_t state = MICROPY_BEGIN_ATOMIC_SECTION();
+    uart_frame_t *frame = uart_frame + uart;
+    frame->mode = mode;
+    frame->delimiter = delimiter;
+    frame->prefix = prefix;
+    frame->gap = gap;
+    MICROPY_END_ATOMIC_SECTION(state);
+    ringbuf_t *ringbuf = uart_ringbuf + uart;
+    uart_set_rxbuf(uart, ringbuf->buf, ringbuf->size);
+}
+
+int uart_frame_size(uint8_t uart) {
+    // the length of the oldest frame or -1 if none is queued
+    ringbuf_t *ringbuf = uart_ringbuf + uart;
+    uint16_t iget = ringbuf->iget;
+    if (iget == ringbuf->iput) {
+        return -1;
+    }
+    __asm__ volatile ("" ::: "memory");
+    return (ringbuf->buf[iget] << 8) | ringbuf->buf[(iget + 1) % ringbuf->size];
 }
-#endif */
 
+int uart_frame_read(uint8_t uart, uint8_t *buf, size_t len) {
+    // copies the oldest frame into buf; returns the frame length or -1 if
+    // none is queued. A frame longer than len stays queued.
+    int size = uart_frame_size(uart);
+    if (size < 0 || (size_t)size > len) {
+        return size;
+    }
+    ringbuf_t *ringbuf = uart_ringbuf + uart;
+    uint16_t iget = ringbuf->iget;
+    uint16_t at = (iget + UART_FRAME_HEADER) % ringbuf->size;
+    size_t head = ringbuf->size - at;
+    if (head > (size_t)size) {
+        head = size;
+    }
+    memcpy(buf, ringbuf->buf + at, head);
+    memcpy(buf + head, ringbuf->buf, size - head);
+    // release the space only after copying
+    __asm__ volatile ("" ::: "memory");
+    ringbuf->iget = (iget + UART_FRAME_HEADER + size) % ringbuf->size;
+    uart_frame[uart].get++;
+    return size;
+}
@@ -1,3 +1,6 @@
+#ifndef MICROPY_INCLUDED_GPRS_A9_UART_H
+#define MICROPY_INCLUDED_GPRS_A9_UART_H
+
 #include <stdint.h>
 #include <stdio.h>
 
@@ -7,18 +10,48 @@
 
 #define UART_NPORTS (2)
 #define UART_STATIC_RXBUF_LEN (2048)
+#define UART_RX_WAIT_SLICE (10) // ms between event polls while waiting for rx
+
+#define UART_FRAME_NONE (0)
+#define UART_FRAME_DELIMITER (1)
+#define UART_FRAME_IDLE (2)
+#define UART_FRAME_LENGTH (3)
+#define UART_FRAME_HEADER (2) // big-endian frame length in front of each frame in the ring
+
+typedef struct _uart_frame_t {
+    uint8_t mode;
+    uint8_t delimiter;
+    uint8_t prefix;         // size of the length prefix
+    uint8_t header;         // length prefix bytes received so far
+    uint8_t started;        // a frame is being assembled
+    uint8_t discard;        // the frame does not fit and is skipped
+    uint16_t fill;          // payload bytes stored so far
+    uint16_t remain;        // payload bytes still expected (length prefix)
+    uint32_t gap;           // silence (ms) ending a frame
+    uint32_t last;          // time (ms) of the last received chunk
+    volatile uint16_t put;  // frames completed: rx side only
+    volatile uint16_t get;  // frames read: reader only
+    uint16_t signalled;     // frames reported to the callback
+} uart_frame_t;
 
 void uart_set_rxbuf(uint8_t uart, uint8_t *buf, int len);
 int uart_get_rxbuf_len(uint8_t uart);
 bool uart_rx_wait(uint8_t uart, uint32_t timeout_us);
 int uart_rx_char(uint8_t uart);
+size_t uart_rx_read(uint8_t uart, uint8_t *buf, size_t len);
 uint32_t uart_tx_one_char(uint8_t uart, char c);
 int uart_rx_any(uint8_t uart);
 int uart_tx_any_room(uint8_t uart);
 bool uart_setup(uint8_t uart);
 bool uart_close(uint8_t uart);
+void uart_frame_setup(uint8_t uart, uint8_t mode, uint8_t delimiter, uint8_t prefix, uint32_t gap);
+int uart_frame_size(uint8_t uart);
+int uart_frame_read(uint8_t uart, uint8_t *buf, size_t len);
+void uart_frame_event(uint8_t uart); // machine_uart.c
 
 extern uint8_t *uart_ringbuf_array[2];
 extern UART_Config_t uart_dev[UART_NPORTS];
 extern ringbuf_t uart_ringbuf[UART_NPORTS];
+extern uart_frame_t uart_frame[UART_NPORTS];
 
+#endif // MICROPY_INCLUDED_GPRS_A9_UART_H
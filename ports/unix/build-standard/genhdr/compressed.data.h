@@ -0,0 +1,228 @@
+#define MP_MAX_UNCOMPRESSED_TEXT_LEN (73)
+MP_COMPRESSED_DATA("can'\364'%q\247objec\364argumen\364functio\356forma\364argument\363no\364mus\364positiona\354keywor\344strin\347'%s\247specifie\362t\357conver\364require\344typ\345fo\362b\345inde\370o\346ar\347attribut\345invali\344%\344empt\371implemente\344isn'\364unsupporte\344wit\350assignmen\364i\356\341outsid\345generato\362supporte\344lengt\350expecte\344overflo\367fro\355comple\370doesn'\364erro\362missin\347rang\345conversio\356identifie\362a\356n\357synta\370bu\364expectin\347ha\363in\364nam\345afte\362fiel\344foun\344give\356multipl\345need\363nonloca\354sequenc\345tupl\345allowe\344indice\363ou\364struct\272to\357unknow\356%\361dic\364i\363lis\364o\362zer\357impor\364numbe\362shoul\344specificatio\356value\363incompatibl\345issubclass(\251%\363an\344byte\363clas\363loca\354stor\345take\363valu\345allocatio\356expressio\356implicitl\371incomplet\345unexpecte\344.mp\371arg\363automati\343cod\345hea\360integers\254numberin\347operatio\356redefine\344sel\346negativ\345defaul\364failed\254go\364intege\362se\364suppor\364befor\345binar\371buffe\362divid\345inden\364manua\354memor\371mktim\345modul\345nativ\345retur\356switc\350unpac\353asyn\343")
+MP_MATCH_COMPRESSED("%c needs int or char", "\377%c\275\266\313char")
+MP_MATCH_COMPRESSED("%q index out of range", "\377\307\224\303\225\255")
+MP_MATCH_COMPRESSED("%q indices must be integers, not %s", "\377\307\302\210\223\346\207\324")
+MP_MATCH_COMPRESSED("%q() takes %d positional arguments but %d were given", "\377%q()\332\231\211\206\263\231were\273")
+MP_MATCH_COMPRESSED("'%q' argument required", "\377\201\203\220")
+MP_MATCH_COMPRESSED("'%s' object doesn't support item assignment", "\377\214\202\252\361item\237")
+MP_MATCH_COMPRESSED("'%s' object doesn't support item deletion", "\377\214\202\252\361item deletion")
+MP_MATCH_COMPRESSED("'%s' object has no attribute '%q'", "\377\214\202\265\261\227\201")
+MP_MATCH_COMPRESSED("'%s' object isn't an iterator", "\377\214\202\234\260iterator")
+MP_MATCH_COMPRESSED("'%s' object isn't callable", "\377\214\202\234callable")
+MP_MATCH_COMPRESSED("'%s' object isn't iterable", "\377\214\202\234iterable")
+MP_MATCH_COMPRESSED("'%s' object isn't subscriptable", "\377\214\202\234subscriptable")
+MP_MATCH_COMPRESSED("'=' alignment not allowed in string format specifier", "\377'=' alignment\207\301\240\213\205\215")
+MP_MATCH_COMPRESSED("'await' outside function", "\377'await'\242\204")
+MP_MATCH_COMPRESSED("'break'/'continue' outside loop", "\377'break'/'continue'\242loop")
+MP_MATCH_COMPRESSED("'return' outside function", "\377'return'\242\204")
+MP_MATCH_COMPRESSED("'yield' outside function", "\377'yield'\242\204")
+MP_MATCH_COMPRESSED("* arg after **", "\377*\226\270**")
+MP_MATCH_COMPRESSED("*x must be assignment target", "\377*x\210\223\237target")
+MP_MATCH_COMPRESSED("0.0 to a complex power", "\3770.0\216\241\251power")
+MP_MATCH_COMPRESSED("I/O operation on closed file", "\377I/O\350on closed file")
+MP_MATCH_COMPRESSED("LHS of keyword arg must be an id", "\377LHS\225\212\226\210\223\260id")
+MP_MATCH_COMPRESSED("[addrinfo error %d]", "\377[addrinfo\253%d]")
+MP_MATCH_COMPRESSED("__init__() should return None, not '%s'", "\377__init__()\317\374None,\207\214")
+MP_MATCH_COMPRESSED("abort() called", "abort() called")
+MP_MATCH_COMPRESSED("address %08x is not aligned to %d bytes", "\377address %08x\311\207aligned\216\231\326")
+MP_MATCH_COMPRESSED("annotation must be an identifier", "\377annotation\210\223\260\257")
+MP_MATCH_COMPRESSED("arg is an empty sequence", "\377\226\311\260\232\277")
+MP_MATCH_COMPRESSED("arg must be user-type", "\377\226\210\223user-type")
+MP_MATCH_COMPRESSED("argument name reused", "\377\203\267reused")
+MP_MATCH_COMPRESSED("argument num/types mismatch", "\377\203num/types mismatch")
+MP_MATCH_COMPRESSED("argument should be a '%q' not a '%q'", "\377\203\317\223\241\201\207\241\201")
+MP_MATCH_COMPRESSED("array/bytes required on right side", "\377array/bytes\220on right side")
+MP_MATCH_COMPRESSED("async for/with outside async function", "\377\377for/with\242\377\204")
+MP_MATCH_COMPRESSED("attributes not supported", "\377attributes\207\244")
+MP_MATCH_COMPRESSED("bad compile mode", "bad compile mode")
+MP_MATCH_COMPRESSED("bad typecode", "bad typecode")
+MP_MATCH_COMPRESSED("binary op %q not implemented", "\377\363op\307\207\233")
+MP_MATCH_COMPRESSED("bits must be 32 or less", "\377bits\210\22332\313less")
+MP_MATCH_COMPRESSED("buffer too small", "\377\364\305small")
+MP_MATCH_COMPRESSED("bytecode overflow", "\377bytecode\247")
+MP_MATCH_COMPRESSED("bytes value out of range", "\377\326\333\303\225\255")
+MP_MATCH_COMPRESSED("can't add special method to already-subclassed class", "\377\200add special method\216already-subclassed\327")
+MP_MATCH_COMPRESSED("can't assign to expression", "\377\200assign\216\335")
+MP_MATCH_COMPRESSED("can't cancel self", "\377\200cancel\352")
+MP_MATCH_COMPRESSED("can't convert %s to complex", "\377\200\217\324\216\251")
+MP_MATCH_COMPRESSED("can't convert %s to float", "\377\200\217\324\216float")
+MP_MATCH_COMPRESSED("can't convert %s to int", "\377\200\217\324\216\266")
+MP_MATCH_COMPRESSED("can't convert '%q' object to %q implicitly", "\377\200\217\201\202\216\307\336")
+MP_MATCH_COMPRESSED("can't convert NaN to int", "\377\200\217NaN\216\266")
+MP_MATCH_COMPRESSED("can't convert inf to int", "\377\200\217inf\216\266")
+MP_MATCH_COMPRESSED("can't create '%q' instances", "\377\200create\201instances")
+MP_MATCH_COMPRESSED("can't declare nonlocal in outer code", "\377\200declare\276\240outer\344")
+MP_MATCH_COMPRESSED("can't delete expression", "\377\200delete\335")
+MP_MATCH_COMPRESSED("can't do binary op between '%q' and '%q'", "\377\200do\363op between\201\325\201")
+MP_MATCH_COMPRESSED("can't implicitly convert '%q' to 'bool'", "\377\200\336\217\201\216'bool'")
+MP_MATCH_COMPRESSED("can't import name %q", "\377\200\315\267\307")
+MP_MATCH_COMPRESSED("can't load from '%q'", "\377\200load\250\201")
+MP_MATCH_COMPRESSED("can't load with '%q' index", "\377\200load\236\201\224")
+MP_MATCH_COMPRESSED("can't perform relative import", "\377\200perform relative\315")
+MP_MATCH_COMPRESSED("can't send non-None value to a just-started generator", "\377\200send non-None\333\216\241just-started\243")
+MP_MATCH_COMPRESSED("can't set attribute", "\377\200\360\227")
+MP_MATCH_COMPRESSED("can't store '%q'", "\377\200\331\201")
+MP_MATCH_COMPRESSED("can't store to '%q'", "\377\200\331\216\201")
+MP_MATCH_COMPRESSED("can't store with '%q' index", "\377\200\331\236\201\224")
+MP_MATCH_COMPRESSED("can't switch from automatic field numbering to manual field specification", "\377\200\375\250\343\271\347\216\367\271\320")
+MP_MATCH_COMPRESSED("can't switch from manual field specification to automatic field numbering", "\377\200\375\250\367\271\320\216\343\271\347")
+MP_MATCH_COMPRESSED("can't truncate-divide a complex number", "\377\200truncate-divide\241\251\316")
+MP_MATCH_COMPRESSED("can't unambiguously get sizeof scalar", "\377\200unambiguously get sizeof scalar")
+MP_MATCH_COMPRESSED("can't wait", "\377\200wait")
+MP_MATCH_COMPRESSED("casting", "casting")
+MP_MATCH_COMPRESSED("chr() arg not in range(0x110000)", "\377chr()\226\207\240range(0x110000)")
+MP_MATCH_COMPRESSED("comparison of int and uint", "\377comparison\225\266\325uint")
+MP_MATCH_COMPRESSED("complex divide by zero", "\377\251\365by\314")
+MP_MATCH_COMPRESSED("compression header", "compression header")
+MP_MATCH_COMPRESSED("conversion to object", "\377\256\216\202")
+MP_MATCH_COMPRESSED("default 'except' must be last", "\377\354'except'\210\223last")
+MP_MATCH_COMPRESSED("dict update sequence has wrong length", "\377\310update\277\265wrong\245")
+MP_MATCH_COMPRESSED("div/mod not implemented for uint", "\377div/mod\207\233\222uint")
+MP_MATCH_COMPRESSED("divide by zero", "\377\365by\314")
+MP_MATCH_COMPRESSED("empty", "\377\232")
+MP_MATCH_COMPRESSED("empty heap", "\377\232\345")
+MP_MATCH_COMPRESSED("empty separator", "\377\232separator")
+MP_MATCH_COMPRESSED("end of format while looking for conversion specifier", "\377end\225\205while looking\222\256\215")
+MP_MATCH_COMPRESSED("error in regex", "\377\253\240regex")
+MP_MATCH_COMPRESSED("exceptions must derive from BaseException", "\377exceptions\210derive\250BaseException")
+MP_MATCH_COMPRESSED("expected ':' after format specifier", "\377\246':'\270\205\215")
+MP_MATCH_COMPRESSED("expecting a dict for keyword args", "\377\264\241\310\222\212\342")
+MP_MATCH_COMPRESSED("expecting just a value for set", "\377\264just\241\333\222\360")
+MP_MATCH_COMPRESSED("expecting key:value for dict", "\377\264key:value\222\310")
+MP_MATCH_COMPRESSED("extra keyword arguments given", "\377extra\212\206\273")
+MP_MATCH_COMPRESSED("extra positional arguments given", "\377extra\211\206\273")
+MP_MATCH_COMPRESSED("format needs a dict", "\377\205\275\241\310")
+MP_MATCH_COMPRESSED("format string didn't convert all arguments", "\377\205\213didn't\217all\206")
+MP_MATCH_COMPRESSED("format string needs more arguments", "\377\205\213\275more\206")
+MP_MATCH_COMPRESSED("full", "full")
+MP_MATCH_COMPRESSED("function doesn't take keyword arguments", "\377\204\252take\212\206")
+MP_MATCH_COMPRESSED("function expected at most %d arguments, got %d", "\377\204\246at most\231arguments,\356\231")
+MP_MATCH_COMPRESSED("function got multiple values for argument '%q'", "\377\204\356\274\321\222\203\201")
+MP_MATCH_COMPRESSED("function missing %d required positional arguments", "\377\204\254\231\220\211\206")
+MP_MATCH_COMPRESSED("function missing keyword-only argument", "\377\204\254keyword-only\203")
+MP_MATCH_COMPRESSED("function missing required keyword argument '%q'", "\377\204\254\220\212\203\201")
+MP_MATCH_COMPRESSED("function missing required positional argument #%d", "\377\204\254\220\211\203#%d")
+MP_MATCH_COMPRESSED("function takes %d positional arguments but %d were given", "\377\204\332\231\211\206\263\231were\273")
+MP_MATCH_COMPRESSED("generator already executing", "\377\243already executing")
+MP_MATCH_COMPRESSED("generator ignored GeneratorExit", "\377\243ignored GeneratorExit")
+MP_MATCH_COMPRESSED("generator raised StopIteration", "\377\243raised StopIteration")
+MP_MATCH_COMPRESSED("hash is final", "\377hash\311final")
+MP_MATCH_COMPRESSED("heap must be a list", "\377\345\210\223\241\312")
+MP_MATCH_COMPRESSED("identifier redefined as global", "\377\257\351as global")
+MP_MATCH_COMPRESSED("identifier redefined as nonlocal", "\377\257\351as\276")
+MP_MATCH_COMPRESSED("import * not at module level", "\377\315*\207at\372level")
+MP_MATCH_COMPRESSED("incompatible .mpy arch", "\377\322\341arch")
+MP_MATCH_COMPRESSED("incompatible .mpy file", "\377\322\341file")
+MP_MATCH_COMPRESSED("incomplete format", "\377\337\205")
+MP_MATCH_COMPRESSED("incomplete format key", "\377\337\205key")
+MP_MATCH_COMPRESSED("incorrect padding", "incorrect padding")
+MP_MATCH_COMPRESSED("int() arg 2 must be >= 2 and <= 36", "\377int()\2262\210\223>= 2\325<= 36")
+MP_MATCH_COMPRESSED("integer needed", "\377\357needed")
+MP_MATCH_COMPRESSED("invalid format", "\377\230\205")
+MP_MATCH_COMPRESSED("invalid format specifier", "\377\230\205\215")
+MP_MATCH_COMPRESSED("invalid micropython decorator", "\377\230micropython decorator")
+MP_MATCH_COMPRESSED("invalid mktime usage", "\377\230\371usage")
+MP_MATCH_COMPRESSED("invalid syntax", "\377\230\262")
+MP_MATCH_COMPRESSED("invalid syntax for number", "\377\230\262\222\316")
+MP_MATCH_COMPRESSED("issubclass() arg 1 must be a class", "\377\323\2261\210\223\241\327")
+MP_MATCH_COMPRESSED("issubclass() arg 2 must be a class or a tuple of classes", "\377\323\2262\210\223\241\327\313\241\300\225classes")
+MP_MATCH_COMPRESSED("join expects a list of str/bytes objects consistent with self object", "\377join expects\241\312\225str/bytes objects consistent\236\352\202")
+MP_MATCH_COMPRESSED("keyword argument(s) not implemented - use normal args instead", "\377\212argument(s)\207\233- use normal\342instead")
+MP_MATCH_COMPRESSED("lhs and rhs should be compatible", "\377lhs\325rhs\317\223compatible")
+MP_MATCH_COMPRESSED("local '%q' has type '%q' but source is '%q'", "\377\330\201\265\221\201\263source\311\201")
+MP_MATCH_COMPRESSED("local '%q' used before type known", "\377\330\201used\362\221known")
+MP_MATCH_COMPRESSED("local variable referenced before assignment", "\377\330variable referenced\362\237")
+MP_MATCH_COMPRESSED("malformed f-string", "malformed f-string")
+MP_MATCH_COMPRESSED("math domain error", "\377math domain\253")
+MP_MATCH_COMPRESSED("memory allocation failed, allocating %u bytes", "\377\370\334\355allocating %u\326")
+MP_MATCH_COMPRESSED("memory allocation failed, heap is locked", "\377\370\334\355\345\311locked")
+MP_MATCH_COMPRESSED("memoryview offset too large", "\377memoryview offset\305large")
+MP_MATCH_COMPRESSED("mktime needs a tuple of length 8 or 9", "\377\371\275\241\300\225\2458\3139")
+MP_MATCH_COMPRESSED("multiple *x in assignment", "\377\274*x\240\237")
+MP_MATCH_COMPRESSED("multiple bases have instance lay-out conflict", "\377\274bases have instance lay-out conflict")
+MP_MATCH_COMPRESSED("must raise an object", "\377\210raise\260\202")
+MP_MATCH_COMPRESSED("must use keyword argument for key function", "\377\210use\212\203\222key\204")
+MP_MATCH_COMPRESSED("name '%q' isn't defined", "\377\267\201\234defined")
+MP_MATCH_COMPRESSED("name too long", "\377\267\305long")
+MP_MATCH_COMPRESSED("native code in .mpy unsupported", "\377\373\344\240\341\235")
+MP_MATCH_COMPRESSED("native yield", "\377\373yield")
+MP_MATCH_COMPRESSED("need more than %d values to unpack", "\377need more than\231\321\216\376")
+MP_MATCH_COMPRESSED("negative factorial", "\377\353factorial")
+MP_MATCH_COMPRESSED("negative shift count", "\377\353shift count")
+MP_MATCH_COMPRESSED("no active exception to reraise", "\377\261active exception\216reraise")
+MP_MATCH_COMPRESSED("no binding for nonlocal found", "\377\261binding\222\276\272")
+MP_MATCH_COMPRESSED("no module named '%q'", "\377\261\372named\201")
+MP_MATCH_COMPRESSED("no such attribute", "\377\261such\227")
+MP_MATCH_COMPRESSED("non-default argument follows default argument", "\377non-default\203follows\354\203")
+MP_MATCH_COMPRESSED("non-hex digit found", "\377non-hex digit\272")
+MP_MATCH_COMPRESSED("not a constant", "\377\207\241constant")
+MP_MATCH_COMPRESSED("object '%s' isn't a tuple or list", "\377\202\214\234\241\300\313\312")
+MP_MATCH_COMPRESSED("object not in sequence", "\377\202\207\240\277")
+MP_MATCH_COMPRESSED("object of type '%s' has no len()", "\377\202\225\221\214\265\261len()")
+MP_MATCH_COMPRESSED("object with buffer protocol required", "\377\202\236\364protocol\220")
+MP_MATCH_COMPRESSED("odd-length string", "\377odd-length\213")
+MP_MATCH_COMPRESSED("only slices with step=1 (aka None) are supported", "\377only slices\236step=1 (aka None) are\244")
+MP_MATCH_COMPRESSED("opcode", "opcode")
+MP_MATCH_COMPRESSED("ord() expected a character, but string of length %d found", "\377ord()\246\241character,\263\213\225\245\231\272")
+MP_MATCH_COMPRESSED("overflow converting long int to machine word", "\377\247converting long\266\216machine word")
+MP_MATCH_COMPRESSED("pop from an empty set", "\377pop\250\260\232\360")
+MP_MATCH_COMPRESSED("pop from empty list", "\377pop\250\232\312")
+MP_MATCH_COMPRESSED("popitem(): dictionary is empty", "\377popitem(): dictionary\311\232")
+MP_MATCH_COMPRESSED("positional arg after **", "\377\211\226\270**")
+MP_MATCH_COMPRESSED("positional arg after keyword arg", "\377\211\226\270\212\226")
+MP_MATCH_COMPRESSED("pow() with 3 arguments requires integers", "\377pow()\2363\206requires integers")
+MP_MATCH_COMPRESSED("queue overflow", "\377queue\247")
+MP_MATCH_COMPRESSED("raw f-strings are not supported", "\377raw f-strings are\207\244")
+MP_MATCH_COMPRESSED("requested length %d but object has length %d", "\377requested\245\231\263\202\265\245\231")
+MP_MATCH_COMPRESSED("return expected '%q' but got '%q'", "\377\374\246\201\263\356\201")
+MP_MATCH_COMPRESSED("rsplit(None,n)", "rsplit(None,n)")
+MP_MATCH_COMPRESSED("schedule queue full", "schedule queue full")
+MP_MATCH_COMPRESSED("sign not allowed in string format specifier", "\377sign\207\301\240\213\205\215")
+MP_MATCH_COMPRESSED("sign not allowed with integer format specifier 'c'", "\377sign\207\301\236\357\205\215'c'")
+MP_MATCH_COMPRESSED("single '}' encountered in format string", "\377single '}' encountered\240\205\213")
+MP_MATCH_COMPRESSED("slice step can't be zero", "\377slice step\200\223\314")
+MP_MATCH_COMPRESSED("splitting with sub-captures", "\377splitting\236sub-captures")
+MP_MATCH_COMPRESSED("start/end indices", "\377start/end\302")
+MP_MATCH_COMPRESSED("stream operation not supported", "\377stream\350\207\244")
+MP_MATCH_COMPRESSED("string argument without an encoding", "\377\213\203without\260encoding")
+MP_MATCH_COMPRESSED("string index out of range", "\377\213\224\303\225\255")
+MP_MATCH_COMPRESSED("string indices must be integers, not %s", "\377\213\302\210\223\346\207\324")
+MP_MATCH_COMPRESSED("struct: can't index", "\377\304\200\224")
+MP_MATCH_COMPRESSED("struct: index out of range", "\377\304\224\303\225\255")
+MP_MATCH_COMPRESSED("struct: no fields", "\377\304\261fields")
+MP_MATCH_COMPRESSED("substring not found", "\377substring\207\272")
+MP_MATCH_COMPRESSED("super() can't find self", "\377super()\200find\352")
+MP_MATCH_COMPRESSED("syntax error in JSON", "\377\262\253\240JSON")
+MP_MATCH_COMPRESSED("syntax error in uctypes descriptor", "\377\262\253\240uctypes descriptor")
+MP_MATCH_COMPRESSED("ticks interval overflow", "\377ticks interval\247")
+MP_MATCH_COMPRESSED("too many args", "\377\305many\342")
+MP_MATCH_COMPRESSED("too many values to unpack (expected %d)", "\377\305many\321\216\376(expected %d)")
+MP_MATCH_COMPRESSED("tuple index out of range", "\377\300\224\303\225\255")
+MP_MATCH_COMPRESSED("type '%q' isn't an acceptable base type", "\377\221\201\234\260acceptable base\221")
+MP_MATCH_COMPRESSED("type object '%q' has no attribute '%q'", "\377\221\202\201\265\261\227\201")
+MP_MATCH_COMPRESSED("type takes 1 or 3 arguments", "\377\221\3321\3133\206")
+MP_MATCH_COMPRESSED("unary op %q not implemented", "\377unary op\307\207\233")
+MP_MATCH_COMPRESSED("unexpected indent", "\377\340\366")
+MP_MATCH_COMPRESSED("unexpected keyword argument '%q'", "\377\340\212\203\201")
+MP_MATCH_COMPRESSED("unicode name escapes", "\377unicode\267escapes")
+MP_MATCH_COMPRESSED("unindent doesn't match any outer indent level", "\377unindent\252match any outer\366level")
+MP_MATCH_COMPRESSED("unknown conversion specifier %c", "\377\306\256\215%c")
+MP_MATCH_COMPRESSED("unknown format code '%c' for object of type '%s'", "\377\306\205\344'%c'\222\202\225\221\214")
+MP_MATCH_COMPRESSED("unknown type '%q'", "\377\306\221\201")
+MP_MATCH_COMPRESSED("unmatched '{' in format", "\377unmatched '{'\240\205")
+MP_MATCH_COMPRESSED("unreadable attribute", "\377unreadable\227")
+MP_MATCH_COMPRESSED("unsupported format character '%c' (0x%x) at index %d", "\377\235\205character '%c' (0x%x) at\224\231")
+MP_MATCH_COMPRESSED("unsupported type for %q: '%s'", "\377\235\221\222%q:\214")
+MP_MATCH_COMPRESSED("unsupported types for %q: '%s', '%s'", "\377\235types\222%q: '%s',\214")
+MP_MATCH_COMPRESSED("wrong number of arguments", "\377wrong\316\225\206")
+MP_MATCH_COMPRESSED("zero step", "\377\314step")
+// Total input length:      6523
+// Total compressed length: 3046
+// Total data length:       1153
+// Predicted saving:        2324
+
+// gzip length:             3594
+// Percentage of gzip:      116.8%
+// zlib length:             3582
+// Percentage of zlib:      117.2%
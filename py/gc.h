@@ -35,6 +35,12 @@ void gc_init(void *start, void *end);
 #if MICROPY_GC_SPLIT_HEAP
 // Used to add additional memory areas to the heap.
 void gc_add(void *start, void *end);
+
+#if MICROPY_GC_SPLIT_HEAP_AUTO
+// A given port must implement this to add (with gc_add) an area able to hold
+// an allocation of failed_alloc bytes. Returns true if an area was added.
+bool gc_try_add_heap(size_t failed_alloc);
+#endif
 #endif
 
 // These lock/unlock functions can be nested.
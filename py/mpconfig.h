@@ -616,6 +616,12 @@
 #define MICROPY_GC_SPLIT_HEAP (0)
 #endif
 
+// Whether to ask the port for another memory area when an allocation fails
+// even after a collection; the port must implement gc_try_add_heap().
+#ifndef MICROPY_GC_SPLIT_HEAP_AUTO
+#define MICROPY_GC_SPLIT_HEAP_AUTO (0)
+#endif
+
 // Hook to run code during time consuming garbage collector operations
 #ifndef MICROPY_GC_HOOK_LOOP
 #define MICROPY_GC_HOOK_LOOP
@@ -1458,6 +1464,13 @@ typedef double mp_float_t;
 #define MICROPY_PY_USELECT_SELECT (1)
 #endif
 
+// Whether the port provides mp_uselect_port_wait() (see extmod/moduselect.h)
+// so that poll()/select() block until an object may be ready instead of
+// spinning on MICROPY_EVENT_POLL_HOOK.
+#ifndef MICROPY_PY_USELECT_PORT_WAIT
+#define MICROPY_PY_USELECT_PORT_WAIT (0)
+#endif
+
 // Whether to provide "utime" module functions implementation
 // in terms of mp_hal_* functions.
 #ifndef MICROPY_PY_UTIME_MP_HAL
@@ -0,0 +1,65 @@
+# Cellular event delivery: callbacks run from the scheduler only, also when
+# its queue is full at the time of the event
+import cellular
+import micropython
+import time
+import _sim
+
+_sim.network(delay=10, fail=0, mute=0)
+time.sleep_ms(50)
+_sim.sms_clear()
+
+log = []
+
+
+def on_sms(sms):
+    log.append(sms.message if isinstance(sms, cellular.SMS) else sms)
+
+
+def receive(text):
+    _sim.event(_sim.EVENT_SMS_RECEIVED, 0, len(text), '"+1234",,"20/05/01,12:00:00+00"', text)
+
+
+cellular.on_sms(on_sms)
+receive("first")
+time.sleep_ms(20)
+print(log)
+
+# a scheduled function fills the queue: the message arrives meanwhile
+log = []
+
+
+def fill(_):
+    try:
+        while True:
+            micropython.schedule(lambda _: None, None)
+    except RuntimeError:
+        pass
+    receive("second")
+    time.sleep_ms(20)
+    log.append("filled")
+
+
+micropython.schedule(fill, None)
+time.sleep_ms(100)
+print(log)
+
+# polling a listing does not run callbacks in the middle of a scheduled function
+log = []
+_sim.sms_store(1, cellular.SMS_STATUS_READ, "+1234", "stored", None)
+
+
+def poll(_):
+    op = cellular.SMS.list_async()
+    receive("third")
+    time.sleep_ms(50)
+    op.done()
+    log.append("polled")
+    log.append([sms.message for sms in op.wait()])
+
+
+micropython.schedule(poll, None)
+time.sleep_ms(100)
+print(log)
+cellular.on_sms(None)
+_sim.sms_clear()
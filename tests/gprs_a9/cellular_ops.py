@@ -0,0 +1,63 @@
+# one operation of a kind at a time, CellularError and the rooted SMS list
+import cellular, gc, time, uerrno, _sim
+
+_sim.network(delay=10, fail=0, mute=0)
+_sim.sms_clear()
+time.sleep_ms(50)
+print(issubclass(cellular.CellularError, OSError))
+
+# a second listing waits for the first one
+_sim.sms_store(1, cellular.SMS_STATUS_UNREAD, "+1234", "first")
+_sim.sms_store(2, cellular.SMS_STATUS_UNREAD, "+1234", "second")
+op = cellular.SMS.list_async()
+try:
+    cellular.SMS.list_async()
+except OSError as e:
+    print("busy", e.errno == uerrno.EALREADY)
+# the pending list survives a collection
+gc.collect()
+for i in range(100):
+    bytearray(64)
+gc.collect()
+print(sorted(sms.message for sms in op.wait()))
+print(len(cellular.SMS.list()))
+
+# a silent USSD holds its kind until the timeout
+_sim.network(mute=_sim.NET_USSD)
+op = cellular.ussd_async("*100#", 200)
+try:
+    cellular.ussd("*100#", 100)
+except OSError as e:
+    print("busy", e.errno == uerrno.EALREADY)
+try:
+    op.wait()
+except OSError as e:
+    print(type(e).__name__, e.errno == uerrno.ETIMEDOUT)
+_sim.network(mute=0)
+
+# network failures are CellularErrors
+_sim.network(fail=_sim.NET_ACTIVATE)
+op = cellular.gprs_async("internet", "", "", 1000)
+try:
+    cellular.gprs(False)
+except OSError as e:
+    print("busy", e.errno == uerrno.EALREADY)
+try:
+    op.wait()
+except cellular.CellularError as e:
+    print("CellularError", e.errno == cellular.EACTIVATION)
+_sim.network(fail=0)
+print(cellular.gprs("internet", "", ""))
+print(cellular.gprs(False))
+print(cellular.gprs())
+
+# the whole extended code is raised
+_sim.event(_sim.EVENT_NO_SIMCARD, 0, 0)
+time.sleep_ms(20)
+try:
+    cellular.poll_network_exception()
+except cellular.CellularError as e:
+    print("CellularError", e.errno == cellular.ENOSIM)
+_sim.event(_sim.EVENT_REGISTERED_HOME, 0, 0)
+time.sleep_ms(20)
+print(cellular.is_network_registered())
@@ -0,0 +1,39 @@
+# station polls and the on_stations_change callback
+import cellular, gc, time, ustruct, _sim
+
+_sim.network(delay=10, fail=0, mute=0)
+time.sleep_ms(50)
+
+seen = []
+
+
+def watch(tag):
+    # the module holds the only reference to the closure
+    def on_change(records):
+        for i in range(0, len(records), cellular.STATION_RECORD_SIZE):
+            seen.append((tag,) + ustruct.unpack_from("<HHHHIBBB", records, i))
+
+    cellular.on_stations_change(on_change)
+
+
+watch("closure")
+gc.collect()
+# reuses whatever the collection freed
+junk = [bytearray(8) for i in range(500)]
+
+_sim.cells([(250, 1, 100, 1000, 5, 40, 40, 60)])
+print(cellular.stations(0))
+time.sleep_ms(20)
+print(seen)
+
+# the same stations again: no change
+seen.clear()
+cellular.stations(0)
+time.sleep_ms(20)
+print(seen)
+
+_sim.cells([(250, 1, 100, 1001, 5, 40, 40, 60), (250, 1, 100, 1000, 3, 20, 20, 61)])
+print(len(cellular.stations(0)))
+time.sleep_ms(20)
+print(seen)
+cellular.on_stations_change(None)
@@ -0,0 +1,53 @@
+# the GPRS supervisor, its on_gprs callback and manual control
+import cellular, gc, time, _sim
+
+_sim.network(delay=10, fail=0, mute=0)
+time.sleep_ms(50)
+
+links = []
+
+
+def watch():
+    # the module holds the only reference to the closure
+    cellular.on_gprs(lambda up: links.append(up))
+
+
+watch()
+gc.collect()
+junk = [bytearray(8) for i in range(500)]
+
+cellular.gprs_supervise("internet", "", "", 50, 200)
+time.sleep_ms(200)
+print(links, cellular.gprs(), cellular.gprs_supervisor_stats()[0] == cellular.SUPERVISOR_UP)
+
+# reconnected after a loss
+_sim.network_lost()
+time.sleep_ms(300)
+print(links, cellular.gprs())
+
+# switching on by hand takes the link over
+try:
+    cellular.gprs("internet", "", "")
+except ValueError as e:
+    print(e)
+print(cellular.gprs_supervisor_stats()[0] == cellular.SUPERVISOR_OFF)
+_sim.network_lost()
+time.sleep_ms(300)
+print(links, cellular.gprs())
+
+cellular.gprs_supervise("internet", "", "", 50, 200)
+time.sleep_ms(200)
+print(cellular.gprs_supervisor_stats()[0] == cellular.SUPERVISOR_UP)
+print(cellular.gprs_async(False).wait())
+print(cellular.gprs_supervisor_stats()[0] == cellular.SUPERVISOR_OFF)
+
+# the supervisor retrying in the background is stopped too
+_sim.network(fail=_sim.NET_ACTIVATE)
+cellular.gprs_supervise("internet", "", "", 50, 200)
+time.sleep_ms(100)
+print(cellular.gprs_supervisor_stats()[0] != cellular.SUPERVISOR_OFF)
+_sim.network(fail=0)
+print(cellular.gprs_async("internet", "", "").wait())
+print(cellular.gprs_supervisor_stats()[0] == cellular.SUPERVISOR_OFF)
+print(cellular.gprs(False))
+cellular.on_gprs(None)
@@ -0,0 +1,46 @@
+# GPS fix callbacks, also when the scheduler queue is full at the time of
+# the fix
+import gps
+import micropython
+import time
+import _sim
+
+events = []
+
+
+def feed(second, lat, valid="A"):
+    _sim.gps(
+        "$GPRMC,1200{:02d}.00,{},{},N,01320.0000,E,0.0,0.0,010520,,,A*00\r\n".format(
+            second, valid, lat
+        )
+    )
+    time.sleep_ms(20)
+
+
+gps.on()
+gps.on_fix(lambda e: events.append((e[0], round(e[1], 4), round(e[2], 4))), 100)
+feed(0, "5230.0000")
+feed(1, "5230.0010")  # under 100 m
+feed(2, "5230.1000")
+feed(3, "5230.1000", "V")
+print(events)
+
+# a scheduled function fills the queue: the fix arrives meanwhile
+events = []
+
+
+def fill(_):
+    try:
+        while True:
+            micropython.schedule(lambda _: None, None)
+    except RuntimeError:
+        pass
+    feed(4, "5230.2000")
+    print("queue full", events)
+
+
+micropython.schedule(fill, None)
+time.sleep_ms(100)
+print(events)
+gps.on_fix(None)
+gps.off()
@@ -0,0 +1,66 @@
+# GPS track: record fixes fed as NMEA, then compress them with
+# gps.track_encode and decode with the frozen gpstrack module
+import gps
+import gpstrack
+import time
+import ustruct
+import _sim
+
+FORMAT = "<IiiiHHBBB"  # and a padding byte
+
+
+def feed(second, lat, lon, alt):
+    _sim.gps(
+        "$GPRMC,1200{:02d}.00,A,{},N,{},E,1.5,90.0,010520,,,A*00\r\n"
+        "$GPGGA,1200{:02d}.00,{},N,{},E,1,07,1.2,{},M,0.0,M,,*00\r\n".format(
+            second, lat, lon, second, lat, lon, alt
+        )
+    )
+    time.sleep_ms(20)
+
+
+gps.on()
+gps.track(8, 0)
+points = [
+    (0, "5230.0000", "01320.0000", "35.0"),
+    (1, "5230.0010", "01320.0000", "35.5"),
+    (2, "5230.0020", "01320.0000", "35.5"),
+    (3, "5230.0030", "01320.0100", "36.0"),
+]
+for p in points:
+    feed(*p)
+# the same RMC time again is not a new fix
+feed(*points[-1])
+print(gps.track_stats())
+
+records = bytearray(8 * gps.RECORD_SIZE)
+n = gps.track_read(records)
+records = records[: n * gps.RECORD_SIZE]
+print(n, gps.track_stats())
+unpacked = [
+    ustruct.unpack_from(FORMAT, records, i * gps.RECORD_SIZE) for i in range(n)
+]
+print(unpacked[0])
+
+# lossless round trip
+out = bytearray(n * 46 + 1)
+size = gps.track_encode(records, out)
+print(size < len(records), list(gpstrack.decode(out[:size])) == unpacked)
+
+# the simplified track keeps the ends
+size = gps.track_encode(bytearray(records), out, 5.0)
+decoded = list(gpstrack.decode(out[:size]))
+print(len(decoded), decoded[0] == unpacked[0], decoded[-1] == unpacked[-1])
+
+# a full track drops new fixes
+gps.track(2, 0)
+for p in points:
+    feed(*p)
+print(gps.track_stats())
+
+try:
+    gps.track_encode(records, bytearray(4))
+except ValueError as e:
+    print(e)
+gps.track(0)
+gps.off()
@@ -0,0 +1,37 @@
+# The heap grows by extra OS blocks when a collection does not free enough,
+# up to a limit, and a growth that fails raises MemoryError
+import gc
+
+
+def total():
+    return gc.mem_free() + gc.mem_alloc()
+
+
+gc.collect()
+start = total()
+print(start <= 1024 * 1024)
+
+# Past the blocks gathered at startup
+blocks = []
+while total() <= start:
+    blocks.append(bytearray(16 * 1024))
+print(total() > start, len(blocks) > 1)
+
+# More than one OS block can hold
+try:
+    bytearray(1024 * 1024)
+except MemoryError:
+    print("MemoryError")
+
+# Up to the limit, then MemoryError rather than growing forever
+try:
+    while True:
+        blocks.append(bytearray(16 * 1024))
+except MemoryError:
+    print("MemoryError")
+grown = total()
+print(grown > start, grown <= 2 * 1024 * 1024)
+
+blocks = None
+gc.collect()
+print(total() == grown, gc.mem_free() > grown // 2)
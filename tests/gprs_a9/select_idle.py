@@ -0,0 +1,10 @@
+# uselect sleeps when there are no sockets to select on
+import micropython, uselect, utime
+
+ran = []
+p = uselect.poll()
+micropython.schedule(ran.append, "scheduled")
+t = utime.ticks_ms()
+print(p.poll(100), ran, 100 <= utime.ticks_diff(utime.ticks_ms(), t) < 150)
+t = utime.ticks_ms()
+print(p.poll(0), utime.ticks_diff(utime.ticks_ms(), t) < 10)
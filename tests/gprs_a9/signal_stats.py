@@ -0,0 +1,23 @@
+# Signal history: statistics over a time window
+import cellular
+import time
+import _sim
+
+time.sleep_ms(300)
+for quality in (10, 12, 14):
+    _sim.event(_sim.EVENT_SIGNAL_QUALITY, quality, 3)
+    time.sleep_ms(100)
+
+samples, lo, hi, mean, trend = cellular.signal_stats(250)
+print(samples, lo, hi, mean, trend > 0)
+print(cellular.signal_stats(250, True)[:4])
+print(cellular.signal_stats(0)[0])
+
+try:
+    cellular.signal_stats(-1)
+except ValueError as e:
+    print(e)
+
+# the quality reported at power-on
+_sim.event(_sim.EVENT_SIGNAL_QUALITY, 20, 60)
+time.sleep_ms(20)
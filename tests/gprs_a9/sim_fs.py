@@ -0,0 +1,19 @@
+# the internal flash file system of the simulation
+import os
+
+for name in os.listdir():
+    if name.startswith("test_"):
+        os.remove(name)
+
+with open("test_a.txt", "w") as f:
+    print(f.write("line 1\nline 2\n"))
+print("test_a.txt" in os.listdir())
+with open("test_a.txt") as f:
+    print(f.readlines())
+os.rename("test_a.txt", "test_b.txt")
+print(sorted(n for n in os.listdir() if n.startswith("test_")))
+os.remove("test_b.txt")
+try:
+    open("test_b.txt")
+except OSError as e:
+    print("OSError")
@@ -0,0 +1,26 @@
+# registration, GPRS attach and activation on the simulated modem
+import cellular, time, _sim
+
+_sim.network(delay=10, fail=0, mute=0)
+time.sleep_ms(50)
+print(cellular.is_network_registered())
+print(cellular.get_signal_quality())
+
+print(cellular.gprs("internet", "", ""))
+print(cellular.gprs())
+print(cellular.gprs(False))
+
+# the activation is rejected
+_sim.network(fail=_sim.NET_ACTIVATE)
+try:
+    cellular.gprs("internet", "", "", 1000)
+except Exception as e:
+    print(type(e).__name__)
+print(cellular.gprs())
+_sim.network(fail=0)
+
+# the network drops the context
+print(cellular.gprs("internet", "", ""))
+_sim.network_lost()
+time.sleep_ms(20)
+print(cellular.gprs())
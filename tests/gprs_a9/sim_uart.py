@@ -0,0 +1,14 @@
+# UART(1) against the simulated wire
+import machine, time, _sim
+
+u = machine.UART(1, 115200, timeout=50)
+_sim.uart_tx(1)
+u.write(b"hello")
+print(_sim.uart_tx(1))
+
+_sim.uart_rx(1, b"abc\r\n")
+time.sleep_ms(10)
+print(u.any())
+print(u.read())
+print(u.read())
+u.close()
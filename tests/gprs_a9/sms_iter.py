@@ -0,0 +1,55 @@
+# SMS listing: more records than fit the ring reach a slow consumer, and
+# callbacks are not held back meanwhile
+import cellular
+import time
+import _sim
+import uerrno
+
+_sim.network(delay=10, fail=0, mute=0)
+time.sleep_ms(50)
+_sim.sms_clear()
+for i in range(20):
+    _sim.sms_store(i + 1, cellular.SMS_STATUS_READ, "+1234", "message %d" % i, None)
+
+print(len([sms for sms in cellular.SMS.list() if sms]))
+
+log = []
+cellular.on_sms(lambda sms: log.append(sms.message))
+
+taken = []
+for sms in cellular.SMS.iter():
+    if len(taken) == 2:
+        _sim.event(_sim.EVENT_SMS_RECEIVED, 0, 3, '"+1234",,"20/05/01,12:00:00+00"', "new")
+    time.sleep_ms(30)
+    taken.append(sms.message)
+print(len(taken), taken[0], taken[-1])
+print(log)
+print(cellular.poll_network_exception())
+
+cellular.on_sms(None)
+_sim.sms_clear()
+
+# A filtered listing ends once the matching messages are listed, not after
+# a pause, and holds the listing meanwhile
+for i in range(3):
+    _sim.sms_store(i + 1, cellular.SMS_STATUS_UNREAD, "+1234", "unread %d" % i, None)
+for i in range(2):
+    _sim.sms_store(i + 4, cellular.SMS_STATUS_READ, "+1234", "read %d" % i, None)
+start = time.ticks_ms()
+it = cellular.SMS.iter(cellular.SMS_STATUS_UNREAD)
+try:
+    cellular.SMS.list()
+except cellular.CellularError as e:
+    print("busy", e.errno == uerrno.EALREADY)
+try:
+    cellular.SMS.iter()
+except cellular.CellularError as e:
+    print("busy", e.errno == uerrno.EALREADY)
+print(sorted(sms.message for sms in it))
+print(time.ticks_diff(time.ticks_ms(), start) < 1000)
+print(sorted(sms.message for sms in cellular.SMS.iter(cellular.SMS_STATUS_READ)))
+print(len(cellular.SMS.list()))
+
+# Nothing matches: the iterator ends at once
+print(list(cellular.SMS.iter(cellular.SMS_STATUS_UNSENT)))
+_sim.sms_clear()
@@ -0,0 +1,89 @@
+# PDU mode: binary messages are encoded and incoming PDUs decoded as in
+# 3GPP TS 23.040; the vectors below are worked out by hand
+import cellular
+import time
+import _sim
+
+_sim.network(delay=10, fail=0, mute=0)
+time.sleep_ms(50)
+_sim.sms_sent()
+
+# SMS-SUBMIT, 8-bit data
+cellular.SMS("+31641600986", b"\x01\x02\xff").send()
+print(_sim.sms_sent())
+cellular.SMS("0123", b"").send()
+print(_sim.sms_sent())
+
+# Concatenated: 134 + 16 bytes, the reference is masked
+cellular.SMS("+31641600986", bytes(range(150))).send()
+sent = _sim.sms_sent()
+print(len(sent))
+refs = set()
+for number, pdu, is_pdu in sent:
+    refs.add(pdu[36:38])
+    print(number, is_pdu, pdu[:36] + b"RR" + pdu[38:42], len(pdu) // 2)
+print(len(refs), sent[0][1][42:] + sent[1][1][42:] == bytes(range(150)).hex().upper().encode())
+
+try:
+    cellular.SMS("+1 234", b"x").send()
+except ValueError as e:
+    print(e)
+
+# SMS-DELIVER
+received = []
+cellular.on_sms(lambda sms: received.append(sms))
+cellular.sms_pdu_mode(True)
+
+
+def deliver(pdu):
+    _sim.event(_sim.EVENT_SMS_RECEIVED, 0, len(pdu), None, pdu)
+    time.sleep_ms(50)
+    while received:
+        sms = received.pop(0)
+        print(repr(sms.phone_number), hex(sms.pn_type), repr(sms.message))
+
+
+# 7-bit, subscriber number
+deliver("07917283010010F5040BC87238880900F10000993092516195800AE8329BFD4697D9EC37")
+# 7-bit, alphanumeric sender, escaped characters
+deliver("00000BD0C7F7FBCC2E0300000210503100000006" + "1BCA06B52903")
+# UCS-2
+deliver("00000B911346610089F600080210503100000006" + "041F04380440")
+# 8-bit
+deliver("00000B911346610089F600040210503100000003" + "00FF7F")
+# 8-bit concatenated, parts out of order
+deliver("00400B911346610089F600040210503100000009" + "0500032A0202" + "646566")
+deliver("00400B911346610089F600040210503100000009" + "0500032A0201" + "616263")
+# 7-bit concatenated: the header is padded to a septet boundary
+deliver("00400B911346610089F600000210503100000009" + "050003070201" + "D069")
+deliver("00400B911346610089F600000210503100000008" + "050003070202" + "42")
+
+
+def dropped(pdu):
+    deliver(pdu)
+    try:
+        cellular.poll_network_exception()
+    except cellular.CellularError as e:
+        print("CellularError", e.errno == cellular.ESMSDROP)
+
+
+# Malformed: dropped with an exception
+dropped("00000B911346610089F600040210503100000010" + "00")
+dropped("00010B911346610089F600040210503100000001" + "00")
+dropped("0011")
+dropped("")
+# Concatenated with too many parts or out of range part numbers
+dropped("00400B911346610089F600040210503100000007" + "0500032B0901" + "61")
+dropped("00400B911346610089F600040210503100000007" + "0500032C0200" + "61")
+dropped("00400B911346610089F600040210503100000007" + "0500032D0203" + "61")
+
+# Listing
+_sim.sms_clear()
+_sim.sms_store(1, cellular.SMS_STATUS_READ, "+27838890001", "hellohello", "07917283010010F5040BC87238880900F10000993092516195800AE8329BFD4697D9EC37")
+_sim.sms_store(2, cellular.SMS_STATUS_READ, "+31641600986", "", "00400B911346610089F600040210503100000009" + "0500032A0201" + "616263")
+for sms in cellular.SMS.list():
+    print(sms.index, repr(sms.phone_number), repr(sms.message))
+
+cellular.sms_pdu_mode(False)
+cellular.on_sms(None)
+_sim.sms_clear()
@@ -0,0 +1,68 @@
+# Server sockets: accept blocking, non-blocking, through poll and uasyncio
+import usocket
+import uselect
+import uerrno
+import uasyncio
+
+PORT = 47330
+addr = usocket.getaddrinfo("127.0.0.1", PORT)[0][-1]
+
+server = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+server.setsockopt(usocket.SOL_SOCKET, usocket.SO_REUSEADDR, 1)
+server.bind(addr)
+server.listen(2)
+
+# Blocking
+client = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+client.connect(addr)
+conn, peer = server.accept()
+print(peer[0], peer[1] != PORT)
+client.send(b"hello")
+print(conn.recv(5))
+conn.close()
+client.close()
+
+# Non-blocking, nothing pending
+server.setblocking(False)
+try:
+    server.accept()
+except OSError as e:
+    print(e.errno == uerrno.EAGAIN)
+
+# Readable once a connection is pending
+poller = uselect.poll()
+poller.register(server, uselect.POLLIN)
+print(poller.poll(0))
+client = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+client.connect(addr)
+events = poller.poll(1000)
+print(len(events), events[0][1] & uselect.POLLIN != 0)
+conn, _ = server.accept()
+conn.close()
+client.close()
+poller.unregister(server)
+server.close()
+
+
+# uasyncio
+async def handle(reader, writer):
+    line = await reader.readline()
+    writer.write(line.upper())
+    await writer.drain()
+    writer.close()
+    await writer.wait_closed()
+
+
+async def main():
+    srv = await uasyncio.start_server(handle, "127.0.0.1", PORT + 1)
+    reader, writer = await uasyncio.open_connection("127.0.0.1", PORT + 1)
+    writer.write(b"ping\n")
+    await writer.drain()
+    print(await reader.readline())
+    writer.close()
+    await writer.wait_closed()
+    srv.close()
+    await srv.wait_closed()
+
+
+uasyncio.run(main())
@@ -0,0 +1,52 @@
+# Non-blocking connect: EINPROGRESS, then writable once established
+import usocket
+import uselect
+import uerrno
+
+PORT = 47320
+addr = usocket.getaddrinfo("127.0.0.1", PORT)[0][-1]
+
+server = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+server.setsockopt(usocket.SOL_SOCKET, usocket.SO_REUSEADDR, 1)
+server.bind(addr)
+server.listen(1)
+
+client = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+client.setblocking(False)
+try:
+    client.connect(addr)
+    print("connected")
+except OSError as e:
+    print(e.errno == uerrno.EINPROGRESS)
+
+poller = uselect.poll()
+poller.register(client, uselect.POLLOUT)
+events = poller.poll(1000)
+print(len(events), events[0][1] & uselect.POLLOUT != 0, events[0][1] & uselect.POLLERR)
+client.connect(addr)
+print("connected")
+
+client.setblocking(True)
+conn, _ = server.accept()
+client.send(b"ping")
+print(conn.recv(4))
+conn.close()
+client.close()
+server.close()
+
+# Nobody listens: the failure shows up as POLLERR
+client = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+client.setblocking(False)
+try:
+    client.connect(usocket.getaddrinfo("127.0.0.1", PORT + 1)[0][-1])
+except OSError as e:
+    print(e.errno in (uerrno.EINPROGRESS, uerrno.ECONNREFUSED))
+poller = uselect.poll()
+poller.register(client, uselect.POLLOUT)
+events = poller.poll(1000)
+print(len(events), events[0][1] & uselect.POLLERR != 0)
+try:
+    client.connect(usocket.getaddrinfo("127.0.0.1", PORT + 1)[0][-1])
+except OSError as e:
+    print(e.errno == uerrno.ECONNREFUSED)
+client.close()
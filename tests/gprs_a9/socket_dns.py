@@ -0,0 +1,63 @@
+# DNS cache: repeated lookups are answered from the cache until the records
+# expire or GPRS goes down; literal addresses never reach DNS
+import usocket
+import time
+import _sim
+
+_sim.network(delay=10, fail=0, mute=0)
+usocket.dns_cache_flush()
+base_hits, base_misses, records = usocket.dns_cache_stats()
+print(records)
+
+
+def stats():
+    hits, misses, records = usocket.dns_cache_stats()
+    return hits - base_hits, misses - base_misses, records
+
+
+# hit after a miss, same address
+a = usocket.getaddrinfo("localhost", 80)[0][-1]
+b = usocket.getaddrinfo("localhost", 8080)[0][-1]
+print(a == usocket.getaddrinfo("127.0.0.1", 80)[0][-1], a != b)
+print(stats())
+
+# literals bypass the cache
+usocket.getaddrinfo("127.0.0.1", 80)
+usocket.getaddrinfo("", 80)
+print(stats())
+
+# expiry
+print(usocket.dns_cache_ttl())
+usocket.dns_cache_ttl(100)
+usocket.dns_cache_flush()
+usocket.getaddrinfo("localhost", 80)
+usocket.getaddrinfo("localhost", 80)
+time.sleep_ms(150)
+print(stats())
+usocket.getaddrinfo("localhost", 80)
+print(stats())
+
+# disabled
+usocket.dns_cache_ttl(0)
+usocket.getaddrinfo("localhost", 80)
+usocket.getaddrinfo("localhost", 80)
+print(stats())
+usocket.dns_cache_ttl(300000)
+
+# flushed on PDP deactivation
+usocket.getaddrinfo("localhost", 80)
+print(stats())
+_sim.event(_sim.EVENT_DEACTIVATED)
+time.sleep_ms(50)
+print(stats())
+usocket.getaddrinfo("localhost", 80)
+print(stats())
+
+# failures are not cached
+for i in range(2):
+    try:
+        usocket.getaddrinfo("nonexistent.invalid", 80)
+    except OSError as e:
+        print("OSError")
+print(stats())
+usocket.dns_cache_flush()
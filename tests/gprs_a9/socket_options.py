@@ -0,0 +1,35 @@
+# socket options: supported ones read back what was set, others raise
+import usocket
+import uerrno
+
+s = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+for level, opt, value in (
+    (usocket.SOL_SOCKET, usocket.SO_REUSEADDR, 1),
+    (usocket.SOL_SOCKET, usocket.SO_KEEPALIVE, 1),
+    (usocket.IPPROTO_TCP, usocket.TCP_NODELAY, 1),
+    (usocket.IPPROTO_TCP, usocket.TCP_KEEPIDLE, 30),
+    (usocket.IPPROTO_TCP, usocket.TCP_KEEPINTVL, 5),
+    (usocket.IPPROTO_TCP, usocket.TCP_KEEPCNT, 3),
+):
+    s.setsockopt(level, opt, 0 if value == 1 else 1)
+    before = s.getsockopt(level, opt)
+    s.setsockopt(level, opt, value)
+    print(opt, before != value, s.getsockopt(level, opt) == value)
+
+# buffer sizes may be rounded up by the stack
+s.setsockopt(usocket.SOL_SOCKET, usocket.SO_RCVBUF, 4096)
+print(s.getsockopt(usocket.SOL_SOCKET, usocket.SO_RCVBUF) >= 4096)
+s.setsockopt(usocket.SOL_SOCKET, usocket.SO_SNDBUF, 4096)
+print(s.getsockopt(usocket.SOL_SOCKET, usocket.SO_SNDBUF) >= 4096)
+
+# unsupported options and levels
+for level, opt in ((usocket.SOL_SOCKET, 0x7FFF), (usocket.IPPROTO_UDP, usocket.TCP_NODELAY)):
+    try:
+        s.setsockopt(level, opt, 1)
+    except OSError as e:
+        print("setsockopt", uerrno.errorcode[e.errno])
+    try:
+        s.getsockopt(level, opt)
+    except OSError as e:
+        print("getsockopt", uerrno.errorcode[e.errno])
+s.close()
@@ -0,0 +1,62 @@
+# recv_into and recvfrom_into fill a caller's buffer, also without the heap
+import usocket
+import micropython
+
+PORT = 47310
+addr = usocket.getaddrinfo("127.0.0.1", PORT)[0][-1]
+
+# TCP
+server = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+server.setsockopt(usocket.SOL_SOCKET, usocket.SO_REUSEADDR, 1)
+server.bind(addr)
+server.listen(1)
+client = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+client.connect(addr)
+conn, _ = server.accept()
+
+buf = bytearray(8)
+client.send(b"0123456789")
+print(conn.recv_into(buf), buf)
+mv = memoryview(buf)
+print(conn.recv_into(mv[4:], 1), buf)
+print(conn.recv_into(mv[4:]), buf)
+
+
+def locked(sock, buf):
+    micropython.heap_lock()
+    n = sock.recv_into(buf)
+    micropython.heap_unlock()
+    return n
+
+
+client.send(b"abcdef")
+print(locked(conn, buf), buf)
+
+try:
+    conn.recv_into(buf, 9)
+except ValueError:
+    print("ValueError")
+try:
+    conn.recv_into(b"immutable")
+except TypeError:
+    print("TypeError")
+
+client.close()
+print(conn.recv_into(buf))
+conn.close()
+server.close()
+
+# UDP
+a = usocket.socket(usocket.AF_INET, usocket.SOCK_DGRAM)
+a.bind(addr)
+b = usocket.socket(usocket.AF_INET, usocket.SOCK_DGRAM)
+b.bind(usocket.getaddrinfo("127.0.0.1", PORT + 1)[0][-1])
+b.sendto(b"datagram", addr)
+buf = bytearray(16)
+n, sender = a.recvfrom_into(buf)
+print(n, bytes(buf[:n]), sender == usocket.getaddrinfo("127.0.0.1", PORT + 1)[0][-1])
+# a datagram longer than the buffer is cut
+b.sendto(b"0123456789", addr)
+print(a.recvfrom_into(buf, 4)[0], buf[:4])
+a.close()
+b.close()
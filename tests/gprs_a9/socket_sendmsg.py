@@ -0,0 +1,45 @@
+# sendmsg sends a header and a payload in one call without joining them
+import usocket
+
+PORT = 47340
+addr = usocket.getaddrinfo("127.0.0.1", PORT)[0][-1]
+
+server = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+server.setsockopt(usocket.SOL_SOCKET, usocket.SO_REUSEADDR, 1)
+server.bind(addr)
+server.listen(1)
+client = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+client.connect(addr)
+conn, _ = server.accept()
+
+header = b"\x00\x05"
+payload = bytearray(b"hello")
+print(client.sendmsg([header, memoryview(payload)]))
+print(client.sendmsg((b"", b"!", b"")))
+print(client.sendmsg([]))
+
+
+def recv_exactly(sock, n):
+    buf = b""
+    while len(buf) < n:
+        buf += sock.recv(n - len(buf))
+    return buf
+
+
+print(recv_exactly(conn, 8))
+
+# At most 8 buffers
+print(client.sendmsg([b"a"] * 8))
+print(recv_exactly(conn, 8))
+try:
+    client.sendmsg([b"a"] * 9)
+except ValueError:
+    print("ValueError")
+try:
+    client.sendmsg([b"a", 1])
+except TypeError:
+    print("TypeError")
+
+conn.close()
+client.close()
+server.close()
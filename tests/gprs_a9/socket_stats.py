@@ -0,0 +1,55 @@
+# Traffic counters of a socket and of the whole module
+import usocket
+
+PORT = 47350
+addr = usocket.getaddrinfo("127.0.0.1", PORT)[0][-1]
+
+usocket.stats(True)
+opened = usocket.stats()[6]
+
+server = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+server.setsockopt(usocket.SOL_SOCKET, usocket.SO_REUSEADDR, 1)
+server.bind(addr)
+server.listen(1)
+client = usocket.socket(usocket.AF_INET, usocket.SOCK_STREAM)
+client.connect(addr)
+conn, _ = server.accept()
+print(usocket.stats()[6] - opened)
+usocket.stats(True)
+
+# Bytes and packets
+client.send(b"0123456789")
+client.send(b"abc")
+buf = b""
+while len(buf) < 13:
+    buf += conn.recv(13 - len(buf))
+print(client.stats()[:4])
+sent, received, packets_sent, packets_received, retries, timeouts = conn.stats()
+print(sent, received, packets_sent, packets_received >= 1, timeouts)
+
+# A recv that times out waits (retries) and counts a timeout
+conn.settimeout(0.05)
+try:
+    conn.recv(1)
+except OSError as e:
+    print("OSError")
+stats = conn.stats()
+print(stats[4] >= 1, stats[5])
+
+# Module totals cover all sockets and reset on request
+total = usocket.stats(True)
+print(total[0], total[1], total[2], total[4] >= 1, total[5])
+print(usocket.stats()[:6])
+
+# A non-blocking read that would block is neither a retry nor a timeout
+conn.setblocking(False)
+try:
+    conn.recv(1)
+except OSError:
+    print("OSError")
+print(conn.stats()[4:] == stats[4:])
+
+conn.close()
+client.close()
+server.close()
+print(usocket.stats()[6] - opened)
@@ -0,0 +1,16 @@
+# socket timeouts are waited for in full, including ones under the poll period
+import usocket, utime, uerrno
+
+s = usocket.socket(usocket.AF_INET, usocket.SOCK_DGRAM)
+s.bind(usocket.getaddrinfo("127.0.0.1", 0)[0][-1])
+
+for timeout in (0, 0.02, 0.05, 0.25):
+    s.settimeout(timeout)
+    t = utime.ticks_ms()
+    try:
+        s.recv(10)
+    except OSError as e:
+        dt = utime.ticks_diff(utime.ticks_ms(), t)
+        print(timeout, uerrno.errorcode[e.errno], timeout * 1000 <= dt < timeout * 1000 + 50)
+
+s.close()
@@ -0,0 +1,35 @@
+# framed reads return one whole frame at a time
+import machine, time, uerrno, _sim
+
+u = machine.UART(1, 115200, timeout=50)
+u.framing(machine.UART.FRAME_DELIMITER, delimiter=ord("\n"))
+
+_sim.uart_rx(1, b"one\ntwo\nthree\n")
+time.sleep_ms(10)
+print(u.any())
+# frames are not joined to fill the size asked for
+print(u.read(100))
+buf = bytearray(100)
+print(u.readinto(buf), buf[:3])
+# nor cut: a frame that does not fit stays queued
+try:
+    u.read(2)
+except OSError as e:
+    print(uerrno.errorcode[e.errno])
+try:
+    u.readframe(bytearray(4))
+except OSError as e:
+    print(uerrno.errorcode[e.errno])
+print(u.any(), u.readframe())
+print(u.read(), u.readframe())
+
+_sim.uart_rx(1, b"four\nfive\n")
+time.sleep_ms(10)
+print(u.read(-1), u.readinto(buf, 4), buf[:4])
+print(u.read(1))
+
+u.framing(machine.UART.FRAME_NONE)
+_sim.uart_rx(1, b"raw\nbytes\n")
+time.sleep_ms(10)
+print(u.read(100))
+u.close()
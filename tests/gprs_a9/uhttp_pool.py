@@ -0,0 +1,60 @@
+# uhttp against a scripted local server: chunked bodies, pooled connections
+# closed by the server and requests that are not safe to repeat
+import uerrno
+import uhttp
+import _sim
+
+PORT = 47360
+URL = "http://127.0.0.1:%d" % PORT
+
+_sim.http_serve(
+    PORT,
+    [
+        b"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+        + b"5\r\nhello\r\n6;name=value\r\n world\r\n0\r\nTrailer: x\r\n\r\n",
+        # answers, then closes the connection while it idles in the pool
+        (b"HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok", True),
+        b"HTTP/1.1 201 Created\r\nContent-Length: 3\r\n\r\nnew",
+        # drops the pooled connection when the request arrives
+        None,
+        b"HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nagain",
+        None,
+    ],
+)
+uhttp.close()
+base = uhttp.stats()
+
+
+def stats():
+    return tuple(a - b for a, b in zip(uhttp.stats()[:3], base[:3])) + uhttp.stats()[3:]
+
+
+def get(path):
+    status, headers, body = uhttp.request("GET", URL + path)
+    return status, body, stats()
+
+
+status, headers, body = uhttp.request("GET", URL + "/chunked")
+print(status, headers, body)
+print(get("/close"))
+# the closed connection is evicted from the pool before use
+print(get("/evicted"))
+# a GET is repeated on a new connection
+print(get("/dropped"))
+# a POST may have been processed: it is not repeated
+try:
+    uhttp.request("POST", URL + "/post", data=b"x=1")
+except OSError as e:
+    print("OSError", e.errno == uerrno.ECONNRESET)
+print(stats())
+
+# Line breaks would inject headers
+for headers in ({"X-A": "1\r\nX-B: 2"}, {"X-A\n": "1"}, {"X-A": b"1\r"}):
+    try:
+        uhttp.request("GET", URL + "/injected", headers=headers)
+    except ValueError as e:
+        print("ValueError")
+
+for request in _sim.http_requests():
+    print(request.split(b"\r\n")[0], request.endswith(b"x=1"))
+uhttp.close()
@@ -592,6 +592,19 @@ def run_tests(pyb, tests, args, result_dir, num_threads=1):
             )  # RA fsp rtc function doesn't support nano sec info
         elif args.target == "qemu-arm":
             skip_tests.add("misc/print_exception.py")  # requires sys stdfiles
+        elif args.target == "gprs_a9":
+            # MICROPY_NO_ALLOCA: calls allocate frames on the heap
+            skip_tests.update(
+                {
+                    "micropython/extreme_exc.py",
+                    "micropython/heapalloc.py",
+                    "micropython/heapalloc_inst_call.py",
+                    "micropython/heapalloc_super.py",
+                    "micropython/heapalloc_yield_from.py",
+                    "extmod/uasyncio_heaplock.py",
+                    "extmod/vfs_fat_finaliser.py",
+                }
+            )
 
     # Some tests are known to fail on 64-bit machines
     if pyb is None and platform.architecture()[0] == "64bit":
@@ -921,6 +934,7 @@ the last matching regex is used:
         "nrf",
         "renesas-ra",
         "rp2",
+        "gprs_a9",
     )
     if args.list_tests:
         pyb = None
@@ -973,6 +987,9 @@ the last matching regex is used:
             elif args.target == "wipy":
                 # run WiPy tests
                 test_dirs += ("wipy",)
+            elif args.target == "gprs_a9":
+                # run the port tests on the host simulation (ports/gprs_a9/sim)
+                test_dirs += ("float", "gprs_a9")
             elif args.target == "unix":
                 # run PC tests
                 test_dirs += (